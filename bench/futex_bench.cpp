@@ -0,0 +1,213 @@
+/*
+ * Copyright 2018-2020 Justas Masiulis
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* Compares jm::futex_mutex against std::mutex under contention.
+ *
+ * Every thread takes the mutex, spins for --work iterations, increments a shared counter
+ * and unlocks it, --iterations times. The threads are pinned to separate cpus and start
+ * at the same time. The result is the aggregate number of critical sections per second
+ * for 1..N threads, the best of --runs runs. The counter is checked after every run.
+ *
+ * Build:
+ *   g++ -std=c++17 -O2 -pthread -I../include futex_bench.cpp -o futex_bench
+ *
+ * Usage:
+ *   futex_bench [--iterations N] [--threads N] [--work N] [--runs N]
+ */
+
+#include "futex.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <mutex>
+#include <pthread.h>
+#include <sched.h>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    volatile unsigned sink;
+
+    std::uint64_t now_ns() noexcept
+    {
+        timespec time;
+        ::clock_gettime(CLOCK_MONOTONIC, &time);
+        return static_cast<std::uint64_t>(time.tv_sec) * 1000000000ull +
+               static_cast<std::uint64_t>(time.tv_nsec);
+    }
+
+    void pin_to_cpu(int cpu) noexcept
+    {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        ::pthread_setaffinity_np(::pthread_self(), sizeof(set), &set);
+    }
+
+    std::vector<int> available_cpus()
+    {
+        std::vector<int> cpus;
+        cpu_set_t        set;
+        if(::sched_getaffinity(0, sizeof(set), &set) == 0)
+            for(int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+                if(CPU_ISSET(cpu, &set))
+                    cpus.push_back(cpu);
+        return cpus;
+    }
+
+    // returns millions of critical sections per second across all threads or a negative
+    // value if the counter doesn't add up.
+    template<class Mutex>
+    double run(std::size_t             threads,
+               std::size_t             iterations,
+               unsigned                work,
+               const std::vector<int>& cpus)
+    {
+        Mutex                    mutex;
+        std::size_t              counter = 0;
+        std::atomic<std::size_t> ready{ 0 };
+        std::atomic<bool>        go{ false };
+        std::vector<std::thread> workers;
+
+        for(std::size_t t = 0; t < threads; ++t)
+            workers.emplace_back([&, t] {
+                pin_to_cpu(cpus[t % cpus.size()]);
+                ready.fetch_add(1);
+                while(!go.load(std::memory_order_acquire))
+                    ;
+
+                for(std::size_t i = 0; i < iterations; ++i) {
+                    std::lock_guard<Mutex> lock(mutex);
+                    for(unsigned w = 0; w < work; ++w)
+                        sink = w;
+                    ++counter;
+                }
+            });
+
+        while(ready.load() != threads)
+            ;
+        const auto start = now_ns();
+        go.store(true, std::memory_order_release);
+        for(auto& worker : workers)
+            worker.join();
+        const auto elapsed = now_ns() - start;
+
+        if(counter != threads * iterations)
+            return -1;
+
+        return static_cast<double>(counter) * 1000.0 / static_cast<double>(elapsed);
+    }
+
+    template<class Mutex>
+    double best_of(std::size_t             runs,
+                   std::size_t             threads,
+                   std::size_t             iterations,
+                   unsigned                work,
+                   const std::vector<int>& cpus)
+    {
+        double best = 0;
+        for(std::size_t r = 0; r < runs; ++r) {
+            const auto result = run<Mutex>(threads, iterations, work, cpus);
+            if(result < 0)
+                return result;
+            best = std::max(best, result);
+        }
+        return best;
+    }
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    std::size_t iterations = 1000000;
+    std::size_t threads    = 0;
+    std::size_t runs       = 3;
+    unsigned    work       = 0;
+
+    for(int i = 1; i < argc; ++i) {
+        if(!std::strcmp(argv[i], "--iterations") && i + 1 < argc)
+            iterations = std::strtoull(argv[++i], nullptr, 10);
+        else if(!std::strcmp(argv[i], "--threads") && i + 1 < argc)
+            threads = std::strtoull(argv[++i], nullptr, 10);
+        else if(!std::strcmp(argv[i], "--work") && i + 1 < argc)
+            work = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+        else if(!std::strcmp(argv[i], "--runs") && i + 1 < argc)
+            runs = std::strtoull(argv[++i], nullptr, 10);
+        else {
+            std::fprintf(stderr,
+                         "usage: %s [--iterations N] [--threads N] [--work N] [--runs N]\n",
+                         argv[0]);
+            return 1;
+        }
+    }
+
+    if(iterations == 0)
+        iterations = 1;
+    if(runs == 0)
+        runs = 1;
+
+    const auto cpus = available_cpus();
+    if(cpus.empty()) {
+        std::fprintf(stderr, "sched_getaffinity failed\n");
+        return 1;
+    }
+
+    if(threads == 0)
+        threads = cpus.size();
+
+    std::vector<std::size_t> counts;
+    for(std::size_t t = 1; t <= threads; t *= 2)
+        counts.push_back(t);
+    if(counts.back() != threads)
+        counts.push_back(threads);
+
+    std::printf("million critical sections per second, %zu iterations per thread, "
+                "work %u, %zu cpus\n\n",
+                iterations,
+                work,
+                cpus.size());
+    std::printf("%-18s", "threads");
+    for(const auto count : counts)
+        std::printf(" %8zu", count);
+    std::putchar('\n');
+
+    const auto row = [&](const char* name, auto measure) {
+        std::printf("%-18s", name);
+        for(const auto count : counts) {
+            const auto result = measure(count);
+            if(result < 0) {
+                std::printf("\n%s lost updates with %zu threads\n", name, count);
+                return false;
+            }
+            std::printf(" %8.2f", result);
+            std::fflush(stdout);
+        }
+        std::putchar('\n');
+        return true;
+    };
+
+    const auto std_mutex = [&](std::size_t count) {
+        return best_of<std::mutex>(runs, count, iterations, work, cpus);
+    };
+    const auto futex_mutex = [&](std::size_t count) {
+        return best_of<jm::futex_mutex>(runs, count, iterations, work, cpus);
+    };
+    return row("std::mutex", std_mutex) && row("jm::futex_mutex", futex_mutex) ? 0 : 1;
+}
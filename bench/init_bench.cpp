@@ -0,0 +1,394 @@
+/*
+ * Copyright 2018-2020 Justas Masiulis
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* Measures how the initialization scales with the number of syscall exports of ntdll
+ * and the number of syscall entries of the binary.
+ *
+ * Every image is a synthetic PE32+ image generated in memory with N syscalls that are
+ * exported under both Nt* and Zw* names, like ntdll does, and whose stubs start with
+ * mov r10, rcx; mov eax, id. It has a single section that starts at the same offset
+ * in the file and in memory, so it can be parsed with either layout.
+ *
+ * For every N and M the resolver is run over a table of M syscall entries laid out
+ * like the _sysc section, whose syscalls are spread evenly over the Zw* exports and
+ * ordered randomly, as the order of the entries depends on template instantiation.
+ * The result is the lowest number of cycles out of all iterations divided by N.
+ * --sorted measures the resolver of sorted_init.hpp instead, and --hooked makes every
+ * fourth stub start with a jmp like inline hooks do, which only that one tolerates.
+ *
+ * The binary itself has JM_INIT_BENCH_HOLDERS syscall entries for the syscalls
+ * 8, 24, 40, ... which are resolved with init_syscalls_list as the "binary" row.
+ * Compilers that don't place the entries into _sysc (GCC ignores section attributes
+ * of template members) skip that row.
+ *
+ * Build:
+ *   g++ -std=c++17 -O2 -I../include init_bench.cpp -o init_bench
+ *   clang++ -std=c++17 -O2 -I../include -DJM_INIT_BENCH_HOLDERS=1024 init_bench.cpp \
+ *       -o init_bench
+ *
+ * Usage:
+ *   init_bench [--iterations N] [--exports N,N,...] [--entries M,M,...] [--file]
+ *              [--sorted] [--hooked]
+ */
+
+// the syscalls of the synthetic images aren't named like linux syscalls
+#define JM_INLINE_SYSCALL_UNKNOWN_NAMES
+
+#include "sorted_init.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <utility>
+#include <vector>
+#include <x86intrin.h>
+
+#ifndef JM_INIT_BENCH_HOLDERS
+#define JM_INIT_BENCH_HOLDERS 256
+#endif
+
+namespace {
+
+    using entry_type = std::remove_reference_t<decltype(*jm::syscall_entries())>;
+
+    static_assert(!std::is_same_v<entry_type, jm::syscall_entry_split>,
+                  "split syscall entries can't be resolved outside of syscall_entries()");
+
+    // the distance between the syscalls of the entries of the binary
+    constexpr std::uint32_t holder_stride = 16;
+
+    // writes the name of the synthetic syscall with the given index without the Nt / Zw
+    // prefix. Zero padded so that the names sort in the order of the indices.
+    constexpr void synthetic_name(std::uint32_t index, char (&name)[13]) noexcept
+    {
+        constexpr char prefix[] = "Syscall";
+        for(std::size_t i = 0; i < 7; ++i)
+            name[i] = prefix[i];
+
+        for(std::size_t i = 12; i-- > 7;) {
+            name[i] = static_cast<char>('0' + index % 10);
+            index /= 10;
+        }
+        name[12] = '\0';
+    }
+
+    constexpr std::uint32_t synthetic_hash(std::uint32_t index) noexcept
+    {
+        char name[13] = {};
+        synthetic_name(index, name);
+        return jm::hash(name);
+    }
+
+    // odr-uses the syscall entries of the binary the same way INLINE_SYSCALL does
+    template<std::size_t... Is>
+    std::size_t instantiate_holders(std::index_sequence<Is...>) noexcept
+    {
+        return (std::size_t{ 0 } + ... +
+                (jm::detail::syscall_id_of<synthetic_hash(Is * holder_stride +
+                                                          holder_stride / 2)>(),
+                 1));
+    }
+
+    template<class T>
+    void write(std::vector<char>& image, std::size_t offset, const T& value) noexcept
+    {
+        std::memcpy(image.data() + offset, &value, sizeof(value));
+    }
+
+    // generates a PE32+ image with the given number of syscalls. The id of every syscall
+    // is its index.
+    std::vector<char> make_image(std::uint32_t syscalls, bool hooked)
+    {
+        namespace d = jm::detail;
+
+        constexpr std::uint32_t headers_size = 0x1000;
+        constexpr std::uint32_t stub_size    = 32;
+        constexpr std::uint32_t name_size    = 16; // Nt + synthetic name + '\0' rounded up
+
+        const std::uint32_t names     = syscalls * 2;
+        const std::uint32_t ied       = headers_size;
+        const std::uint32_t functions = ied + sizeof(d::IMAGE_EXPORT_DIRECTORY);
+        const std::uint32_t name_rvas = functions + syscalls * 4;
+        const std::uint32_t ordinals  = name_rvas + names * 4;
+        const std::uint32_t strings   = (ordinals + names * 2 + 15) & ~15u;
+        const std::uint32_t stubs     = strings + names * name_size;
+        const std::uint32_t end       = (stubs + syscalls * stub_size + 0xFFF) & ~0xFFFu;
+
+        std::vector<char> image(end);
+
+        d::IMAGE_DOS_HEADER dos{};
+        dos.e_magic  = 0x5A4D;
+        dos.e_lfanew = sizeof(dos);
+        write(image, 0, dos);
+
+        d::IMAGE_NT_HEADERS nt{};
+        nt.Signature                          = 0x4550;
+        nt.FileHeader.Machine                 = 0x8664;
+        nt.FileHeader.NumberOfSections        = 1;
+        nt.FileHeader.SizeOfOptionalHeader    = sizeof(nt.OptionalHeader);
+        nt.OptionalHeader.Magic               = 0x20B;
+        nt.OptionalHeader.SectionAlignment    = 0x1000;
+        nt.OptionalHeader.FileAlignment       = 0x1000;
+        nt.OptionalHeader.SizeOfImage         = end;
+        nt.OptionalHeader.SizeOfHeaders       = headers_size;
+        nt.OptionalHeader.NumberOfRvaAndSizes = 16;
+        nt.OptionalHeader.DataDirectory[0]    = { ied, stubs - ied };
+        write(image, sizeof(dos), nt);
+
+        d::IMAGE_SECTION_HEADER text{};
+        std::memcpy(text.Name, ".text", 5);
+        text.VirtualSize      = end - headers_size;
+        text.VirtualAddress   = headers_size;
+        text.SizeOfRawData    = end - headers_size;
+        text.PointerToRawData = headers_size;
+        text.Characteristics  = 0x60000020;
+        write(image, sizeof(dos) + sizeof(nt), text);
+
+        d::IMAGE_EXPORT_DIRECTORY exports{};
+        exports.Base                  = 1;
+        exports.NumberOfFunctions     = syscalls;
+        exports.NumberOfNames         = names;
+        exports.AddressOfFunctions    = functions;
+        exports.AddressOfNames        = name_rvas;
+        exports.AddressOfNameOrdinals = ordinals;
+        write(image, ied, exports);
+
+        for(std::uint32_t i = 0; i < syscalls; ++i) {
+            const std::uint32_t stub = stubs + i * stub_size;
+            write(image, functions + i * 4, stub);
+
+            // mov r10, rcx; mov eax, id; syscall; ret
+            const unsigned char code[] = { 0x4C, 0x8B, 0xD1, 0xB8, 0,    0,
+                                           0,    0,    0x0F, 0x05, 0xC3 };
+            std::memcpy(image.data() + stub, code, sizeof(code));
+            write(image, stub + 4, i);
+
+            // jmp rel32; int3; int3; int3
+            if(hooked && i % 4 == 0) {
+                const unsigned char jmp[] = { 0xE9, 0, 0x10, 0, 0, 0xCC, 0xCC, 0xCC };
+                std::memcpy(image.data() + stub, jmp, sizeof(jmp));
+            }
+        }
+
+        // Nt* names sort before all Zw* ones and the syscalls are in order within both
+        for(std::uint32_t i = 0; i < names; ++i) {
+            const std::uint32_t syscall = i % syscalls;
+            const std::uint32_t string  = strings + i * name_size;
+            write(image, name_rvas + i * 4, string);
+            write(image, ordinals + i * 2, static_cast<std::uint16_t>(syscall));
+
+            char name[13];
+            synthetic_name(syscall, name);
+            std::memcpy(image.data() + string, i < syscalls ? "Nt" : "Zw", 2);
+            std::memcpy(image.data() + string + 2, name, sizeof(name));
+        }
+
+        return image;
+    }
+
+    // generates M entries whose syscalls are spread evenly over the image and stores the
+    // ids they should be resolved to. Needs M <= N.
+    std::vector<entry_type> make_entries(std::uint32_t               syscalls,
+                                         std::uint32_t               count,
+                                         std::vector<std::uint32_t>& ids)
+    {
+        ids.clear();
+        for(std::uint32_t i = 0; i < count; ++i)
+            ids.push_back(
+                static_cast<std::uint32_t>((2ull * i + 1) * syscalls / (2ull * count)));
+        std::shuffle(ids.begin(), ids.end(), std::mt19937(count));
+
+        std::vector<entry_type> entries;
+        for(const auto id : ids)
+            entries.push_back(
+                jm::detail::make_syscall_entry<entry_type>(synthetic_hash(id)));
+
+        return entries;
+    }
+
+    unsigned long long now() noexcept
+    {
+        _mm_lfence();
+        const auto tsc = __rdtsc();
+        _mm_lfence();
+        return tsc;
+    }
+
+    // returns the lowest number of cycles of all iterations of fn. Every iteration
+    // starts with reset.
+    template<class Reset, class Fn>
+    unsigned long long measure(std::size_t iterations, Reset reset, Fn fn)
+    {
+        auto best = ~0ull;
+        for(std::size_t i = 0; i < iterations; ++i) {
+            reset();
+            const auto start = now();
+            fn();
+            best = std::min(best, now() - start);
+        }
+        return best;
+    }
+
+    std::vector<std::uint32_t> parse_list(const char* str)
+    {
+        std::vector<std::uint32_t> values;
+        for(char* end; *str; str = *end ? end + 1 : end) {
+            const auto value = std::strtoul(str, &end, 10);
+            if(end == str || value == 0)
+                return {};
+
+            values.push_back(static_cast<std::uint32_t>(value));
+        }
+        return values;
+    }
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    std::size_t                iterations = 20;
+    std::vector<std::uint32_t> exports{ 256, 512, 1024, 2048, 4096, 8192 };
+    std::vector<std::uint32_t> entries{ 8, 32, 128, 512, 2048 };
+    auto                       layout = jm::image_layout::mapped;
+    bool                       sorted = false;
+    bool                       hooked = false;
+    for(int i = 1; i < argc; ++i) {
+        if(!std::strcmp(argv[i], "--iterations") && i + 1 < argc)
+            iterations = std::strtoull(argv[++i], nullptr, 10);
+        else if(!std::strcmp(argv[i], "--exports") && i + 1 < argc)
+            exports = parse_list(argv[++i]);
+        else if(!std::strcmp(argv[i], "--entries") && i + 1 < argc)
+            entries = parse_list(argv[++i]);
+        else if(!std::strcmp(argv[i], "--file"))
+            layout = jm::image_layout::file;
+        else if(!std::strcmp(argv[i], "--sorted"))
+            sorted = true;
+        else if(!std::strcmp(argv[i], "--hooked"))
+            hooked = true;
+        else {
+            std::fprintf(stderr,
+                         "usage: %s [--iterations N] [--exports N,N,...] "
+                         "[--entries M,M,...] [--file] [--sorted] [--hooked]\n",
+                         argv[0]);
+            return 1;
+        }
+    }
+    if(hooked && !sorted) {
+        std::fprintf(stderr, "--hooked needs --sorted as the default resolver reads stubs\n");
+        return 1;
+    }
+    if(iterations == 0 || exports.empty() || entries.empty() ||
+       *std::max_element(exports.begin(), exports.end()) > 0x8000) {
+        std::fprintf(stderr, "invalid arguments, at most 32768 exports are supported\n");
+        return 1;
+    }
+
+    std::vector<std::vector<char>> images;
+    for(const auto n : exports)
+        images.push_back(make_image(n, hooked));
+
+    std::printf("cycles per syscall export, %s resolver, %s layout, best of %zu runs\n\n",
+                sorted ? "sorted" : "default",
+                layout == jm::image_layout::mapped ? "mapped" : "file",
+                iterations);
+    std::printf("%-16s", "entries");
+    for(const auto n : exports)
+        std::printf(" %9u", n);
+    std::printf("\n");
+
+    for(const auto m : entries) {
+        std::printf("%-16u", m);
+        for(std::size_t i = 0; i < exports.size(); ++i) {
+            const auto n = exports[i];
+            if(m > n) {
+                std::printf(" %9s", "-");
+                continue;
+            }
+
+            std::vector<std::uint32_t> ids;
+            const auto                 pristine = make_entries(n, m, ids);
+            auto                       table    = pristine;
+
+            const jm::detail::exports_directory directory(
+                images[i].data(), images[i].size(), layout);
+            const auto cycles = measure(
+                iterations,
+                [&] { table = pristine; },
+                [&] {
+                    const auto first = table.data();
+                    const auto last  = table.data() + table.size();
+                    if(sorted) {
+                        jm::detail::ignore_unresolved ignore;
+                        jm::detail::resolve_syscall_entries_sorted(
+                            directory, first, last, ignore);
+                    }
+                    else
+                        jm::detail::resolve_syscall_entries(directory, first, last);
+                });
+
+            // every entry has to end up with the id of its syscall
+            for(std::size_t e = 0; e < ids.size(); ++e)
+                if(table[e].id != ids[e]) {
+                    std::fprintf(stderr, "\nsyscall %u was not resolved\n", ids[e]);
+                    return 1;
+                }
+
+            std::printf(" %9.1f", static_cast<double>(cycles) / n);
+        }
+        std::printf("\n");
+    }
+
+    const auto holders =
+        instantiate_holders(std::make_index_sequence<JM_INIT_BENCH_HOLDERS>{});
+    std::size_t binary_entries = 0;
+    for(auto entry = jm::syscall_entries(); entry != jm::syscall_entries_end(); ++entry)
+        if(jm::detail::entry_hash(entry) != 0)
+            ++binary_entries;
+
+    if(binary_entries < holders) {
+        std::printf("\nonly %zu of %zu syscall entries of the binary are in _sysc\n",
+                    binary_entries,
+                    holders);
+        return 0;
+    }
+
+    // small entries lose their hashes once resolved so every iteration starts from a copy
+    const auto              table = jm::syscall_entries();
+    std::vector<entry_type> pristine(jm::syscall_entries_end() - table);
+    const auto              bytes = pristine.size() * sizeof(entry_type);
+    std::memcpy(static_cast<void*>(pristine.data()), table, bytes);
+    const auto restore = [&] {
+        std::memcpy(static_cast<void*>(table), pristine.data(), bytes);
+    };
+
+    std::printf("%-16s", "binary");
+    for(std::size_t i = 0; i < exports.size(); ++i) {
+        const auto cycles = measure(
+            iterations,
+            restore,
+            [&] {
+                if(sorted)
+                    jm::init_syscalls_list_sorted(
+                        images[i].data(), images[i].size(), layout);
+                else
+                    jm::init_syscalls_list(images[i].data(), images[i].size(), layout);
+            });
+        std::printf(" %9.1f", static_cast<double>(cycles) / exports[i]);
+    }
+    std::printf("\n");
+    restore();
+}
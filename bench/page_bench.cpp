@@ -0,0 +1,193 @@
+/*
+ * Copyright 2018-2020 Justas Masiulis
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* Measures what the page policies of page_arena.hpp cost and save.
+ *
+ * Every round allocates --blocks blocks of --block-size bytes, writes every page of them
+ * and frees them again, --rounds times. It is done with malloc / free, with a page_pool
+ * under every huge page and release policy and with a page_arena that is reset every
+ * round. The result is the time per block and the minor page faults per round, which
+ * show how prefaulting, huge pages and the release policy trade time for memory.
+ *
+ * Build:
+ *   g++ -std=c++17 -O2 -I../include page_bench.cpp -o page_bench
+ *
+ * Usage:
+ *   page_bench [--blocks N] [--block-size N] [--rounds N] [--release]
+ *
+ * --release gives the memory back to the kernel after every round.
+ */
+
+#include "page_arena.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <sys/resource.h>
+#include <vector>
+
+namespace {
+
+    struct result {
+        double ns_per_block;
+        double faults_per_round;
+    };
+
+    std::uint64_t now_ns() noexcept
+    {
+        timespec time;
+        ::clock_gettime(CLOCK_MONOTONIC, &time);
+        return static_cast<std::uint64_t>(time.tv_sec) * 1000000000ull +
+               static_cast<std::uint64_t>(time.tv_nsec);
+    }
+
+    long minor_faults() noexcept
+    {
+        rusage usage;
+        ::getrusage(RUSAGE_SELF, &usage);
+        return usage.ru_minflt;
+    }
+
+    void touch(void* block, std::size_t size) noexcept
+    {
+        for(std::size_t offset = 0; offset < size; offset += 4096)
+            static_cast<volatile char*>(block)[offset] = 1;
+    }
+
+    // runs rounds of allocate(), touch and free(block), then end_round()
+    template<class Allocate, class Free, class EndRound>
+    result measure(std::size_t blocks,
+                   std::size_t block_size,
+                   std::size_t rounds,
+                   Allocate    allocate,
+                   Free        free,
+                   EndRound    end_round)
+    {
+        std::vector<void*> pointers(blocks);
+        const auto         faults = minor_faults();
+        const auto         start  = now_ns();
+        for(std::size_t r = 0; r < rounds; ++r) {
+            for(auto& pointer : pointers) {
+                pointer = allocate();
+                if(!pointer)
+                    return { -1, -1 };
+                touch(pointer, block_size);
+            }
+            for(const auto pointer : pointers)
+                free(pointer);
+            end_round();
+        }
+        const auto elapsed = now_ns() - start;
+
+        const auto count = static_cast<double>(rounds);
+        return { static_cast<double>(elapsed) / (count * static_cast<double>(blocks)),
+                 static_cast<double>(minor_faults() - faults) / count };
+    }
+
+    void print(const char* name, result result)
+    {
+        if(result.ns_per_block < 0)
+            std::printf("%-28s %12s\n", name, "failed");
+        else
+            std::printf("%-28s %12.1f %14.1f\n",
+                        name,
+                        result.ns_per_block,
+                        result.faults_per_round);
+    }
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    std::size_t blocks     = 4096;
+    std::size_t block_size = 16384;
+    std::size_t rounds     = 50;
+    bool        release    = false;
+
+    for(int i = 1; i < argc; ++i) {
+        if(!std::strcmp(argv[i], "--blocks") && i + 1 < argc)
+            blocks = std::strtoull(argv[++i], nullptr, 10);
+        else if(!std::strcmp(argv[i], "--block-size") && i + 1 < argc)
+            block_size = std::strtoull(argv[++i], nullptr, 10);
+        else if(!std::strcmp(argv[i], "--rounds") && i + 1 < argc)
+            rounds = std::strtoull(argv[++i], nullptr, 10);
+        else if(!std::strcmp(argv[i], "--release"))
+            release = true;
+        else {
+            std::fprintf(
+                stderr,
+                "usage: %s [--blocks N] [--block-size N] [--rounds N] [--release]\n",
+                argv[0]);
+            return 1;
+        }
+    }
+
+    if(blocks == 0)
+        blocks = 1;
+    if(rounds == 0)
+        rounds = 1;
+
+    std::printf("%zu blocks of %zu bytes, %zu rounds%s\n\n",
+                blocks,
+                block_size,
+                rounds,
+                release ? ", released every round" : "");
+    std::printf("%-28s %12s %14s\n", "", "ns per block", "faults / round");
+
+    const auto malloc_block = [&] { return std::malloc(block_size); };
+    const auto free_block   = [](void* pointer) { std::free(pointer); };
+    print("malloc", measure(blocks, block_size, rounds, malloc_block, free_block, [] {}));
+
+    struct policy {
+        const char*      name;
+        jm::page_options options;
+    };
+    const policy policies[] = {
+        { "page_pool", {} },
+        { "page_pool populate", { jm::huge_pages::none, std::size_t{ 2 } << 20, true } },
+        { "page_pool lazy release",
+          { jm::huge_pages::none, std::size_t{ 2 } << 20, false, true } },
+        { "page_pool thp", { jm::huge_pages::transparent } },
+        { "page_pool hugetlb", { jm::huge_pages::hugetlb } },
+    };
+
+    for(const auto& policy : policies) {
+        jm::page_pool pool(block_size, blocks, policy.options, std::size_t{ 2 } << 20);
+        if(pool.error()) {
+            print(policy.name, { -1, -1 });
+            continue;
+        }
+
+        const auto allocate  = [&] { return pool.allocate(); };
+        const auto free      = [&](void* pointer) { pool.free(pointer); };
+        const auto end_round = [&] {
+            if(release)
+                pool.release();
+        };
+        print(policy.name, measure(blocks, block_size, rounds, allocate, free, end_round));
+    }
+
+    // an arena frees everything at once, so blocks are not freed one by one
+    jm::page_arena arena(blocks * block_size, {}, std::size_t{ 2 } << 20);
+    const auto     allocate  = [&] { return arena.allocate(block_size, 4096); };
+    const auto     end_round = [&] {
+        arena.reset();
+        if(release)
+            arena.release();
+    };
+    const auto     free      = [](void*) {};
+    print("page_arena", measure(blocks, block_size, rounds, allocate, free, end_round));
+}
@@ -0,0 +1,450 @@
+/*
+ * Copyright 2018-2020 Justas Masiulis
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* Measures the cost of a single syscall made through the different call paths:
+ *
+ *   glibc   - the libc wrapper (clock_gettime goes through the vDSO here)
+ *   syscall - syscall(2) from libc
+ *   stub    - a non inlined function that contains INLINE_SYSCALL, like ntdll stubs
+ *   inline  - INLINE_SYSCALL directly at the call site
+ *
+ * INLINE_SYSCALL routes clock_gettime to the vDSO, so its inline and stub paths use a
+ * syscall_function directly and "inline (vdso)" measures the routed call.
+ *
+ * Build:
+ *   g++ -std=c++17 -O2 -pthread -I../include syscall_bench.cpp -o syscall_bench
+ *
+ * On an x86-64 host the arm64 build runs under qemu user mode, which checks that the
+ * arm64 stubs work, but its timings say nothing about real hardware:
+ *   aarch64-linux-gnu-g++ -std=c++17 -O2 -pthread -static -I../include syscall_bench.cpp \
+ *       -o syscall_bench_arm64
+ *   qemu-aarch64 ./syscall_bench_arm64 --iterations 1000
+ *
+ * Usage:
+ *   syscall_bench [--iterations N] [--threads N] [--histogram]
+ *
+ * The latency mode times every call individually with rdtsc / rdtscp and reports
+ * percentiles in cycles (in ticks of the virtual counter on arm64). The scaling mode runs the same loop on 1..N threads that are
+ * pinned to separate cores and reports the aggregate throughput.
+ */
+
+#include "inline_syscall.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/prctl.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+#if defined(__x86_64__)
+#include <x86intrin.h>
+#endif
+
+namespace {
+
+    // prototypes of the syscalls under their kernel names. Kept in their own namespace
+    // so they don't clash with the libc declarations.
+    namespace prototypes {
+
+        using getpid        = long();
+        using gettid        = long();
+        using clock_gettime = long(clockid_t clock, timespec* time);
+        using prctl         = long(int           option,
+                           unsigned long arg2,
+                           unsigned long arg3,
+                           unsigned long arg4,
+                           unsigned long arg5);
+        using sendto        = long(int             fd,
+                            const void*     buffer,
+                            std::size_t     size,
+                            int             flags,
+                            const sockaddr* address,
+                            socklen_t       length);
+
+        inline long inline_getpid() noexcept { return INLINE_SYSCALL_T(getpid)(); }
+        inline long inline_gettid() noexcept { return INLINE_SYSCALL_T(gettid)(); }
+
+        // always enters the kernel, unlike INLINE_SYSCALL which uses the vDSO
+        inline long inline_clock_gettime(timespec* time) noexcept
+        {
+            return jm::syscall_function<clock_gettime>{ SYS_clock_gettime }(CLOCK_MONOTONIC,
+                                                                             time);
+        }
+
+        inline long inline_vdso_clock_gettime(timespec* time) noexcept
+        {
+            return INLINE_SYSCALL_T(clock_gettime)(CLOCK_MONOTONIC, time);
+        }
+
+        inline long inline_prctl() noexcept
+        {
+            return INLINE_SYSCALL_T(prctl)(PR_GET_DUMPABLE, 0, 0, 0, 0);
+        }
+
+        // fails with EBADF right away, which makes it a cheap 6 argument syscall
+        inline long inline_sendto() noexcept
+        {
+            return INLINE_SYSCALL_T(sendto)(-1, nullptr, 0, 0, nullptr, 0);
+        }
+
+    } // namespace prototypes
+
+    [[gnu::noinline]] long stub_getpid() noexcept { return prototypes::inline_getpid(); }
+    [[gnu::noinline]] long stub_gettid() noexcept { return prototypes::inline_gettid(); }
+    [[gnu::noinline]] long stub_clock_gettime() noexcept
+    {
+        timespec time;
+        return prototypes::inline_clock_gettime(&time);
+    }
+    [[gnu::noinline]] long stub_prctl() noexcept { return prototypes::inline_prctl(); }
+    [[gnu::noinline]] long stub_sendto() noexcept { return prototypes::inline_sendto(); }
+
+    // every call path is a separate function that is passed to the measuring loops as a
+    // template argument, so that the inline paths really are inlined into the loops.
+#define JM_CALL(name, ...) \
+    inline long name() noexcept { __VA_ARGS__; }
+
+    JM_CALL(glibc_getpid, return ::getpid())
+    JM_CALL(syscall_getpid, return ::syscall(SYS_getpid))
+    JM_CALL(inline_getpid, return prototypes::inline_getpid())
+
+    JM_CALL(glibc_gettid, return ::gettid())
+    JM_CALL(syscall_gettid, return ::syscall(SYS_gettid))
+    JM_CALL(inline_gettid, return prototypes::inline_gettid())
+
+    JM_CALL(glibc_clock_gettime, timespec t; return ::clock_gettime(CLOCK_MONOTONIC, &t))
+    JM_CALL(syscall_clock_gettime,
+            timespec t;
+            return ::syscall(SYS_clock_gettime, CLOCK_MONOTONIC, &t))
+    JM_CALL(inline_clock_gettime, timespec t; return prototypes::inline_clock_gettime(&t))
+    JM_CALL(inline_vdso_clock_gettime,
+            timespec t;
+            return prototypes::inline_vdso_clock_gettime(&t))
+
+    JM_CALL(glibc_prctl, return ::prctl(PR_GET_DUMPABLE, 0, 0, 0, 0))
+    JM_CALL(syscall_prctl, return ::syscall(SYS_prctl, PR_GET_DUMPABLE, 0, 0, 0, 0))
+    JM_CALL(inline_prctl, return prototypes::inline_prctl())
+
+    JM_CALL(glibc_sendto, return ::sendto(-1, nullptr, 0, 0, nullptr, 0))
+    JM_CALL(syscall_sendto, return ::syscall(SYS_sendto, -1, nullptr, 0, 0, nullptr, 0))
+    JM_CALL(inline_sendto, return prototypes::inline_sendto())
+
+#undef JM_CALL
+
+    volatile long sink;
+
+#if defined(__aarch64__)
+    constexpr const char* timestamp_unit = "ticks";
+
+    // the virtual counter. isb keeps it from being read before the preceding
+    // instructions completed.
+    inline std::uint64_t start_timestamp() noexcept
+    {
+        std::uint64_t result;
+        asm volatile("isb\n"
+                     "mrs %0, cntvct_el0"
+                     : "=r"(result)
+                     :
+                     : "memory");
+        return result;
+    }
+
+    inline std::uint64_t end_timestamp() noexcept { return start_timestamp(); }
+#else
+    constexpr const char* timestamp_unit = "cycles";
+
+    // serializing timestamps as recommended for benchmarking by the intel manual: lfence
+    // keeps rdtsc from executing early, rdtscp waits for the measured code to retire.
+    inline std::uint64_t start_timestamp() noexcept
+    {
+        _mm_lfence();
+        const auto result = __rdtsc();
+        _mm_lfence();
+        return result;
+    }
+
+    inline std::uint64_t end_timestamp() noexcept
+    {
+        unsigned   aux;
+        const auto result = __rdtscp(&aux);
+        _mm_lfence();
+        return result;
+    }
+#endif
+
+    std::uint64_t timestamp_overhead() noexcept
+    {
+        std::uint64_t minimum = ~std::uint64_t{ 0 };
+        for(int i = 0; i < 10000; ++i) {
+            const auto start = start_timestamp();
+            const auto end   = end_timestamp();
+            minimum          = std::min(minimum, end - start);
+        }
+        return minimum;
+    }
+
+    std::uint64_t percentile(const std::vector<std::uint64_t>& sorted, double p) noexcept
+    {
+        return sorted[static_cast<std::size_t>(p * static_cast<double>(sorted.size() - 1))];
+    }
+
+    // prints the samples in power of two buckets
+    void print_histogram(const std::vector<std::uint64_t>& sorted)
+    {
+        std::size_t buckets[64] = {};
+        for(const auto sample : sorted)
+            ++buckets[sample ? 63 - __builtin_clzll(sample) : 0];
+
+        for(int i = 0; i < 64; ++i) {
+            if(!buckets[i])
+                continue;
+
+            const auto share =
+                static_cast<double>(buckets[i]) / static_cast<double>(sorted.size());
+            std::printf("    [%8llu, %8llu) %6.2f%% ",
+                        i ? 1ull << i : 0ull,
+                        1ull << (i + 1),
+                        share * 100.0);
+            for(int bar = static_cast<int>(share * 50.0); bar > 0; --bar)
+                std::putchar('#');
+            std::putchar('\n');
+        }
+    }
+
+    template<long (*Call)()>
+    void run_latency(const char*   name,
+                     const char*   path,
+                     std::size_t   iterations,
+                     std::uint64_t overhead,
+                     bool          histogram)
+    {
+        std::vector<std::uint64_t> samples(iterations);
+
+        // warm up the caches and branch predictors
+        for(std::size_t i = 0; i < iterations / 10; ++i)
+            sink = Call();
+
+        for(auto& sample : samples) {
+            const auto start = start_timestamp();
+            sink             = Call();
+            const auto end   = end_timestamp();
+            sample           = end - start > overhead ? end - start - overhead : 0;
+        }
+
+        std::sort(samples.begin(), samples.end());
+        std::printf("%-14s %-13s %8llu %8llu %8llu %8llu %8llu\n",
+                    name,
+                    path,
+                    static_cast<unsigned long long>(samples.front()),
+                    static_cast<unsigned long long>(percentile(samples, 0.5)),
+                    static_cast<unsigned long long>(percentile(samples, 0.9)),
+                    static_cast<unsigned long long>(percentile(samples, 0.99)),
+                    static_cast<unsigned long long>(samples.back()));
+
+        if(histogram)
+            print_histogram(samples);
+    }
+
+    std::uint64_t now_ns() noexcept
+    {
+        timespec time;
+        ::clock_gettime(CLOCK_MONOTONIC, &time);
+        return static_cast<std::uint64_t>(time.tv_sec) * 1000000000ull +
+               static_cast<std::uint64_t>(time.tv_nsec);
+    }
+
+    bool pin_to_cpu(int cpu) noexcept
+    {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        return ::pthread_setaffinity_np(::pthread_self(), sizeof(set), &set) == 0;
+    }
+
+    // runs the benchmark on the given cpus at the same time and returns millions of
+    // calls per second across all of them
+    template<long (*Call)()>
+    double run_throughput(const std::vector<int>& cpus, std::size_t iterations)
+    {
+        std::atomic<std::size_t> ready{ 0 };
+        std::atomic<bool>        go{ false };
+        std::vector<std::uint64_t> elapsed(cpus.size());
+        std::vector<std::thread>   threads;
+
+        for(std::size_t t = 0; t < cpus.size(); ++t)
+            threads.emplace_back([&, t] {
+                pin_to_cpu(cpus[t]);
+                ready.fetch_add(1);
+                while(!go.load(std::memory_order_acquire))
+                    ;
+
+                const auto start = now_ns();
+                long       local = 0;
+                for(std::size_t i = 0; i < iterations; ++i)
+                    local += Call();
+                elapsed[t] = now_ns() - start;
+                sink       = local;
+            });
+
+        while(ready.load() != cpus.size())
+            ;
+        go.store(true, std::memory_order_release);
+        for(auto& thread : threads)
+            thread.join();
+
+        // the slowest thread bounds the aggregate throughput
+        const auto slowest = *std::max_element(elapsed.begin(), elapsed.end());
+        return static_cast<double>(iterations * cpus.size()) * 1000.0 /
+               static_cast<double>(slowest);
+    }
+
+    struct benchmark {
+        const char* name;
+        const char* path;
+        void (*latency)(const char*, const char*, std::size_t, std::uint64_t, bool);
+        double (*throughput)(const std::vector<int>&, std::size_t);
+    };
+
+#define JM_BENCHMARK(name, path, call) \
+    benchmark { name, path, &run_latency<call>, &run_throughput<call> }
+
+    const benchmark benchmarks[] = {
+        JM_BENCHMARK("getpid", "glibc", glibc_getpid),
+        JM_BENCHMARK("getpid", "syscall", syscall_getpid),
+        JM_BENCHMARK("getpid", "stub", stub_getpid),
+        JM_BENCHMARK("getpid", "inline", inline_getpid),
+
+        JM_BENCHMARK("gettid", "glibc", glibc_gettid),
+        JM_BENCHMARK("gettid", "syscall", syscall_gettid),
+        JM_BENCHMARK("gettid", "stub", stub_gettid),
+        JM_BENCHMARK("gettid", "inline", inline_gettid),
+
+        JM_BENCHMARK("clock_gettime", "glibc (vdso)", glibc_clock_gettime),
+        JM_BENCHMARK("clock_gettime", "syscall", syscall_clock_gettime),
+        JM_BENCHMARK("clock_gettime", "stub", stub_clock_gettime),
+        JM_BENCHMARK("clock_gettime", "inline", inline_clock_gettime),
+        JM_BENCHMARK("clock_gettime", "inline (vdso)", inline_vdso_clock_gettime),
+
+        JM_BENCHMARK("prctl/5", "glibc", glibc_prctl),
+        JM_BENCHMARK("prctl/5", "syscall", syscall_prctl),
+        JM_BENCHMARK("prctl/5", "stub", stub_prctl),
+        JM_BENCHMARK("prctl/5", "inline", inline_prctl),
+
+        JM_BENCHMARK("sendto/6", "glibc", glibc_sendto),
+        JM_BENCHMARK("sendto/6", "syscall", syscall_sendto),
+        JM_BENCHMARK("sendto/6", "stub", stub_sendto),
+        JM_BENCHMARK("sendto/6", "inline", inline_sendto),
+    };
+
+#undef JM_BENCHMARK
+
+    std::vector<int> available_cpus()
+    {
+        std::vector<int> cpus;
+        cpu_set_t        set;
+        if(::sched_getaffinity(0, sizeof(set), &set) == 0)
+            for(int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+                if(CPU_ISSET(cpu, &set))
+                    cpus.push_back(cpu);
+        return cpus;
+    }
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    std::size_t iterations = 100000;
+    std::size_t threads    = 0;
+    bool        histogram  = false;
+
+    for(int i = 1; i < argc; ++i) {
+        if(!std::strcmp(argv[i], "--iterations") && i + 1 < argc)
+            iterations = std::strtoull(argv[++i], nullptr, 10);
+        else if(!std::strcmp(argv[i], "--threads") && i + 1 < argc)
+            threads = std::strtoull(argv[++i], nullptr, 10);
+        else if(!std::strcmp(argv[i], "--histogram"))
+            histogram = true;
+        else {
+            std::fprintf(stderr,
+                         "usage: %s [--iterations N] [--threads N] [--histogram]\n",
+                         argv[0]);
+            return 1;
+        }
+    }
+
+    if(iterations == 0)
+        iterations = 1;
+
+    const auto cpus = available_cpus();
+    if(cpus.empty()) {
+        std::fprintf(stderr, "sched_getaffinity failed\n");
+        return 1;
+    }
+
+    if(threads == 0 || threads > cpus.size())
+        threads = cpus.size();
+
+    // keep the latency measurements on a single core so that rdtsc stays comparable
+    pin_to_cpu(cpus.front());
+
+    const auto overhead = timestamp_overhead();
+    std::printf("latency in %s, %zu iterations, timestamp overhead %llu %s\n\n",
+                timestamp_unit,
+                iterations,
+                static_cast<unsigned long long>(overhead),
+                timestamp_unit);
+    std::printf("%-14s %-13s %8s %8s %8s %8s %8s\n",
+                "syscall",
+                "path",
+                "min",
+                "p50",
+                "p90",
+                "p99",
+                "max");
+    for(const auto& b : benchmarks)
+        b.latency(b.name, b.path, iterations, overhead, histogram);
+
+    std::printf("\nthroughput in million calls per second, threads pinned to separate cpus\n\n");
+    std::printf("%-14s %-13s", "syscall", "path");
+    for(std::size_t t = 1; t <= threads; t *= 2)
+        std::printf(" %8zu", t);
+    if((threads & (threads - 1)) != 0)
+        std::printf(" %8zu", threads);
+    std::putchar('\n');
+
+    for(const auto& b : benchmarks) {
+        std::printf("%-14s %-13s", b.name, b.path);
+        const auto run = [&](std::size_t count) {
+            const std::vector<int> used(cpus.begin(),
+                                        cpus.begin() + static_cast<long>(count));
+            std::printf(" %8.2f", b.throughput(used, iterations));
+            std::fflush(stdout);
+        };
+
+        for(std::size_t t = 1; t <= threads; t *= 2)
+            run(t);
+        if((threads & (threads - 1)) != 0)
+            run(threads);
+        std::putchar('\n');
+    }
+}
@@ -0,0 +1,26 @@
+# Cross compiles for arm64 linux and runs the tests under qemu-aarch64 with the libraries
+# of the cross toolchain:
+#   cmake -S . -B build-arm64 -DCMAKE_TOOLCHAIN_FILE=cmake/aarch64-linux-gnu.cmake
+#   cmake --build build-arm64 && ctest --test-dir build-arm64
+# Uses aarch64-linux-gnu-g++ unless another compiler, like clang++, is given with
+# -DCMAKE_CXX_COMPILER.
+
+set(CMAKE_SYSTEM_NAME Linux)
+set(CMAKE_SYSTEM_PROCESSOR aarch64)
+
+set(INLINE_SYSCALL_CROSS_TRIPLE aarch64-linux-gnu)
+set(INLINE_SYSCALL_CROSS_SYSROOT /usr/${INLINE_SYSCALL_CROSS_TRIPLE})
+
+if(NOT CMAKE_CXX_COMPILER)
+    set(CMAKE_CXX_COMPILER ${INLINE_SYSCALL_CROSS_TRIPLE}-g++)
+endif()
+# only used by clang
+set(CMAKE_CXX_COMPILER_TARGET ${INLINE_SYSCALL_CROSS_TRIPLE})
+
+set(CMAKE_FIND_ROOT_PATH ${INLINE_SYSCALL_CROSS_SYSROOT})
+set(CMAKE_FIND_ROOT_PATH_MODE_PROGRAM NEVER)
+set(CMAKE_FIND_ROOT_PATH_MODE_LIBRARY ONLY)
+set(CMAKE_FIND_ROOT_PATH_MODE_INCLUDE ONLY)
+
+# add_test runs the test executables through the emulator
+set(CMAKE_CROSSCOMPILING_EMULATOR qemu-aarch64 -L ${INLINE_SYSCALL_CROSS_SYSROOT})
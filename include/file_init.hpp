@@ -0,0 +1,128 @@
+/*
+ * Copyright 2018-2020 Justas Masiulis
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef JM_INLINE_SYSCALL_FILE_INIT_HPP
+#define JM_INLINE_SYSCALL_FILE_INIT_HPP
+
+#include "in_memory_init.hpp"
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace jm {
+
+    /// \brief Initializes syscalls list from an ntdll.dll file on disk.
+    inline bool init_syscalls_list_from_file(const char* path);
+
+    namespace detail {
+
+        /// \brief Read only mapping of a whole file.
+        class mapped_file {
+            const char* _data = nullptr;
+            std::size_t _size = 0;
+
+        public:
+            explicit mapped_file(const char* path) noexcept
+            {
+#if defined(_WIN32)
+                const auto file = CreateFileA(path,
+                                              GENERIC_READ,
+                                              FILE_SHARE_READ,
+                                              nullptr,
+                                              OPEN_EXISTING,
+                                              FILE_ATTRIBUTE_NORMAL,
+                                              nullptr);
+                if(file == INVALID_HANDLE_VALUE)
+                    return;
+
+                LARGE_INTEGER size;
+                if(GetFileSizeEx(file, &size) && size.QuadPart > 0) {
+                    const auto mapping =
+                        CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+                    if(mapping) {
+                        _data = static_cast<const char*>(
+                            MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+                        if(_data)
+                            _size = static_cast<std::size_t>(size.QuadPart);
+                        CloseHandle(mapping);
+                    }
+                }
+                CloseHandle(file);
+#else
+                const int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+                if(fd < 0)
+                    return;
+
+                struct stat st;
+                if(::fstat(fd, &st) == 0 && st.st_size > 0) {
+                    const auto data = ::mmap(nullptr,
+                                             static_cast<std::size_t>(st.st_size),
+                                             PROT_READ,
+                                             MAP_PRIVATE,
+                                             fd,
+                                             0);
+                    if(data != MAP_FAILED) {
+                        _data = static_cast<const char*>(data);
+                        _size = static_cast<std::size_t>(st.st_size);
+                    }
+                }
+                ::close(fd);
+#endif
+            }
+
+            mapped_file(const mapped_file&) = delete;
+            mapped_file& operator=(const mapped_file&) = delete;
+
+            ~mapped_file()
+            {
+                if(!_data)
+                    return;
+#if defined(_WIN32)
+                UnmapViewOfFile(_data);
+#else
+                ::munmap(const_cast<char*>(_data), _size);
+#endif
+            }
+
+            /// \brief Returns the start of the mapping or nullptr if the mapping failed.
+            const char* data() const noexcept { return _data; }
+
+            std::size_t size() const noexcept { return _size; }
+        };
+
+    } // namespace detail
+
+    /// \brief Initializes syscall ids from an ntdll.dll file on disk.
+    ///        The file is mapped read only and parsed in place in its raw file layout.
+    /// \returns false if the file could not be mapped or is not a valid image.
+    inline bool init_syscalls_list_from_file(const char* path)
+    {
+        const detail::mapped_file file(path);
+        if(!file.data())
+            return false;
+
+        return init_syscalls_list(file.data(), file.size(), image_layout::file);
+    }
+
+} // namespace jm
+
+#endif // JM_INLINE_SYSCALL_FILE_INIT_HPP
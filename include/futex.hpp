@@ -0,0 +1,317 @@
+/*
+ * Copyright 2018-2020 Justas Masiulis
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef JM_INLINE_SYSCALL_FUTEX_HPP
+#define JM_INLINE_SYSCALL_FUTEX_HPP
+
+#include "inline_syscall.hpp"
+#include <cerrno>
+#include <climits>
+#include <cstddef>
+#include <ctime>
+#include <linux/futex.h>
+
+#if !defined(__linux__)
+#error "futex.hpp is only available on linux"
+#endif
+
+// how many times a thread that failed to take futex_mutex checks whether it was unlocked
+// before going to sleep
+#if !defined(JM_INLINE_SYSCALL_FUTEX_SPINS)
+#define JM_INLINE_SYSCALL_FUTEX_SPINS 100
+#endif
+
+namespace jm {
+
+    class futex_event;
+
+    /// \brief Waits until any of the given events is set with a single futex_waitv.
+    /// \param count The number of events, at most 128.
+    /// \returns The index of an event that is set or -errno, -ENOSYS before linux 5.16.
+    inline int wait_any(futex_event* const* events, unsigned count) noexcept;
+
+    namespace detail {
+
+        // the prototype of futex(2) for the operations that are used here, which take
+        // no more than the timeout.
+        using futex = long(std::uint32_t* word, int op, std::uint32_t value, const timespec*);
+
+        // struct futex_waitv from <linux/futex.h> of 5.16, which older headers don't have
+        struct futex_waiter {
+            std::uint64_t value;
+            std::uint64_t address;
+            std::uint32_t flags;
+            std::uint32_t reserved;
+        };
+
+        using futex_waitv = long(futex_waiter*   waiters,
+                                 unsigned        count,
+                                 unsigned        flags,
+                                 const timespec* timeout,
+                                 clockid_t       clock);
+
+        // sleeps as long as word holds value. Returns immediately if it doesn't.
+        JM_INLINE_SYSCALL_FORCEINLINE void futex_wait(std::uint32_t* word,
+                                                      std::uint32_t  value) noexcept
+        {
+            INLINE_SYSCALL_T(futex)(word, FUTEX_WAIT_PRIVATE, value, nullptr);
+        }
+
+        JM_INLINE_SYSCALL_FORCEINLINE void futex_wake(std::uint32_t* word,
+                                                      std::uint32_t  count) noexcept
+        {
+            INLINE_SYSCALL_T(futex)(word, FUTEX_WAKE_PRIVATE, count, nullptr);
+        }
+
+        // sleeps until any of the futexes doesn't hold its value
+        JM_INLINE_SYSCALL_FORCEINLINE long futex_wait_any(futex_waiter* waiters,
+                                                          unsigned      count) noexcept
+        {
+            return INLINE_SYSCALL_T(futex_waitv)(waiters, count, 0, nullptr, CLOCK_MONOTONIC);
+        }
+
+        JM_INLINE_SYSCALL_FORCEINLINE void cpu_relax() noexcept
+        {
+#if defined(__aarch64__)
+            asm volatile("yield");
+#else
+            __builtin_ia32_pause();
+#endif
+        }
+
+    } // namespace detail
+
+    /// \brief A 4 byte mutex that spins for a while before sleeping on a futex.
+    ///        Locking and unlocking it without contention makes no syscall.
+    /// \note Satisfies Lockable, so it can be used with std::lock_guard and
+    ///       std::unique_lock. Not recursive.
+    class futex_mutex {
+        // 0 - unlocked, 1 - locked, 2 - locked and there might be threads sleeping
+        std::uint32_t _state = 0;
+
+        // spins while the mutex is locked by a thread that is still running. Once others
+        // are sleeping it is likely to stay locked for a while, so there is no point.
+        std::uint32_t spin() noexcept
+        {
+            for(int spins = JM_INLINE_SYSCALL_FUTEX_SPINS;; --spins) {
+                const auto state = __atomic_load_n(&_state, __ATOMIC_RELAXED);
+                if(state != 1 || spins == 0)
+                    return state;
+
+                detail::cpu_relax();
+            }
+        }
+
+        [[gnu::noinline]] void lock_contended() noexcept
+        {
+            auto state = spin();
+            if(state == 0) {
+                std::uint32_t expected = 0;
+                if(__atomic_compare_exchange_n(
+                       &_state, &expected, 1, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+                    return;
+                state = expected;
+            }
+
+            // taking the mutex as 2 is conservative, as there is no way to know whether
+            // this was the last thread that slept on it.
+            for(;;) {
+                if(state != 2 && __atomic_exchange_n(&_state, 2, __ATOMIC_ACQUIRE) == 0)
+                    return;
+
+                detail::futex_wait(&_state, 2);
+                state = spin();
+            }
+        }
+
+    public:
+        constexpr futex_mutex() noexcept = default;
+
+        futex_mutex(const futex_mutex&) = delete;
+        futex_mutex& operator=(const futex_mutex&) = delete;
+
+        bool try_lock() noexcept
+        {
+            std::uint32_t expected = 0;
+            return __atomic_compare_exchange_n(
+                &_state, &expected, 1, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED);
+        }
+
+        void lock() noexcept
+        {
+            if(!try_lock())
+                lock_contended();
+        }
+
+        void unlock() noexcept
+        {
+            if(__atomic_exchange_n(&_state, 0, __ATOMIC_RELEASE) == 2)
+                detail::futex_wake(&_state, 1);
+        }
+    };
+
+    /// \brief A condition variable for futex_mutex. Notifying it while no thread waits
+    ///        makes no syscall.
+    /// \note Waits can wake up spuriously, use the overload that takes a predicate.
+    class futex_condition {
+        // incremented by every notification, which makes the futex wait of threads that
+        // are about to sleep fail instead of missing it.
+        std::uint32_t _sequence = 0;
+        std::uint32_t _waiters  = 0;
+
+        void notify(std::uint32_t count) noexcept
+        {
+            __atomic_fetch_add(&_sequence, 1, __ATOMIC_SEQ_CST);
+            if(__atomic_load_n(&_waiters, __ATOMIC_SEQ_CST) != 0)
+                detail::futex_wake(&_sequence, count);
+        }
+
+    public:
+        constexpr futex_condition() noexcept = default;
+
+        futex_condition(const futex_condition&) = delete;
+        futex_condition& operator=(const futex_condition&) = delete;
+
+        /// \brief Unlocks the mutex, sleeps until notified and locks the mutex again.
+        void wait(futex_mutex& mutex) noexcept
+        {
+            __atomic_fetch_add(&_waiters, 1, __ATOMIC_SEQ_CST);
+            const auto sequence = __atomic_load_n(&_sequence, __ATOMIC_RELAXED);
+            mutex.unlock();
+            detail::futex_wait(&_sequence, sequence);
+            __atomic_fetch_sub(&_waiters, 1, __ATOMIC_RELAXED);
+            mutex.lock();
+        }
+
+        template<class Predicate>
+        void wait(futex_mutex& mutex, Predicate predicate)
+        {
+            while(!predicate())
+                wait(mutex);
+        }
+
+        void notify_one() noexcept { notify(1); }
+
+        void notify_all() noexcept { notify(INT_MAX); }
+    };
+
+    /// \brief An event that is set once and wakes every thread that waits for it.
+    ///        Setting it while no thread waits and waiting for it once it is set makes
+    ///        no syscall.
+    class futex_event {
+        // 0 - not set, 1 - set, 2 - not set and there might be threads sleeping
+        std::uint32_t _state = 0;
+
+        friend int wait_any(futex_event* const* events, unsigned count) noexcept;
+
+        // marks the event as waited for. Returns false if it is already set.
+        bool prepare_wait() noexcept
+        {
+            std::uint32_t expected = 0;
+            return __atomic_compare_exchange_n(
+                       &_state, &expected, 2, false, __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE) ||
+                   expected == 2;
+        }
+
+    public:
+        constexpr futex_event() noexcept = default;
+
+        futex_event(const futex_event&) = delete;
+        futex_event& operator=(const futex_event&) = delete;
+
+        bool is_set() const noexcept { return __atomic_load_n(&_state, __ATOMIC_ACQUIRE) == 1; }
+
+        void set() noexcept
+        {
+            if(__atomic_exchange_n(&_state, 1, __ATOMIC_RELEASE) == 2)
+                detail::futex_wake(&_state, INT_MAX);
+        }
+
+        void wait() noexcept
+        {
+            while(!is_set() && prepare_wait())
+                detail::futex_wait(&_state, 2);
+        }
+    };
+
+    inline int wait_any(futex_event* const* events, unsigned count) noexcept
+    {
+        constexpr unsigned max_count = 128;
+        if(count == 0 || count > max_count)
+            return -EINVAL;
+
+        detail::futex_waiter waiters[max_count];
+        for(;;) {
+            for(unsigned i = 0; i < count; ++i) {
+                if(events[i]->is_set() || !events[i]->prepare_wait())
+                    return static_cast<int>(i);
+
+                waiters[i].value    = 2;
+                waiters[i].address  = reinterpret_cast<std::uintptr_t>(&events[i]->_state);
+                waiters[i].flags    = 2 /* FUTEX2_SIZE_U32 */ | FUTEX_PRIVATE_FLAG;
+                waiters[i].reserved = 0;
+            }
+
+            const auto result = detail::futex_wait_any(waiters, count);
+            if(result < 0 && result != -EAGAIN && result != -EINTR)
+                return static_cast<int>(result);
+        }
+    }
+
+    /// \brief A counting semaphore. Acquiring it while it is available and releasing it
+    ///        while no thread waits makes no syscall.
+    class futex_semaphore {
+        std::uint32_t _count;
+        std::uint32_t _waiters = 0;
+
+    public:
+        constexpr explicit futex_semaphore(std::uint32_t count = 0) noexcept : _count(count) {}
+
+        futex_semaphore(const futex_semaphore&) = delete;
+        futex_semaphore& operator=(const futex_semaphore&) = delete;
+
+        bool try_acquire() noexcept
+        {
+            auto count = __atomic_load_n(&_count, __ATOMIC_RELAXED);
+            while(count != 0)
+                if(__atomic_compare_exchange_n(
+                       &_count, &count, count - 1, true, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+                    return true;
+            return false;
+        }
+
+        void acquire() noexcept
+        {
+            while(!try_acquire()) {
+                // the count is read by the kernel after the waiter is announced, so either
+                // the release sees the waiter or the futex sees the released count.
+                __atomic_fetch_add(&_waiters, 1, __ATOMIC_SEQ_CST);
+                detail::futex_wait(&_count, 0);
+                __atomic_fetch_sub(&_waiters, 1, __ATOMIC_RELAXED);
+            }
+        }
+
+        void release(std::uint32_t count = 1) noexcept
+        {
+            __atomic_fetch_add(&_count, count, __ATOMIC_SEQ_CST);
+            if(__atomic_load_n(&_waiters, __ATOMIC_SEQ_CST) != 0)
+                detail::futex_wake(&_count, count);
+        }
+    };
+
+} // namespace jm
+
+#endif // JM_INLINE_SYSCALL_FUTEX_HPP
@@ -18,105 +18,139 @@
 #define JM_INLINE_SYSCALL_IN_MEMORY_INIT_HPP
 
 #include "inline_syscall.hpp"
+#include <cassert>
+#include <cstddef>
+#include <type_traits>
+
+#if defined(_WIN32)
 #include <intrin.h>
+#endif
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
 
 namespace jm {
 
+    /// \brief The way a PE image is laid out in memory.
+    enum class image_layout {
+        mapped, ///< sections are placed at their virtual addresses (loaded by the loader).
+        file ///< raw file contents, RVAs need to be translated through the section table.
+    };
+
+#if defined(_WIN32)
     /// \brief Initializes syscalls list.
     inline void init_syscalls_list();
+#endif
+
+    /// \brief Initializes syscalls list from the given ntdll image.
+    inline bool init_syscalls_list(const void* image, std::size_t size, image_layout layout);
 
     namespace detail {
 
         struct IMAGE_DOS_HEADER { // DOS .EXE header
-            unsigned short e_magic; // Magic number
-            unsigned short e_cblp; // Bytes on last page of file
-            unsigned short e_cp; // Pages in file
-            unsigned short e_crlc; // Relocations
-            unsigned short e_cparhdr; // Size of header in paragraphs
-            unsigned short e_minalloc; // Minimum extra paragraphs needed
-            unsigned short e_maxalloc; // Maximum extra paragraphs needed
-            unsigned short e_ss; // Initial (relative) SS value
-            unsigned short e_sp; // Initial SP value
-            unsigned short e_csum; // Checksum
-            unsigned short e_ip; // Initial IP value
-            unsigned short e_cs; // Initial (relative) CS value
-            unsigned short e_lfarlc; // File address of relocation table
-            unsigned short e_ovno; // Overlay number
-            unsigned short e_res[4]; // Reserved words
-            unsigned short e_oemid; // OEM identifier (for e_oeminfo)
-            unsigned short e_oeminfo; // OEM information; e_oemid specific
-            unsigned short e_res2[10]; // Reserved words
-            long           e_lfanew; // File address of new exe header
+            std::uint16_t e_magic; // Magic number
+            std::uint16_t e_cblp; // Bytes on last page of file
+            std::uint16_t e_cp; // Pages in file
+            std::uint16_t e_crlc; // Relocations
+            std::uint16_t e_cparhdr; // Size of header in paragraphs
+            std::uint16_t e_minalloc; // Minimum extra paragraphs needed
+            std::uint16_t e_maxalloc; // Maximum extra paragraphs needed
+            std::uint16_t e_ss; // Initial (relative) SS value
+            std::uint16_t e_sp; // Initial SP value
+            std::uint16_t e_csum; // Checksum
+            std::uint16_t e_ip; // Initial IP value
+            std::uint16_t e_cs; // Initial (relative) CS value
+            std::uint16_t e_lfarlc; // File address of relocation table
+            std::uint16_t e_ovno; // Overlay number
+            std::uint16_t e_res[4]; // Reserved words
+            std::uint16_t e_oemid; // OEM identifier (for e_oeminfo)
+            std::uint16_t e_oeminfo; // OEM information; e_oemid specific
+            std::uint16_t e_res2[10]; // Reserved words
+            std::int32_t  e_lfanew; // File address of new exe header
         };
 
         struct IMAGE_FILE_HEADER {
-            unsigned short Machine;
-            unsigned short NumberOfSections;
-            unsigned long  TimeDateStamp;
-            unsigned long  PointerToSymbolTable;
-            unsigned long  NumberOfSymbols;
-            unsigned short SizeOfOptionalHeader;
-            unsigned short Characteristics;
+            std::uint16_t Machine;
+            std::uint16_t NumberOfSections;
+            std::uint32_t TimeDateStamp;
+            std::uint32_t PointerToSymbolTable;
+            std::uint32_t NumberOfSymbols;
+            std::uint16_t SizeOfOptionalHeader;
+            std::uint16_t Characteristics;
         };
 
         struct IMAGE_EXPORT_DIRECTORY {
-            unsigned long  Characteristics;
-            unsigned long  TimeDateStamp;
-            unsigned short MajorVersion;
-            unsigned short MinorVersion;
-            unsigned long  Name;
-            unsigned long  Base;
-            unsigned long  NumberOfFunctions;
-            unsigned long  NumberOfNames;
-            unsigned long  AddressOfFunctions; // RVA from base of image
-            unsigned long  AddressOfNames; // RVA from base of image
-            unsigned long  AddressOfNameOrdinals; // RVA from base of image
+            std::uint32_t Characteristics;
+            std::uint32_t TimeDateStamp;
+            std::uint16_t MajorVersion;
+            std::uint16_t MinorVersion;
+            std::uint32_t Name;
+            std::uint32_t Base;
+            std::uint32_t NumberOfFunctions;
+            std::uint32_t NumberOfNames;
+            std::uint32_t AddressOfFunctions; // RVA from base of image
+            std::uint32_t AddressOfNames; // RVA from base of image
+            std::uint32_t AddressOfNameOrdinals; // RVA from base of image
         };
 
         struct IMAGE_DATA_DIRECTORY {
-            unsigned long VirtualAddress;
-            unsigned long Size;
+            std::uint32_t VirtualAddress;
+            std::uint32_t Size;
         };
 
         struct IMAGE_OPTIONAL_HEADER64 {
-            unsigned short       Magic;
-            unsigned char        MajorLinkerVersion;
-            unsigned char        MinorLinkerVersion;
-            unsigned long        SizeOfCode;
-            unsigned long        SizeOfInitializedData;
-            unsigned long        SizeOfUninitializedData;
-            unsigned long        AddressOfEntryPoint;
-            unsigned long        BaseOfCode;
-            unsigned long long   ImageBase;
-            unsigned long        SectionAlignment;
-            unsigned long        FileAlignment;
-            unsigned short       MajorOperatingSystemVersion;
-            unsigned short       MinorOperatingSystemVersion;
-            unsigned short       MajorImageVersion;
-            unsigned short       MinorImageVersion;
-            unsigned short       MajorSubsystemVersion;
-            unsigned short       MinorSubsystemVersion;
-            unsigned long        Win32VersionValue;
-            unsigned long        SizeOfImage;
-            unsigned long        SizeOfHeaders;
-            unsigned long        CheckSum;
-            unsigned short       Subsystem;
-            unsigned short       DllCharacteristics;
-            unsigned long long   SizeOfStackReserve;
-            unsigned long long   SizeOfStackCommit;
-            unsigned long long   SizeOfHeapReserve;
-            unsigned long long   SizeOfHeapCommit;
-            unsigned long        LoaderFlags;
-            unsigned long        NumberOfRvaAndSizes;
+            std::uint16_t        Magic;
+            std::uint8_t         MajorLinkerVersion;
+            std::uint8_t         MinorLinkerVersion;
+            std::uint32_t        SizeOfCode;
+            std::uint32_t        SizeOfInitializedData;
+            std::uint32_t        SizeOfUninitializedData;
+            std::uint32_t        AddressOfEntryPoint;
+            std::uint32_t        BaseOfCode;
+            std::uint64_t        ImageBase;
+            std::uint32_t        SectionAlignment;
+            std::uint32_t        FileAlignment;
+            std::uint16_t        MajorOperatingSystemVersion;
+            std::uint16_t        MinorOperatingSystemVersion;
+            std::uint16_t        MajorImageVersion;
+            std::uint16_t        MinorImageVersion;
+            std::uint16_t        MajorSubsystemVersion;
+            std::uint16_t        MinorSubsystemVersion;
+            std::uint32_t        Win32VersionValue;
+            std::uint32_t        SizeOfImage;
+            std::uint32_t        SizeOfHeaders;
+            std::uint32_t        CheckSum;
+            std::uint16_t        Subsystem;
+            std::uint16_t        DllCharacteristics;
+            std::uint64_t        SizeOfStackReserve;
+            std::uint64_t        SizeOfStackCommit;
+            std::uint64_t        SizeOfHeapReserve;
+            std::uint64_t        SizeOfHeapCommit;
+            std::uint32_t        LoaderFlags;
+            std::uint32_t        NumberOfRvaAndSizes;
             IMAGE_DATA_DIRECTORY DataDirectory[16];
         };
 
         struct IMAGE_NT_HEADERS {
-            unsigned long           Signature;
+            std::uint32_t           Signature;
             IMAGE_FILE_HEADER       FileHeader;
             IMAGE_OPTIONAL_HEADER64 OptionalHeader;
         };
 
+        struct IMAGE_SECTION_HEADER {
+            std::uint8_t  Name[8];
+            std::uint32_t VirtualSize;
+            std::uint32_t VirtualAddress;
+            std::uint32_t SizeOfRawData;
+            std::uint32_t PointerToRawData;
+            std::uint32_t PointerToRelocations;
+            std::uint32_t PointerToLinenumbers;
+            std::uint16_t NumberOfRelocations;
+            std::uint16_t NumberOfLinenumbers;
+            std::uint32_t Characteristics;
+        };
+
         JM_INLINE_SYSCALL_FORCEINLINE const IMAGE_NT_HEADERS* nt_headers(
             const char* base) noexcept
         {
@@ -124,47 +158,161 @@ namespace jm {
                 base + reinterpret_cast<const IMAGE_DOS_HEADER*>(base)->e_lfanew);
         }
 
+        // Validates the headers of a PE32+ image and returns them.
+        // Returns nullptr if the headers do not fit into the image or are malformed.
+        inline const IMAGE_NT_HEADERS* nt_headers(const char* base, std::size_t size) noexcept
+        {
+            if(size < sizeof(IMAGE_DOS_HEADER) || size < sizeof(IMAGE_NT_HEADERS))
+                return nullptr;
+
+            const auto dos = reinterpret_cast<const IMAGE_DOS_HEADER*>(base);
+            if(dos->e_magic != 0x5A4D || dos->e_lfanew < 0 ||
+               static_cast<std::size_t>(dos->e_lfanew) > size - sizeof(IMAGE_NT_HEADERS))
+                return nullptr;
+
+            const auto nt = nt_headers(base);
+            if(nt->Signature != 0x4550 || nt->OptionalHeader.Magic != 0x20B)
+                return nullptr;
+
+            return nt;
+        }
+
         struct exports_directory {
             const char*                   _base;
-            const IMAGE_EXPORT_DIRECTORY* _ied;
+            std::size_t                   _size;
+            const IMAGE_NT_HEADERS*       _nt       = nullptr;
+            const IMAGE_EXPORT_DIRECTORY* _ied      = nullptr;
+            const std::uint32_t*          _names    = nullptr;
+            const std::uint32_t*          _rvas     = nullptr;
+            const std::uint16_t*          _ordinals = nullptr;
+            image_layout                  _layout;
+
+            // translates RVA to an offset from _base. Returns _size on failure.
+            std::size_t offset(std::uint32_t rva) const noexcept
+            {
+                if(_layout == image_layout::mapped)
+                    return rva < _size ? rva : _size;
+
+                const auto sections = reinterpret_cast<const IMAGE_SECTION_HEADER*>(
+                    reinterpret_cast<const char*>(&_nt->OptionalHeader) +
+                    _nt->FileHeader.SizeOfOptionalHeader);
+                for(std::uint16_t i = 0; i < _nt->FileHeader.NumberOfSections; ++i) {
+                    const auto& section = sections[i];
+                    if(rva >= section.VirtualAddress &&
+                       rva - section.VirtualAddress < section.SizeOfRawData) {
+                        const std::size_t result =
+                            section.PointerToRawData + (rva - section.VirtualAddress);
+                        return result < _size ? result : _size;
+                    }
+                }
+
+                // headers are not part of any section and are mapped as is
+                return rva < _nt->OptionalHeader.SizeOfHeaders && rva < _size ? rva : _size;
+            }
+
+            // translates RVA of an array of count elements of type T into a pointer
+            template<class T>
+            const T* array(std::uint32_t rva, std::size_t count) const noexcept
+            {
+                const auto off = offset(rva);
+                if(off == _size || count > (_size - off) / sizeof(T))
+                    return nullptr;
+
+                return reinterpret_cast<const T*>(_base + off);
+            }
 
         public:
-            using size_type = unsigned long;
+            using size_type = std::uint32_t;
 
+            /// \brief Parses the export directory of an image loaded by the windows loader.
             JM_INLINE_SYSCALL_FORCEINLINE exports_directory(const char* base) noexcept
-                : _base(base)
+                : exports_directory(base,
+                                    nt_headers(base)->OptionalHeader.SizeOfImage,
+                                    image_layout::mapped)
+            {}
+
+            /// \brief Parses the export directory of an image of the given size and layout.
+            ///        All accesses are bounds checked against the size of the image.
+            /// \note If the image is malformed the directory is treated as empty.
+            exports_directory(const char* base, std::size_t size, image_layout layout) noexcept
+                : _base(base), _size(size), _layout(layout)
             {
-                const auto ied_data_dir =
-                    nt_headers(base)->OptionalHeader.DataDirectory[0];
-                _ied = reinterpret_cast<const IMAGE_EXPORT_DIRECTORY*>(
-                    base + ied_data_dir.VirtualAddress);
+                _nt = nt_headers(base, size);
+                if(!_nt)
+                    return;
+
+                // the section table has to fit into the image as well
+                const auto sections_offset =
+                    static_cast<std::size_t>(reinterpret_cast<const char*>(
+                                                 &_nt->OptionalHeader) -
+                                             base) +
+                    _nt->FileHeader.SizeOfOptionalHeader;
+                if(_nt->OptionalHeader.NumberOfRvaAndSizes == 0 || sections_offset > size ||
+                   _nt->FileHeader.NumberOfSections >
+                       (size - sections_offset) / sizeof(IMAGE_SECTION_HEADER)) {
+                    _nt = nullptr;
+                    return;
+                }
+
+                const auto ied_data_dir = _nt->OptionalHeader.DataDirectory[0];
+                _ied = array<IMAGE_EXPORT_DIRECTORY>(ied_data_dir.VirtualAddress, 1);
+                if(!_ied)
+                    return;
+
+                _names    = array<std::uint32_t>(_ied->AddressOfNames, _ied->NumberOfNames);
+                _ordinals = array<std::uint16_t>(_ied->AddressOfNameOrdinals,
+                                                 _ied->NumberOfNames);
+                _rvas     = array<std::uint32_t>(_ied->AddressOfFunctions,
+                                             _ied->NumberOfFunctions);
+                if(!_names || !_ordinals || !_rvas)
+                    _ied = nullptr;
+            }
+
+            /// \brief Returns the nt headers of the image or nullptr if it is malformed.
+            JM_INLINE_SYSCALL_FORCEINLINE const IMAGE_NT_HEADERS* headers() const noexcept
+            {
+                return _nt;
             }
 
             JM_INLINE_SYSCALL_FORCEINLINE size_type size() const noexcept
             {
-                return _ied->NumberOfNames;
+                return _ied ? _ied->NumberOfNames : 0;
             }
 
+            /// \brief Returns the name of export or nullptr if it lies outside of the image.
             JM_INLINE_SYSCALL_FORCEINLINE const char* name(size_type index) const noexcept
             {
-                return reinterpret_cast<const char*>(
-                    _base + reinterpret_cast<const unsigned long*>(
-                                _base + _ied->AddressOfNames)[index]);
+                const auto off = offset(_names[index]);
+                for(auto i = off; i < _size; ++i)
+                    if(_base[i] == '\0')
+                        return _base + off;
+
+                return nullptr;
             }
 
+            /// \brief Returns the address of export or nullptr if it lies outside of the
+            ///        image.
             JM_INLINE_SYSCALL_FORCEINLINE const char* address(size_type index) const
                 noexcept
             {
-                const auto* const rva_table = reinterpret_cast<const unsigned long*>(
-                    _base + _ied->AddressOfFunctions);
+                const auto ordinal = _ordinals[index];
+                if(ordinal >= _ied->NumberOfFunctions)
+                    return nullptr;
 
-                const auto* const ord_table = reinterpret_cast<const unsigned short*>(
-                    _base + _ied->AddressOfNameOrdinals);
+                const auto off = offset(_rvas[ordinal]);
+                return off == _size ? nullptr : _base + off;
+            }
 
-                return _base + rva_table[ord_table[index]];
+            /// \brief Checks whether the given range lies within the image.
+            JM_INLINE_SYSCALL_FORCEINLINE bool contains(const char* ptr,
+                                                        std::size_t size) const noexcept
+            {
+                return ptr >= _base && static_cast<std::size_t>(ptr - _base) <= _size &&
+                       size <= _size - static_cast<std::size_t>(ptr - _base);
             }
         };
 
+#if defined(_WIN32)
         JM_INLINE_SYSCALL_FORCEINLINE const void* ntdll_base() noexcept
         {
             struct ldr_entry_t {
@@ -184,31 +332,256 @@ namespace jm {
 
             return ldr_entry->Flink->DllBase;
         }
+#endif
+
+        // compares two null terminated strings the same way the export names are sorted
+        JM_INLINE_SYSCALL_FORCEINLINE bool less(const char* lhs, const char* rhs) noexcept
+        {
+            for(; *lhs && *lhs == *rhs; ++lhs, ++rhs) {}
+            return static_cast<unsigned char>(*lhs) < static_cast<unsigned char>(*rhs);
+        }
+
+        // returns the index of the first export name that is not less than the given
+        // string. Export names are sorted lexically so we can binary search them.
+        inline exports_directory::size_type lower_bound(const exports_directory& exports,
+                                                        const char* str) noexcept
+        {
+            exports_directory::size_type first = 0;
+            exports_directory::size_type count = exports.size();
+            while(count > 0) {
+                const auto step = count / 2;
+                const auto name = exports.name(first + step);
+                // names outside of the image can only come from a malformed image
+                if(!name)
+                    return exports.size();
+
+                if(less(name, str)) {
+                    first += step + 1;
+                    count -= step + 1;
+                }
+                else
+                    count = step;
+            }
+            return first;
+        }
+
+        // reads the syscall id from the stub of the export which starts with
+        // mov r10, rcx; mov eax, id
+        inline bool stub_id(const exports_directory&    exports,
+                            exports_directory::size_type index,
+                            std::uint32_t&               id) noexcept
+        {
+            const auto address = exports.address(index);
+            if(!address || !exports.contains(address + 4, 4))
+                return false;
+
+            id = *reinterpret_cast<const std::uint32_t*>(address + 4);
+            return true;
+        }
+
+        // the distance between the hashes of consecutive entries in 32 bit words, or 0 if
+        // they have to be read one at a time.
+        template<class Entry>
+        constexpr std::size_t hash_stride() noexcept
+        {
+            if constexpr(std::is_same_v<Entry, syscall_entry_split>)
+                return 1;
+            else if constexpr(std::is_standard_layout_v<Entry> &&
+                              std::is_same_v<decltype(Entry::hash), std::uint32_t> &&
+                              sizeof(Entry) % 4 == 0 && sizeof(Entry) <= 16)
+                return offsetof(Entry, hash) % 4 == 0 ? sizeof(Entry) / 4 : 0;
+            else
+                return 0;
+        }
+
+        // the bits of a compare mask of Words 32 bit lanes that belong to hashes
+        template<std::size_t Stride, std::size_t Words>
+        constexpr unsigned hash_lanes() noexcept
+        {
+            unsigned mask = 0;
+            for(std::size_t word = 0; word < Words; word += Stride)
+                mask |= 1u << word;
+            return mask;
+        }
+
+        // returns the index of the first of count hashes that is equal to the given one or
+        // count if there is none. Compares 8 or 4 words at a time with AVX2 or SSE2 and
+        // never reads past the last hash.
+        template<std::size_t Stride>
+        inline std::size_t find_hash(const std::uint32_t* hashes,
+                                     std::size_t          count,
+                                     std::uint32_t        hash) noexcept
+        {
+            // the number of words from the first hash to the end of the last one
+            const auto  words = count == 0 ? 0 : (count - 1) * Stride + 1;
+            std::size_t i     = 0;
+#if defined(__AVX2__)
+            constexpr auto mask  = hash_lanes<Stride, 8>();
+            constexpr auto lanes = (8 + Stride - 1) / Stride;
+
+            const auto needle = _mm256_set1_epi32(static_cast<int>(hash));
+            for(; i * Stride + 8 <= words; i += lanes) {
+                const auto vector = _mm256_loadu_si256(
+                    reinterpret_cast<const __m256i*>(hashes + i * Stride));
+                const auto equal = static_cast<unsigned>(_mm256_movemask_ps(
+                                       _mm256_castsi256_ps(_mm256_cmpeq_epi32(vector, needle)))) &
+                                   mask;
+                if(equal)
+                    return i + static_cast<std::size_t>(__builtin_ctz(equal)) / Stride;
+            }
+#elif defined(__SSE2__)
+            constexpr auto mask  = hash_lanes<Stride, 4>();
+            constexpr auto lanes = (4 + Stride - 1) / Stride;
+
+            const auto needle = _mm_set1_epi32(static_cast<int>(hash));
+            for(; i * Stride + 4 <= words; i += lanes) {
+                const auto vector =
+                    _mm_loadu_si128(reinterpret_cast<const __m128i*>(hashes + i * Stride));
+                const auto equal = static_cast<unsigned>(_mm_movemask_ps(
+                                       _mm_castsi128_ps(_mm_cmpeq_epi32(vector, needle)))) &
+                                   mask;
+                if(equal)
+                    return i + static_cast<std::size_t>(__builtin_ctz(equal)) / Stride;
+            }
+#endif
+            for(; i < count; ++i)
+                if(hashes[i * Stride] == hash)
+                    return i;
+
+            return count;
+        }
+
+        // resolves the syscall entries in [first, last) using the Zw* exports of the given
+        // module. Every syscall has a Zw* alias so there is no need to look at Nt* exports.
+        // Entries with zero hash are skipped. Split entries can only be resolved in
+        // syscall_entries().
+        template<class Entry>
+        inline void resolve_syscall_entries(const exports_directory& exports,
+                                            Entry*                   first,
+                                            Entry*                   last) noexcept
+        {
+            const auto  count     = static_cast<std::size_t>(last - first);
+            std::size_t remaining = 0;
+            for(std::size_t i = 0; i < count; ++i)
+                if(entry_hash(first + i) != 0)
+                    ++remaining;
+            if(remaining == 0)
+                return;
+
+            // small entries overwrite their hashes with ids, but the chance of an id
+            // matching the hash of another export is negligible.
+            constexpr auto       stride = hash_stride<Entry>();
+            const std::uint32_t* hashes = nullptr;
+            if constexpr(std::is_same_v<Entry, syscall_entry_split>)
+                hashes = syscall_hashes<Entry>() + (first - syscall_entries());
+            else if constexpr(stride != 0)
+                hashes = reinterpret_cast<const std::uint32_t*>(
+                    reinterpret_cast<const char*>(first) + offsetof(Entry, hash));
+
+            const auto export_last = lower_bound(exports, "Zx");
+            for(auto i = lower_bound(exports, "Zw"); remaining != 0 && i < export_last; ++i) {
+                const auto name = exports.name(i);
+                if(!name)
+                    continue;
+
+                // zero hash would match the padding
+                const auto name_hash = jm::hash(name);
+                if(name_hash == 0)
+                    continue;
+
+                std::size_t index = 0;
+                if constexpr(stride != 0)
+                    index = find_hash<stride>(hashes, count, name_hash);
+                else
+                    while(index < count && entry_hash(first + index) != name_hash)
+                        ++index;
+
+                std::uint32_t id;
+                if(index != count && stub_id(exports, i, id)) {
+                    first[index].id = id;
+                    --remaining;
+                }
+            }
+        }
+
+        // resolves syscall entries of the binary using the Zw* exports of the given module.
+        inline void resolve_syscall_entries(const exports_directory& exports) noexcept
+        {
+            resolve_syscall_entries(exports, jm::syscall_entries(), jm::syscall_entries_end());
+        }
+
+        // looks up the id of a single syscall using the Zw* exports of the given module.
+        inline bool find_syscall_id(const exports_directory& exports,
+                                    std::uint32_t            hash,
+                                    std::uint32_t&           id) noexcept
+        {
+            const auto last = lower_bound(exports, "Zx");
+            for(auto i = lower_bound(exports, "Zw"); i < last; ++i) {
+                const auto name = exports.name(i);
+                if(name && jm::hash(name) == hash)
+                    return stub_id(exports, i, id);
+            }
+            return false;
+        }
 
     } // namespace detail
 
+#if defined(_WIN32)
     /// \brief Initializes syscall ids with information from ntdll.dll loaded in current
     ///        process.
+    /// \note Only the Zw* range of the export name table is scanned and the scan stops as
+    ///       soon as every syscall entry has been resolved.
     /// \warning THIS DOES NOT INITIALIZE SYSCALLS FROM USER32.DLL / NtUser*
     JM_INLINE_SYSCALL_FORCEINLINE void init_syscalls_list()
     {
-        detail::exports_directory exports(static_cast<const char*>(detail::ntdll_base()));
-        for(auto i = exports.size() - 1;; --i) {
-            auto entry = jm::syscall_entries();
-            while(entry->hash != 0) {
-                if(jm::hash(exports.name(i)) == entry->hash) {
-                    entry->id =
-                        *reinterpret_cast<const std::int32_t*>(exports.address(i) + 4);
-                    break;
-                }
-                ++entry;
-            }
+        assert(detail::syscall_entries_in_section() &&
+               "the compiler didn't place the syscall entries in their section");
+        detail::resolve_syscall_entries(
+            detail::exports_directory(static_cast<const char*>(detail::ntdll_base())));
+    }
 
-            if(i == 0)
-                break;
-        }
+    /// \brief Resolves a single lazy syscall entry with information from ntdll.dll loaded
+    ///        in current process. Used by INLINE_SYSCALL on the first use of the entry.
+    /// \returns The id of syscall or syscall_entry_lazy::unresolved if it wasn't found.
+    [[gnu::cold, gnu::noinline]] inline std::uint32_t resolve_syscall_entry(
+        syscall_entry_lazy& entry) noexcept
+    {
+        std::uint32_t id;
+        if(!detail::find_syscall_id(
+               detail::exports_directory(static_cast<const char*>(detail::ntdll_base())),
+               entry.hash,
+               id))
+            return syscall_entry_lazy::unresolved;
+
+        // racing threads all store the same value so there is no need for anything
+        // stronger than making the store itself atomic.
+        __atomic_store_n(&entry.id, id, __ATOMIC_RELAXED);
+        return id;
+    }
+#endif
+
+    /// \brief Initializes syscall ids with information from an ntdll.dll image that is
+    ///        not necessarily loaded in the current process.
+    /// \param image The start of the image.
+    /// \param size The size of the image buffer. No memory outside of it is accessed.
+    /// \param layout Whether the image is mapped by the loader or is a raw file.
+    /// \returns false if the image is not a valid PE32+ image with an export directory or
+    ///          the compiler didn't place the syscall entries in their section, which
+    ///          GCC doesn't.
+    inline bool init_syscalls_list(const void* image, std::size_t size, image_layout layout)
+    {
+        if(!detail::syscall_entries_in_section())
+            return false;
+
+        const detail::exports_directory exports(
+            static_cast<const char*>(image), size, layout);
+        if(exports.size() == 0)
+            return false;
+
+        detail::resolve_syscall_entries(exports);
+        return true;
     }
 
 } // namespace jm
 
-#endif // JM_INLINE_SYSCALL_IN_MEMORY_INIT_HPP
\ No newline at end of file
+#endif // JM_INLINE_SYSCALL_IN_MEMORY_INIT_HPP
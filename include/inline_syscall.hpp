@@ -17,31 +17,95 @@
 #ifndef JM_INLINE_SYSCALL_HPP
 #define JM_INLINE_SYSCALL_HPP
 
+#include <cstddef>
 #include <cstdint>
+#include <utility>
 
 /// \brief Returns an instance of syscall_function for the given syscall.
 /// \param function_type A function pointer whose type and name match the corresponding
 ///                      syscall.
-#define INLINE_SYSCALL(function_pointer) \
-    INLINE_SYSCALL_MANUAL(               \
-        function_pointer,                \
-        ::jm::detail::syscall_holder<::jm::hash(#function_pointer)>::entry.id)
+/// \note On linux syscalls that the vDSO implements call it instead.
+#define INLINE_SYSCALL(function_pointer)                              \
+    ::jm::detail::route_syscall<::jm::hash(#function_pointer)>(       \
+        decltype(::jm::detail::syscall_function_of(function_pointer)){ \
+            JM_INLINE_SYSCALL_FUNCTION_ARGS(::jm::hash(#function_pointer)) })
 
 /// \brief Returns an instance of syscall_function for the given syscall.
 /// \param function_type A function type whose name matches the corresponding syscall.
-#define INLINE_SYSCALL_T(function_type)                                    \
-    ::jm::syscall_function<function_type>                                  \
-    {                                                                      \
-        ::jm::detail::syscall_holder<::jm::hash(#function_type)>::entry.id \
-    }
+/// \note On linux syscalls that the vDSO implements call it instead.
+#define INLINE_SYSCALL_T(function_type)                      \
+    ::jm::detail::route_syscall<::jm::hash(#function_type)>( \
+        ::jm::syscall_function<function_type>{               \
+            JM_INLINE_SYSCALL_FUNCTION_ARGS(::jm::hash(#function_type)) })
 
 /// \brief Returns an instance of syscall_function for the given syscall id.
 /// \param function_pointer A function pointer whose type matches the corresponding syscall.
 /// \param syscall_id The id of the syscall specified by function_pointer.
 /// \note There is no INLINE_SYSCALL_MANUAL_T because you can just write
 ///       jm::inline_syscall<function_type>{id}
-#define INLINE_SYSCALL_MANUAL(function_pointer, syscall_id) \
-    ::jm::syscall_function<decltype(function_pointer)> { syscall_id }
+/// \note Syscalls made through this macro are not counted by JM_INLINE_SYSCALL_STATS
+///       nor traced by JM_INLINE_SYSCALL_TRACE.
+#define INLINE_SYSCALL_MANUAL(function_pointer, syscall_id)     \
+    decltype(::jm::detail::syscall_function_of(function_pointer)) \
+    {                                                             \
+        syscall_id                                                \
+    }
+
+/// \brief Makes the id of the given syscall a compile time constant.
+///        INLINE_SYSCALL and INLINE_SYSCALL_T will then use it as an immediate and no
+///        syscall entry will be created for it. Has to be used in the global namespace.
+/// \param name The name of the syscall as passed to INLINE_SYSCALL.
+/// \param syscall_id The id of the syscall on the targeted build.
+#define JM_INLINE_SYSCALL_CONSTANT(name, syscall_id)            \
+    template<>                                                  \
+    struct jm::syscall_constant<::jm::hash(#name)> {            \
+        static constexpr std::uint32_t value = (syscall_id);    \
+    }
+
+/// \brief Declares which memory the given syscall accesses, so that INLINE_SYSCALL and
+///        INLINE_SYSCALL_T don't have to tell the compiler that it may access any memory.
+///        Has to be used in the global namespace.
+/// \param name The name of the syscall as passed to INLINE_SYSCALL.
+/// \param ... jm::no_memory_effects, jm::reads_memory<...>, jm::writes_memory<...> or
+///            jm::syscall_effects<...>.
+#define JM_INLINE_SYSCALL_EFFECTS(name, ...)               \
+    template<>                                             \
+    struct jm::syscall_memory_effects<::jm::hash(#name)> { \
+        using type = __VA_ARGS__;                          \
+    }
+
+#if defined(JM_INLINE_SYSCALL_STATS) || defined(JM_INLINE_SYSCALL_TRACE)
+// syscall_function knows which syscall it belongs to
+#define JM_INLINE_SYSCALL_INSTRUMENTED
+#endif
+
+// the arguments that INLINE_SYSCALL constructs syscall_function with
+#if defined(JM_INLINE_SYSCALL_INSTRUMENTED)
+#define JM_INLINE_SYSCALL_FUNCTION_ARGS(name_hash) \
+    ::jm::detail::syscall_id_of<name_hash>(), ::jm::detail::syscall_site_of<name_hash>()
+#else
+#define JM_INLINE_SYSCALL_FUNCTION_ARGS(name_hash) ::jm::detail::syscall_id_of<name_hash>()
+#endif
+
+#if defined(JM_INLINE_SYSCALL_STATS) && !defined(JM_INLINE_SYSCALL_STATS_SHARDS)
+/// \brief The number of shards every syscall_stats_entry is split into. Threads are
+///        assigned to shards round robin, so up to this many threads never write to the
+///        same cache line.
+#define JM_INLINE_SYSCALL_STATS_SHARDS 16
+#endif
+
+#if defined(JM_INLINE_SYSCALL_TRACE)
+#ifndef JM_INLINE_SYSCALL_TRACE_ARGS
+/// \brief The number of arguments that are stored in every syscall_trace_record.
+#define JM_INLINE_SYSCALL_TRACE_ARGS 6
+#endif
+
+#ifndef JM_INLINE_SYSCALL_TRACE_RING_SIZE
+/// \brief The number of records in the trace ring of every thread. Has to be a power
+///        of two.
+#define JM_INLINE_SYSCALL_TRACE_RING_SIZE 1024
+#endif
+#endif
 
 #ifndef JM_INLINE_SYSCALL_ENTRY_TYPE
 /// \brief The default syscall entry type is small which doesn't allow retrying
@@ -54,10 +118,150 @@ namespace jm {
     template<class Fn>
     class syscall_function;
 
+#if defined(JM_INLINE_SYSCALL_STATS)
+    /// \brief The number of calls and the latency histogram of a syscall.
+    struct syscall_stats_summary {
+        // the number of histogram buckets. The last bucket also counts all slower calls.
+        static constexpr std::size_t buckets = 32;
+
+        // the hash of syscall function name.
+        std::uint32_t hash = 0;
+
+        std::uint64_t calls = 0;
+
+        // the sum of the latencies of all calls in cycles.
+        std::uint64_t cycles = 0;
+
+        // histogram[i] is the number of calls that took [2^i, 2^(i+1)) cycles.
+        std::uint64_t histogram[buckets] = {};
+    };
+
+    /// \brief Counters of a syscall that are updated on every call by INLINE_SYSCALL when
+    ///        JM_INLINE_SYSCALL_STATS is defined. They are stored in their own section
+    ///        next to the syscall entries.
+    struct syscall_stats_entry {
+        struct alignas(64) shard {
+            std::uint64_t calls                                 = 0;
+            std::uint64_t cycles                                = 0;
+            std::uint64_t histogram[syscall_stats_summary::buckets] = {};
+        };
+
+        // the hash of syscall function name.
+        std::uint32_t hash = 0;
+
+        // the next entry in the list returned by syscall_stats().
+        syscall_stats_entry* next = nullptr;
+
+        shard shards[JM_INLINE_SYSCALL_STATS_SHARDS] = {};
+
+        constexpr syscall_stats_entry(std::uint32_t hash) noexcept;
+
+        /// \brief Records a call that took the given number of cycles in the shard of
+        ///        the current thread.
+        /// \note The counters are not incremented atomically, so if more threads than
+        ///       there are shards make the same syscall concurrently some calls might not
+        ///       be counted.
+        inline void record(std::uint64_t cycles) noexcept;
+
+        /// \brief Sums up the counters of all shards.
+        inline syscall_stats_summary summary() const noexcept;
+    };
+#endif
+
+#if defined(JM_INLINE_SYSCALL_TRACE)
+    /// \brief A single syscall recorded by JM_INLINE_SYSCALL_TRACE.
+    struct syscall_trace_record {
+        // the hash of syscall function name.
+        std::uint32_t hash;
+
+        std::uint32_t id;
+
+        // the arguments widened to 64 bits. Missing arguments are zero.
+        std::uint64_t args[JM_INLINE_SYSCALL_TRACE_ARGS];
+
+        std::int64_t status;
+
+        // the timestamp counter right before and after the syscall.
+        std::uint64_t start;
+        std::uint64_t end;
+    };
+
+    /// \brief Single producer ring of trace records that belongs to a thread.
+    ///        The thread overwrites the oldest records when the ring is full and never
+    ///        waits for the reader.
+    class syscall_trace_ring {
+        struct slot {
+            // 2 * (index + 1) once the record with the given index is written, odd while
+            // it is being written.
+            std::uint64_t        sequence = 0;
+            syscall_trace_record record;
+        };
+
+        static_assert((JM_INLINE_SYSCALL_TRACE_RING_SIZE &
+                       (JM_INLINE_SYSCALL_TRACE_RING_SIZE - 1)) == 0,
+                      "JM_INLINE_SYSCALL_TRACE_RING_SIZE has to be a power of two");
+
+        alignas(64) std::uint64_t _head = 0;
+        alignas(64) std::uint64_t _tail = 0;
+
+        // set when the owning thread exits so that the ring can be reused.
+        bool _retired = false;
+
+        slot _slots[JM_INLINE_SYSCALL_TRACE_RING_SIZE];
+
+    public:
+        /// \brief A number that identifies the thread the ring belongs to. A ring of
+        ///        an exited thread is reused by a new thread under a new number.
+        std::uint32_t thread = 0;
+
+        // the next ring in the list returned by syscall_trace_rings().
+        syscall_trace_ring* next = nullptr;
+
+        /// \brief Appends a record. Only called by the owning thread.
+        inline void push(const syscall_trace_record& record) noexcept;
+
+        /// \brief Copies the oldest unread records into the given buffer and returns
+        ///        their number. Only one thread can read a ring at a time.
+        /// \param lost Incremented by the number of records that were overwritten
+        ///             before they could be read.
+        inline std::size_t pop(syscall_trace_record* records,
+                               std::size_t           capacity,
+                               std::uint64_t&        lost) noexcept;
+
+        /// \brief Marks the ring as free once the owning thread has exited and every
+        ///        record has been read. Returns true if it was.
+        inline bool try_acquire(std::uint32_t thread) noexcept;
+
+        inline void retire() noexcept;
+    };
+
+    /// \brief Returns the first ring of the list of trace rings of all threads that
+    ///        made a traced syscall. The rest are linked through syscall_trace_ring::next.
+    ///        Rings are never freed so the list can be walked at any time.
+    inline syscall_trace_ring* syscall_trace_rings() noexcept;
+#endif
+
+    namespace detail {
+
+#if defined(JM_INLINE_SYSCALL_INSTRUMENTED)
+        // identifies the syscall that an instrumented syscall_function belongs to.
+        struct syscall_site {
+            std::uint32_t hash = 0;
+#if defined(JM_INLINE_SYSCALL_STATS)
+            syscall_stats_entry* stats = nullptr;
+#endif
+        };
+#endif
+
+    } // namespace detail
+
     /// \brief A light wrapper around the syscall to provide some type safety.
     template<class R, class... Args>
     class syscall_function<R(Args...)> {
         std::uint32_t _id = 0;
+#if defined(JM_INLINE_SYSCALL_INSTRUMENTED)
+        detail::syscall_site _site;
+#endif
 
     public:
         /// \brief Initializes the syscall with zero id
@@ -66,10 +270,42 @@ namespace jm {
         /// \brief initializes syscall function with given id
         constexpr syscall_function(std::uint32_t id) noexcept : _id(id) {}
 
+#if defined(JM_INLINE_SYSCALL_INSTRUMENTED)
+        /// \brief initializes syscall function with given id whose calls are counted
+        ///        and traced as the given syscall.
+        constexpr syscall_function(std::uint32_t id, detail::syscall_site site) noexcept
+            : _id(id), _site(site)
+        {}
+#endif
+
         /// \brief Performs a syscall with the given arguments
         inline R operator()(Args... args) const noexcept;
+
+    protected:
+        // performs a syscall that accesses only the memory described by Effects, or any
+        // memory if Effects is void.
+        template<class Effects>
+        inline R call(Args... args) const noexcept;
+    };
+
+    /// \brief Allows using the type of functions that are declared noexcept (like the
+    ///        libc wrappers in C++17).
+    template<class R, class... Args>
+    class syscall_function<R(Args...) noexcept> : public syscall_function<R(Args...)> {
+    public:
+        using syscall_function<R(Args...)>::syscall_function;
     };
 
+    namespace detail {
+
+        // deduces the type of syscall_function from a function or function pointer.
+        // Spelling out decltype(function) as a template argument makes GCC warn about
+        // ignored attributes on libc functions, deduction doesn't.
+        template<class Fn>
+        syscall_function<Fn> syscall_function_of(Fn*) noexcept;
+
+    } // namespace detail
+
     /// \brief Holds syscall id and syscall function name hash.
     ///        As such it is possible to retry initialization.
     struct syscall_entry_full {
@@ -90,12 +326,109 @@ namespace jm {
         std::uint32_t hash;
     };
 
+    /// \brief Holds syscall id and syscall function name hash.
+    ///        The id is resolved the first time the syscall is used instead of during
+    ///        initialization, so only the syscalls that are actually used are resolved.
+    /// \note On windows in_memory_init.hpp has to be included wherever INLINE_SYSCALL is
+    ///       used as it provides the resolve_syscall_entry function. Initialization
+    ///       is still possible and resolves every entry up front.
+    struct syscall_entry_lazy {
+        // the id of syscall entries that weren't resolved yet.
+        static constexpr std::uint32_t unresolved = 0xFFFFFFFF;
+
+        // the syscall id that is resolved on first use.
+        std::uint32_t id = unresolved;
+
+        // the hash of syscall function name.
+        std::uint32_t hash = 0;
+
+        constexpr syscall_entry_lazy() noexcept = default;
+        constexpr syscall_entry_lazy(std::uint32_t hash) noexcept;
+    };
+
+    /// \brief Holds only syscall id. The hash of syscall function name is stored in a
+    ///        parallel section returned by syscall_hashes(), so the ids are densely
+    ///        packed and the hashes are never overwritten, which allows retrying
+    ///        initialization. Once it succeeded the memory of the hashes can be given
+    ///        back to the system with release_syscall_hashes().
+    struct syscall_entry_split {
+        // the syscall id that has to be changed during initialization.
+        std::uint32_t id = 0;
+    };
+
+    /// \brief Provides compile time ids of syscalls by their hash through the value
+    ///        member. Syscalls that have no specialization are resolved at runtime.
+    /// \note On linux every known syscall has a constant id when
+    ///       JM_INLINE_SYSCALL_CONSTANT_IDS is defined.
+    template<std::uint32_t Hash, class = void>
+    struct syscall_constant {};
+
+    /// \brief Describes the memory that a syscall accesses through its pointer arguments.
+    /// \param Reads The std::index_sequence of the arguments through which the syscall
+    ///              reads memory.
+    /// \param Writes The std::index_sequence of the arguments through which the syscall
+    ///               writes (and possibly reads) memory.
+    /// \note Only the memory that the arguments point to directly is covered, pointers
+    ///       stored in that memory are not followed. At most 4 arguments can be read
+    ///       through and 4 written through.
+    template<class Reads = std::index_sequence<>, class Writes = std::index_sequence<>>
+    struct syscall_effects {
+        using reads  = Reads;
+        using writes = Writes;
+    };
+
+    /// \brief The syscall accesses no memory at all, like getpid or sched_yield.
+    using no_memory_effects = syscall_effects<>;
+
+    /// \brief The syscall only reads memory through the arguments with given indices.
+    template<std::size_t... Is>
+    using reads_memory = syscall_effects<std::index_sequence<Is...>>;
+
+    /// \brief The syscall only writes memory through the arguments with given indices.
+    template<std::size_t... Is>
+    using writes_memory = syscall_effects<std::index_sequence<>, std::index_sequence<Is...>>;
+
+    /// \brief Provides the memory effects of syscalls by their hash through the type
+    ///        member. Syscalls that have no specialization may access any memory.
+    template<std::uint32_t Hash, class = void>
+    struct syscall_memory_effects {};
+
     /// \brief Returns syscall entry array.
-    /// \note The last entry _should_ be zeroed.
+    /// \note Entries with zero hash are padding and have to be skipped.
     inline JM_INLINE_SYSCALL_ENTRY_TYPE* syscall_entries() noexcept;
 
+    /// \brief Returns the end of syscall entry array.
+    inline JM_INLINE_SYSCALL_ENTRY_TYPE* syscall_entries_end() noexcept;
+
+    /// \brief Returns the array of syscall function name hashes of split syscall entries.
+    ///        hashes[i] is the hash of syscall_entries()[i].
+    template<class Entry = JM_INLINE_SYSCALL_ENTRY_TYPE>
+    inline const std::uint32_t* syscall_hashes() noexcept;
+
+    /// \brief Lets the system page out the hashes of split syscall entries. They aren't
+    ///        read by INLINE_SYSCALL, so they don't need to stay resident after
+    ///        initialization. Their contents are preserved, so initialization can still
+    ///        be retried afterwards, just slower.
+    /// \note Only whole pages of the hashes are released. On windows this makes the
+    ///       NtUnlockVirtualMemory syscall, so it must be called after initialization.
+    template<class Entry = JM_INLINE_SYSCALL_ENTRY_TYPE>
+    inline void release_syscall_hashes() noexcept;
+
+#if defined(JM_INLINE_SYSCALL_STATS)
+    /// \brief Returns the first entry of the list of statistics of every syscall used
+    ///        by INLINE_SYSCALL. The rest are linked through syscall_stats_entry::next.
+    /// \note Entries are added by dynamic initializers, so the list is only complete
+    ///       once static initialization is done.
+    inline syscall_stats_entry* syscall_stats() noexcept;
+
+    /// \brief Returns the statistics of syscall with the given hash, which can be
+    ///        obtained from the name with jm::hash, or nullptr if the syscall is not
+    ///        used anywhere.
+    inline const syscall_stats_entry* find_syscall_stats(std::uint32_t hash) noexcept;
+#endif
+
     /// \brief Hashes the given function name.
-    /// \note Skips first 2 characters (Nt/Zw) to avoid creating duplicate entries.
+    /// \note Skips the Nt/Zw prefix if there is one to avoid creating duplicate entries.
     inline constexpr std::uint32_t hash(const char* str) noexcept;
 
 } // namespace jm
@@ -18,16 +18,32 @@
 #define JM_INLINE_SYSCALL_INL
 
 #include "inline_syscall.hpp"
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#if defined(__linux__)
+#include <asm/unistd.h>
+#endif
+
+#if defined(JM_INLINE_SYSCALL_INSTRUMENTED)
+#include <atomic>
+#endif
+
+#if defined(JM_INLINE_SYSCALL_TRACE)
+#include <new>
+#endif
 
 #if defined(_MSC_VER)
 #define JM_INLINE_SYSCALL_FORCEINLINE __forceinline
 #else
-#define JM_INLINE_SYSCALL_FORCEINLINE __attribute__((always_inline))
+#define JM_INLINE_SYSCALL_FORCEINLINE inline __attribute__((always_inline))
 #endif
 
 // helper macro to reduce the typing a bit
 #define JM_INLINE_SYSCALL_STUB(...) \
-    JM_INLINE_SYSCALL_FORCEINLINE std::int32_t syscall(__VA_ARGS__) noexcept
+    JM_INLINE_SYSCALL_FORCEINLINE ::jm::detail::syscall_status syscall(__VA_ARGS__) noexcept
 
 namespace jm {
 
@@ -36,7 +52,9 @@ namespace jm {
     {
         std::uint32_t value = 2166136261;
 
-        str += 2;
+        if((str[0] == 'N' && str[1] == 't') || (str[0] == 'Z' && str[1] == 'w'))
+            str += 2;
+
         for(;;) {
             const char c = *str++;
             if(!c)
@@ -50,532 +68,1555 @@ namespace jm {
         : hash(hash_)
     {}
 
+    constexpr syscall_entry_lazy::syscall_entry_lazy(std::uint32_t hash_) noexcept
+        : hash(hash_)
+    {}
+
+#if defined(JM_INLINE_SYSCALL_STATS)
+    constexpr syscall_stats_entry::syscall_stats_entry(std::uint32_t hash_) noexcept
+        : hash(hash_)
+    {}
+#endif
+
     namespace detail {
 
+#if defined(__linux__)
+        // the raw return value of linux syscalls which is either a result or -errno
+        using syscall_status = long;
+
+        struct linux_syscall {
+            std::uint32_t hash;
+            std::uint32_t number;
+        };
+
+#define JM_INLINE_SYSCALL_LINUX_SYSCALL(name) { ::jm::hash(#name), __NR_##name },
+        inline constexpr linux_syscall linux_syscalls[] = {
+#include "linux_syscalls.inl"
+        };
+#undef JM_INLINE_SYSCALL_LINUX_SYSCALL
+
+        inline constexpr bool is_linux_syscall(std::uint32_t hash) noexcept
+        {
+            for(const auto& entry : linux_syscalls)
+                if(entry.hash == hash)
+                    return true;
+
+            return false;
+        }
+
+        // the id of names that aren't linux syscalls, which the kernel rejects with ENOSYS
+        constexpr std::uint32_t unknown_linux_syscall = 0xFFFFFFFF;
+
+        // returns the syscall number for the given name hash or unknown_linux_syscall if
+        // there is no syscall with such name (it might be a windows syscall that gets
+        // resolved from an ntdll image).
+        inline constexpr std::uint32_t linux_syscall_number(std::uint32_t hash) noexcept
+        {
+            for(const auto& entry : linux_syscalls)
+                if(entry.hash == hash)
+                    return entry.number;
+
+            return unknown_linux_syscall;
+        }
+#else
+        // the raw return value of windows syscalls which is NTSTATUS
+        using syscall_status = std::int32_t;
+#endif
+
+#if defined(__linux__) && defined(JM_INLINE_SYSCALL_CONSTANT_IDS)
+    } // namespace detail
+
+    template<std::uint32_t Hash>
+    struct syscall_constant<Hash, std::enable_if_t<detail::is_linux_syscall(Hash)>> {
+        static constexpr std::uint32_t value = detail::linux_syscall_number(Hash);
+    };
+
+    namespace detail {
+#endif
+
+        // Creates syscall entry for the given hash.
+        // Linux syscall numbers are a stable ABI so they are filled in at compile time.
+        template<class Entry>
+        inline constexpr Entry make_syscall_entry(std::uint32_t hash) noexcept
+        {
+            // split entries don't hold the hash, syscall_hash_holder does
+            Entry entry{};
+            if constexpr(!std::is_same_v<Entry, syscall_entry_split>)
+                entry = Entry{ hash };
+#if defined(__linux__)
+            // small entries with other names keep their hash in place of the id, so that
+            // they can still be resolved at runtime.
+            if(is_linux_syscall(hash) || !std::is_same_v<Entry, syscall_entry_small>)
+                entry.id = linux_syscall_number(hash);
+#endif
+            return entry;
+        }
+
+        // the alignment of syscall entry. The zero entry of split ones aligns their section
+        // to a cache line so that the ids take up as few of them as possible.
+        template<class Entry>
+        inline constexpr std::size_t syscall_entry_alignment(std::uint32_t hash) noexcept
+        {
+            if(std::is_same_v<Entry, syscall_entry_split> && hash == 0)
+                return 64;
+
+            return alignof(Entry);
+        }
+
+// the sections of syscall entries and of the hashes of split entries. COFF has no
+// symbols for the bounds of a section, so there they are surrounded by markers in
+// grouped sections, which the linker orders by the part after $.
+#if defined(__ELF__)
+#define JM_INLINE_SYSCALL_ENTRY_SECTION "_sysc"
+#define JM_INLINE_SYSCALL_HASH_SECTION "_sysh"
+#else
+#define JM_INLINE_SYSCALL_ENTRY_SECTION "_sysc$m"
+#define JM_INLINE_SYSCALL_HASH_SECTION "_sysh$m"
+#endif
+
+        // stores the hashes of split syscall entries in a section parallel to the entries.
+        // Aligned like the entries so that both sections get the same padding, which
+        // syscall_entries_in_section checks.
+        template<std::uint32_t Hash, class Entry>
+        struct syscall_hash_holder {};
+
+        template<std::uint32_t Hash>
+        struct syscall_hash_holder<Hash, syscall_entry_split> {
+            [[gnu::section(JM_INLINE_SYSCALL_HASH_SECTION), gnu::used, gnu::retain]] alignas(
+                syscall_entry_alignment<syscall_entry_split>(
+                    Hash)) inline static const std::uint32_t hash = Hash;
+        };
+
+#if defined(JM_INLINE_SYSCALL_STATS)
+        inline syscall_stats_entry* syscall_stats_list = nullptr;
+
+        inline bool register_syscall_stats(syscall_stats_entry& entry) noexcept
+        {
+            // syscall_holder<0> is not a syscall
+            if(entry.hash == 0)
+                return false;
+
+            entry.next         = syscall_stats_list;
+            syscall_stats_list = &entry;
+            return true;
+        }
+#endif
+
         // stores syscall info in a section that we create
         // Because we store it in its own section we can initialize all values like an
         // array
         template<std::uint32_t Hash>
-        struct syscall_holder {
-            [[gnu::section(
-                "_sysc"), gnu::retain]] inline static JM_INLINE_SYSCALL_ENTRY_TYPE entry{ Hash };
+        struct syscall_holder : syscall_hash_holder<Hash, JM_INLINE_SYSCALL_ENTRY_TYPE> {
+            [[gnu::section(JM_INLINE_SYSCALL_ENTRY_SECTION), gnu::retain]] alignas(
+                syscall_entry_alignment<JM_INLINE_SYSCALL_ENTRY_TYPE>(
+                    Hash)) inline static JM_INLINE_SYSCALL_ENTRY_TYPE entry =
+                make_syscall_entry<JM_INLINE_SYSCALL_ENTRY_TYPE>(Hash);
+
+#if defined(JM_INLINE_SYSCALL_STATS)
+            // the statistics live in a parallel section so that they don't spread the
+            // entries over more cache lines.
+            [[gnu::section("_sysst")]] inline static syscall_stats_entry stats{ Hash };
+
+            // adds the statistics to the list. GCC ignores section attributes of
+            // template members, so the section can't be walked like the entries are.
+            inline static const bool stats_registered = register_syscall_stats(stats);
+#endif
         };
 
-        // we instantiate the first entry with 0 hash to be able to get a pointer
+        // an entry with 0 hash which is skipped like padding. It only aligns the sections
+        // of split entries to a cache line.
         template struct syscall_holder<0>;
+        template struct syscall_hash_holder<0, JM_INLINE_SYSCALL_ENTRY_TYPE>;
+
+#if defined(__ELF__)
+        // defined by the linker around the sections of the binary. Weak because the
+        // sections don't exist if no syscall entries are placed in them.
+        extern "C" [[gnu::weak, gnu::visibility("hidden")]] JM_INLINE_SYSCALL_ENTRY_TYPE
+            __start__sysc[];
+        extern "C" [[gnu::weak, gnu::visibility("hidden")]] JM_INLINE_SYSCALL_ENTRY_TYPE
+            __stop__sysc[];
+        extern "C" [[gnu::weak, gnu::visibility("hidden")]] const std::uint32_t
+            __start__sysh[];
+        extern "C" [[gnu::weak, gnu::visibility("hidden")]] const std::uint32_t
+            __stop__sysh[];
+
+        inline JM_INLINE_SYSCALL_ENTRY_TYPE* first_syscall_entry() noexcept
+        {
+            return __start__sysc;
+        }
+        inline JM_INLINE_SYSCALL_ENTRY_TYPE* last_syscall_entry() noexcept
+        {
+            return __stop__sysc;
+        }
+        inline const std::uint32_t* first_syscall_hash() noexcept { return __start__sysh; }
+        inline const std::uint32_t* last_syscall_hash() noexcept { return __stop__sysh; }
+#else
+        [[gnu::section("_sysc$a")]] inline JM_INLINE_SYSCALL_ENTRY_TYPE syscall_entries_begin{};
+        [[gnu::section("_sysc$z")]] inline JM_INLINE_SYSCALL_ENTRY_TYPE syscall_entries_end{};
+        [[gnu::section("_sysh$a")]] inline const std::uint32_t syscall_hashes_begin = 0;
+        [[gnu::section("_sysh$z")]] inline const std::uint32_t syscall_hashes_end   = 0;
 
-        // disables register keyword deprecation warnings
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wregister"
+        inline JM_INLINE_SYSCALL_ENTRY_TYPE* first_syscall_entry() noexcept
+        {
+            return &syscall_entries_begin + 1;
+        }
+        inline JM_INLINE_SYSCALL_ENTRY_TYPE* last_syscall_entry() noexcept
+        {
+            return &syscall_entries_end;
+        }
+        inline const std::uint32_t* first_syscall_hash() noexcept
+        {
+            return &syscall_hashes_begin + 1;
+        }
+        inline const std::uint32_t* last_syscall_hash() noexcept
+        {
+            return &syscall_hashes_end;
+        }
+#endif
 
-        /* syscall stubs begin here.
-         *
-         * They all seem more or less the same and that's true, however
-         * we need them like this for best possible code generation.
-         */
+        // returns false if the compiler didn't place the syscall entries in their section.
+        // GCC ignores section attributes of template members, which leaves the entries
+        // scattered over the data section and the range of syscall_entries() empty.
+        // syscall_holder<0> is instantiated by every binary, so its entry is always there.
+        inline bool syscall_entries_in_section() noexcept
+        {
+            const auto zero  = reinterpret_cast<std::uintptr_t>(&syscall_holder<0>::entry);
+            const auto first = reinterpret_cast<std::uintptr_t>(first_syscall_entry());
+            const auto last  = reinterpret_cast<std::uintptr_t>(last_syscall_entry());
+            if(zero < first || zero >= last)
+                return false;
+
+            // split entries find their hashes by index, so the linker has to have laid
+            // out both sections alike. The zero entry and its hash are cache line
+            // aligned, so different padding before them would also move them apart.
+            if constexpr(std::is_same_v<JM_INLINE_SYSCALL_ENTRY_TYPE, syscall_entry_split>) {
+                const auto zero_hash = &syscall_hash_holder<0, syscall_entry_split>::hash;
+                return last_syscall_hash() - first_syscall_hash() ==
+                           last_syscall_entry() - first_syscall_entry() &&
+                       zero_hash - first_syscall_hash() ==
+                           &syscall_holder<0>::entry - first_syscall_entry();
+            }
+            return true;
+        }
 
-        JM_INLINE_SYSCALL_STUB(std::uint32_t id)
+        // returns the id stored in syscall entry.
+        template<class Entry>
+        JM_INLINE_SYSCALL_FORCEINLINE std::uint32_t syscall_id(Entry& entry) noexcept
         {
-            register void* a1 asm("r10");
-            void*          a2;
-            register void* a3 asm("r8");
-            register void* a4 asm("r9");
+            return entry.id;
+        }
 
-            void*          unused_output;
-            register void* unused_output2 asm("r11");
+#if !defined(__linux__)
+        // returns the id stored in lazy syscall entry resolving it on first use.
+        // resolve_syscall_entry is found through ADL so it can be defined after this.
+        // Linux ids are filled in by make_syscall_entry, so there nothing is resolved.
+        template<class Entry = syscall_entry_lazy>
+        JM_INLINE_SYSCALL_FORCEINLINE std::uint32_t syscall_id(syscall_entry_lazy& entry) noexcept
+        {
+            const auto id = __atomic_load_n(&entry.id, __ATOMIC_RELAXED);
+            if(__builtin_expect(id == syscall_entry_lazy::unresolved, 0))
+                return resolve_syscall_entry(static_cast<Entry&>(entry));
 
-            std::int32_t status;
-            asm volatile("syscall\n"
-                         : "=a"(status),
-                           "=r"(a1),
-                           "=d"(a2),
-                           "=r"(a3),
-                           "=r"(a4),
-                           "=c"(unused_output),
-                           "=r"(unused_output2)
-                         : "a"(id)
-                         : "memory", "cc");
-            return status;
+            return id;
         }
+#endif
 
-        template<class T1>
-        JM_INLINE_SYSCALL_STUB(std::uint32_t id, T1 _1)
+#if defined(JM_INLINE_SYSCALL_STATS)
+        // returns the statistics entry of syscall with the given hash. Syscalls with
+        // constant ids have one as well.
+        template<std::uint32_t Hash>
+        JM_INLINE_SYSCALL_FORCEINLINE syscall_stats_entry* syscall_stats_of() noexcept
         {
-            register auto  a1 asm("r10") = _1;
-            void*          a2;
-            register void* a3 asm("r8");
-            register void* a4 asm("r9");
+            // instantiates the registration without generating any code
+            static_cast<void>(&syscall_holder<Hash>::stats_registered);
+            return &syscall_holder<Hash>::stats;
+        }
 
-            void*          unused_output;
-            register void* unused_output2 asm("r11");
+        // the index of statistics shard of the current thread plus one or zero if it
+        // wasn't assigned yet. Constant initialized so that accessing it needs no guard.
+        inline thread_local std::uint32_t stats_shard = 0;
 
-            std::int32_t status;
-            asm volatile("syscall\n"
-                         : "=a"(status),
-                           "=r"(a1),
-                           "=d"(a2),
-                           "=r"(a3),
-                           "=r"(a4),
-                           "=c"(unused_output),
-                           "=r"(unused_output2)
-                         : "a"(id), "r"(a1)
-                         : "memory", "cc");
-            return status;
+        inline std::atomic<std::uint32_t> stats_shard_counter{ 0 };
+
+        JM_INLINE_SYSCALL_FORCEINLINE std::uint32_t current_stats_shard() noexcept
+        {
+            auto shard = stats_shard;
+            if(__builtin_expect(shard == 0, 0))
+                stats_shard = shard =
+                    stats_shard_counter.fetch_add(1, std::memory_order_relaxed) %
+                        JM_INLINE_SYSCALL_STATS_SHARDS +
+                    1;
+
+            return shard - 1;
         }
+#endif
 
-        template<class T1, class T2>
-        JM_INLINE_SYSCALL_STUB(std::uint32_t id, T1 _1, T2 _2)
+#if defined(JM_INLINE_SYSCALL_TRACE)
+        inline std::atomic<syscall_trace_ring*> trace_rings{ nullptr };
+
+        inline std::atomic<std::uint32_t> trace_thread_counter{ 0 };
+
+        // the trace ring of the current thread. Constant initialized so that accessing it
+        // needs no guard.
+        inline thread_local syscall_trace_ring* current_trace_ring = nullptr;
+
+        // retires the trace ring when the thread exits
+        struct trace_ring_owner {
+            syscall_trace_ring* ring = nullptr;
+
+            ~trace_ring_owner()
+            {
+                if(ring)
+                    ring->retire();
+            }
+        };
+
+        inline thread_local trace_ring_owner trace_owner;
+
+        // reuses the ring of an exited thread or allocates a new one.
+        [[gnu::cold, gnu::noinline]] inline syscall_trace_ring* acquire_trace_ring() noexcept
         {
-            register auto  a1 asm("r10") = _1;
-            register void* a3 asm("r8");
-            register void* a4 asm("r9");
+            const auto thread = trace_thread_counter.fetch_add(1, std::memory_order_relaxed) + 1;
+
+            auto ring = trace_rings.load(std::memory_order_acquire);
+            for(; ring; ring = ring->next)
+                if(ring->try_acquire(thread))
+                    break;
+
+            if(!ring) {
+                ring = new(std::nothrow) syscall_trace_ring;
+                if(!ring)
+                    return nullptr;
+
+                ring->thread = thread;
+                ring->next   = trace_rings.load(std::memory_order_relaxed);
+                while(!trace_rings.compare_exchange_weak(
+                    ring->next, ring, std::memory_order_release, std::memory_order_relaxed)) {}
+            }
+
+            trace_owner.ring   = ring;
+            current_trace_ring = ring;
+            return ring;
+        }
 
-            void*          unused_output;
-            register void* unused_output2 asm("r11");
+        // widens the argument to a 64 bit trace record argument.
+        template<class T>
+        JM_INLINE_SYSCALL_FORCEINLINE std::uint64_t trace_arg(T value) noexcept
+        {
+            if constexpr(std::is_pointer_v<T>)
+                return reinterpret_cast<std::uintptr_t>(value);
+            else if constexpr(std::is_integral_v<T> || std::is_enum_v<T>)
+                return static_cast<std::uint64_t>(value);
+            else
+                return 0;
+        }
 
-            std::int32_t status;
-            asm volatile("syscall\n"
-                         : "=a"(status),
-                           "=r"(a1),
-                           "=d"(_2),
-                           "=r"(a3),
-                           "=r"(a4),
-                           "=c"(unused_output),
-                           "=r"(unused_output2)
-                         : "a"(id), "r"(a1), "d"(_2)
-                         : "memory", "cc");
-            return status;
+        // appends a record of the syscall to the trace ring of the current thread.
+        template<class... Ts>
+        inline void trace(std::uint32_t  hash,
+                          std::uint32_t  id,
+                          std::int64_t   status,
+                          std::uint64_t  start,
+                          std::uint64_t  end,
+                          Ts... args) noexcept
+        {
+            auto ring = current_trace_ring;
+            if(__builtin_expect(!ring, 0)) {
+                ring = acquire_trace_ring();
+                if(!ring)
+                    return;
+            }
+
+            syscall_trace_record record;
+            record.hash   = hash;
+            record.id     = id;
+            record.status = status;
+            record.start  = start;
+            record.end    = end;
+
+            std::size_t i = 0;
+            ((i < JM_INLINE_SYSCALL_TRACE_ARGS ? static_cast<void>(record.args[i++] = trace_arg(args))
+                                               : static_cast<void>(0)),
+             ...);
+            for(; i < JM_INLINE_SYSCALL_TRACE_ARGS; ++i)
+                record.args[i] = 0;
+
+            ring->push(record);
         }
 
-        template<class T1, class T2, class T3>
-        JM_INLINE_SYSCALL_STUB(std::uint32_t id, T1 _1, T2 _2, T3 _3)
+        // copies the record field by field with relaxed atomics so that a reader racing
+        // with the writer never causes undefined behaviour.
+        JM_INLINE_SYSCALL_FORCEINLINE void copy_trace_record(syscall_trace_record&       to,
+                                                             const syscall_trace_record& from) noexcept
         {
-            register auto  a1 asm("r10") = _1;
-            register auto  a3 asm("r8")  = _3;
-            register void* a4 asm("r9");
+            const auto copy = [](auto& to, const auto& from) {
+                __atomic_store_n(&to, __atomic_load_n(&from, __ATOMIC_RELAXED), __ATOMIC_RELAXED);
+            };
+            copy(to.hash, from.hash);
+            copy(to.id, from.id);
+            for(std::size_t i = 0; i < JM_INLINE_SYSCALL_TRACE_ARGS; ++i)
+                copy(to.args[i], from.args[i]);
+            copy(to.status, from.status);
+            copy(to.start, from.start);
+            copy(to.end, from.end);
+        }
+#endif
 
-            void*          unused_output;
-            register void* unused_output2 asm("r11");
+#if defined(JM_INLINE_SYSCALL_INSTRUMENTED)
+        template<std::uint32_t Hash>
+        JM_INLINE_SYSCALL_FORCEINLINE syscall_site syscall_site_of() noexcept
+        {
+            syscall_site site;
+            site.hash = Hash;
+#if defined(JM_INLINE_SYSCALL_STATS)
+            site.stats = syscall_stats_of<Hash>();
+#endif
+            return site;
+        }
 
-            std::int32_t status;
-            asm volatile("syscall\n"
-                         : "=a"(status),
-                           "=r"(a1),
-                           "=d"(_2),
-                           "=r"(a3),
-                           "=r"(a4),
-                           "=c"(unused_output),
-                           "=r"(unused_output2)
-                         : "a"(id), "r"(a1), "d"(_2), "r"(a3)
-                         : "memory", "cc");
-            return status;
+        JM_INLINE_SYSCALL_FORCEINLINE std::uint64_t timestamp() noexcept
+        {
+#if defined(__aarch64__)
+            // the virtual counter, as the cycle counter normally can't be read from EL0
+            std::uint64_t ticks;
+            asm volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+            return ticks;
+#else
+            return __builtin_ia32_rdtsc();
+#endif
         }
+#endif
 
-        template<class T1, class T2, class T3, class T4>
-        JM_INLINE_SYSCALL_STUB(std::uint32_t id, T1 _1, T2 _2, T3 _3, T4 _4)
+        template<std::uint32_t Hash, class = void>
+        struct has_syscall_constant : std::false_type {};
+
+        template<std::uint32_t Hash>
+        struct has_syscall_constant<Hash,
+                                    std::void_t<decltype(syscall_constant<Hash>::value)>>
+            : std::true_type {};
+
+#if defined(JM_INLINE_SYSCALL_PATCHED_IDS)
+#if !defined(__x86_64__)
+#error "JM_INLINE_SYSCALL_PATCHED_IDS is only supported on x86-64"
+#endif
+
+        /* Patched call sites.
+         *
+         * Every call site loads its id with mov eax, imm32 and records where the immediate
+         * is in the _syspt section, which patch_syscall_sites from patch_init.hpp walks.
+         * The offset is relative to the record so that the section needs no relocations.
+         */
+        struct patch_site {
+            std::int32_t  offset;
+            std::uint32_t hash;
+
+            // the id in the immediate until the call site is patched. It is not a valid
+            // syscall on either OS so unpatched calls fail instead of making another one.
+            static constexpr std::uint32_t unpatched = 0xFFFFFFFF;
+
+            std::uint32_t* immediate() const noexcept
+            {
+                return reinterpret_cast<std::uint32_t*>(
+                    const_cast<char*>(reinterpret_cast<const char*>(this)) + offset);
+            }
+        };
+
+#if defined(__ELF__)
+#define JM_INLINE_SYSCALL_PATCH_SECTION "_syspt,\"a\""
+#else
+#define JM_INLINE_SYSCALL_PATCH_SECTION "_syspt$m,\"dr\""
+#endif
+
+        // changed by patch_syscall_sites after it has written the immediates. The call
+        // sites depend on it, so that they aren't moved above patching or hoisted out of
+        // loops that patch, while they still can be hoisted out of any other loop.
+        inline std::uint32_t patch_generation = 0;
+
+        // returns the id from the immediate of a patched call site. Not volatile so that
+        // the compiler is free to hoist it out of loops like any other constant, as long
+        // as patch_generation doesn't change in them.
+        template<std::uint32_t Hash>
+        JM_INLINE_SYSCALL_FORCEINLINE std::uint32_t patched_syscall_id() noexcept
         {
-            register auto a1 asm("r10") = _1;
-            register auto a3 asm("r8")  = _3;
-            register auto a4 asm("r9")  = _4;
+            std::uint32_t id;
+            asm("movl %[unpatched], %[id]\n"
+                "1:\n"
+                ".pushsection " JM_INLINE_SYSCALL_PATCH_SECTION "\n"
+                ".balign 4\n"
+                ".long 1b - 4 - .\n"
+                ".long %c[hash]\n"
+                ".popsection"
+                : [id] "=a"(id)
+                : [unpatched] "i"(patch_site::unpatched),
+                  [hash] "i"(Hash),
+                  "m"(patch_generation));
+            return id;
+        }
+#endif
 
-            void*          unused_output;
-            register void* unused_output2 asm("r11");
+        // returns the id of syscall with the given hash. Constant and patched ids don't
+        // instantiate syscall_holder so they don't take up space in the syscall entry array.
+        template<std::uint32_t Hash>
+        JM_INLINE_SYSCALL_FORCEINLINE std::uint32_t syscall_id_of() noexcept
+        {
+#if defined(__linux__) && !defined(JM_INLINE_SYSCALL_UNKNOWN_NAMES)
+            static_assert(is_linux_syscall(Hash) || has_syscall_constant<Hash>::value,
+                          "not a linux syscall, define JM_INLINE_SYSCALL_UNKNOWN_NAMES to "
+                          "resolve its id at runtime");
+#endif
+            if constexpr(has_syscall_constant<Hash>::value)
+                return syscall_constant<Hash>::value;
+            else {
+#if defined(JM_INLINE_SYSCALL_PATCHED_IDS)
+                return patched_syscall_id<Hash>();
+#else
+                // instantiates the hash next to the entry without generating any code
+                if constexpr(std::is_same_v<JM_INLINE_SYSCALL_ENTRY_TYPE, syscall_entry_split>)
+                    static_cast<void>(&syscall_holder<Hash>::hash);
 
-            std::int32_t status;
-            asm volatile("syscall\n"
-                         : "=a"(status),
-                           "=r"(a1),
-                           "=d"(_2),
-                           "=r"(a3),
-                           "=r"(a4),
-                           "=c"(unused_output),
-                           "=r"(unused_output2)
-                         : "a"(id), "r"(a1), "d"(_2), "r"(a3), "r"(a4)
-                         : "memory", "cc");
-            return status;
+                return syscall_id(syscall_holder<Hash>::entry);
+#endif
+            }
         }
 
-        template<class T1, class T2, class T3, class T4, class T5>
-        JM_INLINE_SYSCALL_STUB(std::uint32_t id, T1 _1, T2 _2, T3 _3, T4 _4, T5 _5)
+        // returns the hash of syscall function name of an entry in syscall_entries().
+        template<class Entry>
+        JM_INLINE_SYSCALL_FORCEINLINE std::uint32_t entry_hash(const Entry* entry) noexcept
         {
-            register auto a1 asm("r10") = _1;
-            register auto a3 asm("r8")  = _3;
-            register auto a4 asm("r9")  = _4;
+            if constexpr(std::is_same_v<Entry, syscall_entry_split>)
+                return syscall_hashes<Entry>()[entry - syscall_entries()];
+            else
+                return entry->hash;
+        }
 
-            void*          unused_output;
-            register void* unused_output2 asm("r11");
+        // returns the argument with the given index.
+        template<std::size_t I, class T, class... Ts>
+        JM_INLINE_SYSCALL_FORCEINLINE auto nth_arg(T first, Ts... rest) noexcept
+        {
+            if constexpr(I == 0)
+                return first;
+            else
+                return nth_arg<I - 1>(rest...);
+        }
 
-            std::int32_t status;
-            asm volatile("sub $48, %%rsp\n"
-                         "movq %[a5], 40(%%rsp)\n"
-                         "syscall\n"
-                         "add $48, %%rsp"
-                         : "=a"(status),
-                           "=r"(a1),
-                           "=d"(_2),
-                           "=r"(a3),
-                           "=r"(a4),
-                           "=c"(unused_output),
-                           "=r"(unused_output2)
-                         : "a"(id),
-                           "r"(a1),
-                           "d"(_2),
-                           "r"(a3),
-                           "r"(a4),
-                           [ a5 ] "re"(reinterpret_cast<void*>(_5))
-                         : "cc");
-            return status;
+        // converts the raw syscall status to the return type of syscall function.
+        template<class R>
+        JM_INLINE_SYSCALL_FORCEINLINE R syscall_result(syscall_status status) noexcept
+        {
+            if constexpr(std::is_void_v<R>)
+                static_cast<void>(status);
+            else if constexpr(std::is_pointer_v<R>)
+                return reinterpret_cast<R>(status);
+            else
+                return static_cast<R>(status);
         }
 
-        template<class T1, class T2, class T3, class T4, class T5, class T6>
-        JM_INLINE_SYSCALL_STUB(std::uint32_t id, T1 _1, T2 _2, T3 _3, T4 _4, T5 _5, T6 _6)
+        // Describes the vDSO function that implements the syscall with the given hash.
+        // Only specialized for such syscalls.
+        template<std::uint32_t Hash>
+        struct vdso_symbol {
+            static constexpr bool available = false;
+        };
+
+        // syscall function that calls the vDSO function instead of making the syscall.
+        template<std::uint32_t Hash, class Fn>
+        class vdso_syscall_function;
+
+        template<class Function>
+        struct syscall_function_traits;
+
+        template<class R, class... Args>
+        struct syscall_function_traits<syscall_function<R(Args...)>> {
+            using type = R(Args...);
+        };
+
+        template<class R, class... Args>
+        struct syscall_function_traits<syscall_function<R(Args...) noexcept>> {
+            using type = R(Args...);
+        };
+
+        template<std::uint32_t Hash, class = void>
+        struct has_syscall_memory_effects : std::false_type {};
+
+        template<std::uint32_t Hash>
+        struct has_syscall_memory_effects<
+            Hash,
+            std::void_t<typename syscall_memory_effects<Hash>::type>> : std::true_type {};
+
+        // syscall function whose syscall accesses only the memory described by Effects.
+        template<class Effects, class Fn>
+        class effects_syscall_function;
+
+        template<class Effects, class R, class... Args>
+        class effects_syscall_function<Effects, R(Args...)>
+            : public syscall_function<R(Args...)> {
+        public:
+            constexpr effects_syscall_function(syscall_function<R(Args...)> function) noexcept
+                : syscall_function<R(Args...)>(function)
+            {}
+
+            JM_INLINE_SYSCALL_FORCEINLINE R operator()(Args... args) const noexcept
+            {
+                return this->template call<Effects>(args...);
+            }
+        };
+
+        // without optimizations every memory operand of the effects takes a register of its
+        // own, which the stubs with more than 3 arguments don't have left, and there is
+        // nothing to be gained from them anyway.
+#if defined(__OPTIMIZE__)
+        constexpr bool memory_effects_enabled = true;
+#else
+        constexpr bool memory_effects_enabled = false;
+#endif
+
+        // returns the syscall function that INLINE_SYSCALL uses for the syscall with the
+        // given hash. That is the given one unless there is a vDSO function for it or its
+        // memory effects are known.
+        template<std::uint32_t Hash, class Function>
+        JM_INLINE_SYSCALL_FORCEINLINE auto route_syscall(Function function) noexcept
         {
-            register auto a1 asm("r10") = _1;
-            register auto a3 asm("r8")  = _3;
-            register auto a4 asm("r9")  = _4;
+            using type = typename syscall_function_traits<Function>::type;
+
+            if constexpr(vdso_symbol<Hash>::available)
+                return vdso_syscall_function<Hash, type>(function);
+            else if constexpr(memory_effects_enabled &&
+                              has_syscall_memory_effects<Hash>::value)
+                return effects_syscall_function<
+                    typename syscall_memory_effects<Hash>::type, type>(function);
+            else
+                return function;
+        }
 
-            void*          unused_output;
-            register void* unused_output2 asm("r11");
+        /* memory effects.
+         *
+         * Unless the effects of a syscall are known its stub clobbers all memory. Otherwise
+         * the memory that it reads and writes through its arguments is bound as "m" and
+         * "+m" operands of unknown size instead, so values that live in registers or in
+         * memory that the syscall can't reach survive the call. The number of operands is
+         * fixed, so slots without an argument name unaccessed_memory.
+         */
 
-            std::int32_t status;
-            asm volatile("sub $64, %%rsp\n"
-                         "movq %[a5], 40(%%rsp)\n"
-                         "movq %[a6], 48(%%rsp)\n"
-                         "syscall\n"
-                         "add $64, %%rsp"
-                         : "=a"(status),
-                           "=r"(a1),
-                           "=d"(_2),
-                           "=r"(a3),
-                           "=r"(a4),
-                           "=c"(unused_output),
-                           "=r"(unused_output2)
-                         : "a"(id),
-                           "r"(a1),
-                           "d"(_2),
-                           "r"(a3),
-                           "r"(a4),
-                           [ a5 ] "re"(reinterpret_cast<void*>(_5)),
-                           [ a6 ] "re"(reinterpret_cast<void*>(_6))
-                         : "memory", "cc");
-            return status;
+        constexpr std::size_t memory_effect_slots = 4;
+
+        // named by the memory operands of slots without an argument. Never accessed.
+        inline char unaccessed_memory;
+
+        // the memory accessed through the arguments of a syscall with known effects.
+        struct syscall_memory {
+            char (*reads[memory_effect_slots])[];
+            char (*writes[memory_effect_slots])[];
+        };
+
+        // returns the memory the argument in the given slot of Indices points to.
+        template<std::size_t Slot, std::size_t... Is, class... Ts>
+        JM_INLINE_SYSCALL_FORCEINLINE auto
+        accessed_memory(std::index_sequence<Is...>, Ts... args) noexcept -> char (*)[]
+        {
+            if constexpr(Slot < sizeof...(Is)) {
+                constexpr std::size_t indices[] = { Is... };
+                static_assert(indices[Slot] < sizeof...(Ts),
+                              "syscall effects name an argument that doesn't exist");
+
+                const auto pointer = nth_arg<indices[Slot]>(args...);
+                static_assert(std::is_pointer_v<decltype(pointer)>,
+                              "syscall effects can only name pointer arguments");
+                return reinterpret_cast<char(*)[]>(
+                    const_cast<void*>(static_cast<const volatile void*>(pointer)));
+            }
+            else
+                return reinterpret_cast<char(*)[]>(&unaccessed_memory);
         }
 
-        // clang-format off
-    
-        template<class T1, class T2, class T3, class T4, class T5, class T6, class T7>
-        JM_INLINE_SYSCALL_STUB(std::uint32_t id, T1 _1, T2 _2, T3 _3, T4 _4, T5 _5, T6 _6, T7 _7)
+        template<class Effects, class... Ts>
+        JM_INLINE_SYSCALL_FORCEINLINE syscall_memory memory_of(Ts... args) noexcept
         {
-            register auto a1 asm("r10") = _1;
-            register auto a3 asm("r8")  = _3;
-            register auto a4 asm("r9")  = _4;
+            using reads  = typename Effects::reads;
+            using writes = typename Effects::writes;
+            static_assert(reads::size() <= memory_effect_slots &&
+                              writes::size() <= memory_effect_slots,
+                          "syscall effects can name at most 4 read and 4 written arguments");
+
+            return { { accessed_memory<0>(reads{}, args...),
+                       accessed_memory<1>(reads{}, args...),
+                       accessed_memory<2>(reads{}, args...),
+                       accessed_memory<3>(reads{}, args...) },
+                     { accessed_memory<0>(writes{}, args...),
+                       accessed_memory<1>(writes{}, args...),
+                       accessed_memory<2>(writes{}, args...),
+                       accessed_memory<3>(writes{}, args...) } };
+        }
 
-            void*          unused_output;
-            register void* unused_output2 asm("r11");
+// the operands of the memory described by syscall_memory
+#define JM_INLINE_SYSCALL_READ_OPERANDS(memory)                                       \
+    "m"(*(memory).reads[0]), "m"(*(memory).reads[1]), "m"(*(memory).reads[2]),       \
+        "m"(*(memory).reads[3])
+#define JM_INLINE_SYSCALL_WRITE_OPERANDS(memory)                                      \
+    "+m"(*(memory).writes[0]), "+m"(*(memory).writes[1]), "+m"(*(memory).writes[2]), \
+        "+m"(*(memory).writes[3])
 
-            std::int32_t status;
-            asm volatile("sub $64, %%rsp\n"
-                        "movq %[a5], 40(%%rsp)\n"
-                        "movq %[a6], 48(%%rsp)\n"
-                        "movq %[a7], 56(%%rsp)\n"
-                        "syscall\n"
-                        "add $64, %%rsp"
-                        : "=a"(status),
-                        "=r"(a1),
-                        "=d"(_2),
-                        "=r"(a3),
-                        "=r"(a4),
-                        "=c"(unused_output),
-                        "=r"(unused_output2)
-                        : "a"(id),
-                           "r"(a1),
-                           "d"(_2),
-                           "r"(a3),
-                           "r"(a4),
-                           [ a5 ] "re"(reinterpret_cast<void*>(_5)),
-                           [ a6 ] "re"(reinterpret_cast<void*>(_6)),
-                           [ a7 ] "re"(reinterpret_cast<void*>(_7))
-                        : "memory", "cc");
+        // disables register keyword deprecation warnings
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wregister"
+
+#if defined(__linux__)
+        // widens the argument to a full register the same way libc does.
+        template<class T>
+        JM_INLINE_SYSCALL_FORCEINLINE long syscall_arg(T value) noexcept
+        {
+            if constexpr(std::is_pointer_v<T>)
+                return reinterpret_cast<long>(value);
+            else
+                return static_cast<long>(value);
+        }
+#endif
+
+#if defined(__linux__) && defined(__x86_64__)
+
+        /* linux syscall stubs.
+         *
+         * The kernel takes the syscall number in rax and arguments in
+         * rdi, rsi, rdx, r10, r8 and r9. Nothing is passed on the stack and
+         * the syscall instruction itself clobbers rcx and r11. Effects is void unless
+         * the memory effects of the syscall are known.
+         */
+
+        template<class Effects>
+        JM_INLINE_SYSCALL_STUB(std::uint32_t id)
+        {
+            syscall_status status;
+            if constexpr(std::is_void_v<Effects>)
+                asm volatile("syscall"
+                             : "=a"(status)
+                             : "a"(id)
+                             : "rcx", "r11", "memory");
+            else {
+                const auto memory = memory_of<Effects>();
+                asm volatile("syscall"
+                             : "=a"(status), JM_INLINE_SYSCALL_WRITE_OPERANDS(memory)
+                             : "a"(id),
+                               JM_INLINE_SYSCALL_READ_OPERANDS(memory)
+                             : "rcx", "r11");
+            }
             return status;
         }
 
-        template<class T1, class T2, class T3, class T4, class T5, class T6, class T7, class T8>
-        JM_INLINE_SYSCALL_STUB(std::uint32_t id, T1 _1, T2 _2, T3 _3, T4 _4, T5 _5, T6 _6, T7 _7, T8 _8)
+        template<class Effects, class T1>
+        JM_INLINE_SYSCALL_STUB(std::uint32_t id, T1 _1)
         {
-            register auto a1 asm("r10") = _1;
-            register auto a3 asm("r8")  = _3;
-            register auto a4 asm("r9")  = _4;
+            syscall_status status;
+            if constexpr(std::is_void_v<Effects>)
+                asm volatile("syscall"
+                             : "=a"(status)
+                             : "a"(id), "D"(syscall_arg(_1))
+                             : "rcx", "r11", "memory");
+            else {
+                const auto memory = memory_of<Effects>(_1);
+                asm volatile("syscall"
+                             : "=a"(status), JM_INLINE_SYSCALL_WRITE_OPERANDS(memory)
+                             : "a"(id), "D"(syscall_arg(_1)),
+                               JM_INLINE_SYSCALL_READ_OPERANDS(memory)
+                             : "rcx", "r11");
+            }
+            return status;
+        }
 
-            void*          unused_output;
-            register void* unused_output2 asm("r11");
+        template<class Effects, class T1, class T2>
+        JM_INLINE_SYSCALL_STUB(std::uint32_t id, T1 _1, T2 _2)
+        {
+            syscall_status status;
+            if constexpr(std::is_void_v<Effects>)
+                asm volatile("syscall"
+                             : "=a"(status)
+                             : "a"(id), "D"(syscall_arg(_1)), "S"(syscall_arg(_2))
+                             : "rcx", "r11", "memory");
+            else {
+                const auto memory = memory_of<Effects>(_1, _2);
+                asm volatile("syscall"
+                             : "=a"(status), JM_INLINE_SYSCALL_WRITE_OPERANDS(memory)
+                             : "a"(id), "D"(syscall_arg(_1)), "S"(syscall_arg(_2)),
+                               JM_INLINE_SYSCALL_READ_OPERANDS(memory)
+                             : "rcx", "r11");
+            }
+            return status;
+        }
 
-            std::int32_t status;
-            asm volatile("sub $80, %%rsp\n"
-                        "movq %[a5], 40(%%rsp)\n"
-                        "movq %[a6], 48(%%rsp)\n"
-                        "movq %[a7], 56(%%rsp)\n"
-                        "movq %[a8], 64(%%rsp)\n"
-                        "syscall\n"
-                        "add $80, %%rsp"
-                        : "=a"(status),
-                        "=r"(a1),
-                        "=d"(_2),
-                        "=r"(a3),
-                        "=r"(a4),
-                        "=c"(unused_output),
-                        "=r"(unused_output2)
-                        : "a"(id),
-                        "r"(a1),
-                        "d"(_2),
-                        "r"(a3),
-                        "r"(a4),
-                        [ a5 ] "re"(reinterpret_cast<void*>(_5)),
-                        [ a6 ] "re"(reinterpret_cast<void*>(_6)),
-                        [ a7 ] "re"(reinterpret_cast<void*>(_7)),
-                        [ a8 ] "re"(reinterpret_cast<void*>(_8))
-                        : "memory", "cc");
+        template<class Effects, class T1, class T2, class T3>
+        JM_INLINE_SYSCALL_STUB(std::uint32_t id, T1 _1, T2 _2, T3 _3)
+        {
+            syscall_status status;
+            if constexpr(std::is_void_v<Effects>)
+                asm volatile("syscall"
+                             : "=a"(status)
+                             : "a"(id),
+                               "D"(syscall_arg(_1)),
+                               "S"(syscall_arg(_2)),
+                               "d"(syscall_arg(_3))
+                             : "rcx", "r11", "memory");
+            else {
+                const auto memory = memory_of<Effects>(_1, _2, _3);
+                asm volatile("syscall"
+                             : "=a"(status), JM_INLINE_SYSCALL_WRITE_OPERANDS(memory)
+                             : "a"(id),
+                               "D"(syscall_arg(_1)),
+                               "S"(syscall_arg(_2)),
+                               "d"(syscall_arg(_3)),
+                               JM_INLINE_SYSCALL_READ_OPERANDS(memory)
+                             : "rcx", "r11");
+            }
             return status;
         }
 
-        template<class T1, class T2, class T3, class T4, class T5, class T6, class T7, class T8, class T9>
-        JM_INLINE_SYSCALL_STUB(std::uint32_t id, T1 _1, T2 _2, T3 _3, T4 _4, T5 _5, T6 _6, T7 _7, T8 _8, T9 _9)
+        template<class Effects, class T1, class T2, class T3, class T4>
+        JM_INLINE_SYSCALL_STUB(std::uint32_t id, T1 _1, T2 _2, T3 _3, T4 _4)
         {
-            register auto a1 asm("r10") = _1;
-            register auto a3 asm("r8")  = _3;
-            register auto a4 asm("r9")  = _4;
+            register long a4 asm("r10") = syscall_arg(_4);
+
+            syscall_status status;
+            if constexpr(std::is_void_v<Effects>)
+                asm volatile("syscall"
+                             : "=a"(status)
+                             : "a"(id),
+                               "D"(syscall_arg(_1)),
+                               "S"(syscall_arg(_2)),
+                               "d"(syscall_arg(_3)),
+                               "r"(a4)
+                             : "rcx", "r11", "memory");
+            else {
+                const auto memory = memory_of<Effects>(_1, _2, _3, _4);
+                asm volatile("syscall"
+                             : "=a"(status), JM_INLINE_SYSCALL_WRITE_OPERANDS(memory)
+                             : "a"(id),
+                               "D"(syscall_arg(_1)),
+                               "S"(syscall_arg(_2)),
+                               "d"(syscall_arg(_3)),
+                               "r"(a4),
+                               JM_INLINE_SYSCALL_READ_OPERANDS(memory)
+                             : "rcx", "r11");
+            }
+            return status;
+        }
 
-            void*          unused_output;
-            register void* unused_output2 asm("r11");
+        template<class Effects, class T1, class T2, class T3, class T4, class T5>
+        JM_INLINE_SYSCALL_STUB(std::uint32_t id, T1 _1, T2 _2, T3 _3, T4 _4, T5 _5)
+        {
+            register long a4 asm("r10") = syscall_arg(_4);
+            register long a5 asm("r8")  = syscall_arg(_5);
+
+            syscall_status status;
+            if constexpr(std::is_void_v<Effects>)
+                asm volatile("syscall"
+                             : "=a"(status)
+                             : "a"(id),
+                               "D"(syscall_arg(_1)),
+                               "S"(syscall_arg(_2)),
+                               "d"(syscall_arg(_3)),
+                               "r"(a4),
+                               "r"(a5)
+                             : "rcx", "r11", "memory");
+            else {
+                const auto memory = memory_of<Effects>(_1, _2, _3, _4, _5);
+                asm volatile("syscall"
+                             : "=a"(status), JM_INLINE_SYSCALL_WRITE_OPERANDS(memory)
+                             : "a"(id),
+                               "D"(syscall_arg(_1)),
+                               "S"(syscall_arg(_2)),
+                               "d"(syscall_arg(_3)),
+                               "r"(a4),
+                               "r"(a5),
+                               JM_INLINE_SYSCALL_READ_OPERANDS(memory)
+                             : "rcx", "r11");
+            }
+            return status;
+        }
 
-            std::int32_t status;
-            asm volatile("sub $80, %%rsp\n"
-                        "movq %[a5], 40(%%rsp)\n"
-                        "movq %[a6], 48(%%rsp)\n"
-                        "movq %[a7], 56(%%rsp)\n"
-                        "movq %[a8], 64(%%rsp)\n"
-                        "movq %[a9], 72(%%rsp)\n"
-                        "syscall\n"
-                        "add $80, %%rsp"
-                        : "=a"(status),
-                        "=r"(a1),
-                        "=d"(_2),
-                        "=r"(a3),
-                        "=r"(a4),
-                        "=c"(unused_output),
-                        "=r"(unused_output2)
-                        : "a"(id),
-                        "r"(a1),
-                        "d"(_2),
-                        "r"(a3),
-                        "r"(a4),
-                        [ a5 ] "re"(reinterpret_cast<void*>(_5)),
-                        [ a6 ] "re"(reinterpret_cast<void*>(_6)),
-                        [ a7 ] "re"(reinterpret_cast<void*>(_7)),
-                        [ a8 ] "re"(reinterpret_cast<void*>(_8)),
-                        [ a9 ] "re"(reinterpret_cast<void*>(_9))
-                        : "memory", "cc");
+        template<class Effects, class T1, class T2, class T3, class T4, class T5, class T6>
+        JM_INLINE_SYSCALL_STUB(std::uint32_t id, T1 _1, T2 _2, T3 _3, T4 _4, T5 _5, T6 _6)
+        {
+            register long a4 asm("r10") = syscall_arg(_4);
+            register long a5 asm("r8")  = syscall_arg(_5);
+            register long a6 asm("r9")  = syscall_arg(_6);
+
+            syscall_status status;
+            if constexpr(std::is_void_v<Effects>)
+                asm volatile("syscall"
+                             : "=a"(status)
+                             : "a"(id),
+                               "D"(syscall_arg(_1)),
+                               "S"(syscall_arg(_2)),
+                               "d"(syscall_arg(_3)),
+                               "r"(a4),
+                               "r"(a5),
+                               "r"(a6)
+                             : "rcx", "r11", "memory");
+            else {
+                const auto memory = memory_of<Effects>(_1, _2, _3, _4, _5, _6);
+                asm volatile("syscall"
+                             : "=a"(status), JM_INLINE_SYSCALL_WRITE_OPERANDS(memory)
+                             : "a"(id),
+                               "D"(syscall_arg(_1)),
+                               "S"(syscall_arg(_2)),
+                               "d"(syscall_arg(_3)),
+                               "r"(a4),
+                               "r"(a5),
+                               "r"(a6),
+                               JM_INLINE_SYSCALL_READ_OPERANDS(memory)
+                             : "rcx", "r11");
+            }
             return status;
         }
 
+#elif defined(__linux__) && defined(__aarch64__)
 
-        template<class T1, class T2, class T3, class T4, class T5, class T6, class T7, class T8, class T9, class T10>
-        JM_INLINE_SYSCALL_STUB(std::uint32_t id, T1 _1, T2 _2,T3 _3,T4 _4,T5 _5,T6 _6,T7 _7,T8 _8, T9 _9, T10 _10)
+        /* linux arm64 syscall stubs.
+         *
+         * The kernel takes the syscall number in x8 and arguments in x0 to x5 and returns
+         * the result in x0. svc #0 preserves every other register and the flags, so only
+         * x0 is an output. Effects is void unless the memory effects of the syscall are
+         * known.
+         */
+
+        template<class Effects>
+        JM_INLINE_SYSCALL_STUB(std::uint32_t id)
         {
-            register auto a1 asm("r10") = _1;
-            register auto a3 asm("r8")  = _3;
-            register auto a4 asm("r9")  = _4;
+            register long x8 asm("x8") = id;
+            register long x0 asm("x0");
+
+            if constexpr(std::is_void_v<Effects>)
+                asm volatile("svc #0"
+                             : "=r"(x0)
+                             : "r"(x8)
+                             : "memory");
+            else {
+                const auto memory = memory_of<Effects>();
+                asm volatile("svc #0"
+                             : "=r"(x0), JM_INLINE_SYSCALL_WRITE_OPERANDS(memory)
+                             : "r"(x8),
+                               JM_INLINE_SYSCALL_READ_OPERANDS(memory));
+            }
+            return x0;
+        }
 
-            void*          unused_output;
-            register void* unused_output2 asm("r11");
+        template<class Effects, class T1>
+        JM_INLINE_SYSCALL_STUB(std::uint32_t id, T1 _1)
+        {
+            register long x8 asm("x8") = id;
+            register long x0 asm("x0") = syscall_arg(_1);
+
+            if constexpr(std::is_void_v<Effects>)
+                asm volatile("svc #0"
+                             : "+r"(x0)
+                             : "r"(x8)
+                             : "memory");
+            else {
+                const auto memory = memory_of<Effects>(_1);
+                asm volatile("svc #0"
+                             : "+r"(x0), JM_INLINE_SYSCALL_WRITE_OPERANDS(memory)
+                             : "r"(x8),
+                               JM_INLINE_SYSCALL_READ_OPERANDS(memory));
+            }
+            return x0;
+        }
 
-            std::int32_t status;
-            asm volatile("sub $96, %%rsp\n"
-                        "movq %[a5], 40(%%rsp)\n"
-                        "movq %[a6], 48(%%rsp)\n"
-                        "movq %[a7], 56(%%rsp)\n"
-                        "movq %[a8], 64(%%rsp)\n"
-                        "movq %[a9], 72(%%rsp)\n"
-                        "movq %[a10], 80(%%rsp)\n"
-                        "syscall\n"
-                        "add $96, %%rsp"
-                        : "=a"(status),
-                        "=r"(a1),
-                        "=d"(_2),
-                        "=r"(a3),
-                        "=r"(a4),
-                        "=c"(unused_output),
-                        "=r"(unused_output2)
-                        : "a"(id),
-                        "r"(a1),
-                        "d"(_2),
-                        "r"(a3),
-                        "r"(a4),
-                        [ a5 ] "re"(reinterpret_cast<void*>(_5)),
-                        [ a6 ] "re"(reinterpret_cast<void*>(_6)),
-                        [ a7 ] "re"(reinterpret_cast<void*>(_7)),
-                        [ a8 ] "re"(reinterpret_cast<void*>(_8)),
-                        [ a9 ] "re"(reinterpret_cast<void*>(_9)),
-                        [ a10 ] "re"(reinterpret_cast<void*>(_10))
-                        : "memory", "cc");
-            return status;
+        template<class Effects, class T1, class T2>
+        JM_INLINE_SYSCALL_STUB(std::uint32_t id, T1 _1, T2 _2)
+        {
+            register long x8 asm("x8") = id;
+            register long x0 asm("x0") = syscall_arg(_1);
+            register long x1 asm("x1") = syscall_arg(_2);
+
+            if constexpr(std::is_void_v<Effects>)
+                asm volatile("svc #0"
+                             : "+r"(x0)
+                             : "r"(x8), "r"(x1)
+                             : "memory");
+            else {
+                const auto memory = memory_of<Effects>(_1, _2);
+                asm volatile("svc #0"
+                             : "+r"(x0), JM_INLINE_SYSCALL_WRITE_OPERANDS(memory)
+                             : "r"(x8), "r"(x1),
+                               JM_INLINE_SYSCALL_READ_OPERANDS(memory));
+            }
+            return x0;
         }
 
-        template<class T1, class T2, class T3, class T4, class T5, class T6, class T7, class T8, class T9, class T10, class T11>
-        JM_INLINE_SYSCALL_STUB(std::uint32_t id, T1 _1, T2 _2, T3 _3, T4 _4, T5 _5, T6 _6, T7 _7, T8 _8, T9 _9, T10 _10, T11 _11)
+        template<class Effects, class T1, class T2, class T3>
+        JM_INLINE_SYSCALL_STUB(std::uint32_t id, T1 _1, T2 _2, T3 _3)
         {
-            register auto a1 asm("r10") = _1;
-            register auto a3 asm("r8")  = _3;
-            register auto a4 asm("r9")  = _4;
+            register long x8 asm("x8") = id;
+            register long x0 asm("x0") = syscall_arg(_1);
+            register long x1 asm("x1") = syscall_arg(_2);
+            register long x2 asm("x2") = syscall_arg(_3);
+
+            if constexpr(std::is_void_v<Effects>)
+                asm volatile("svc #0"
+                             : "+r"(x0)
+                             : "r"(x8),
+                               "r"(x1),
+                               "r"(x2)
+                             : "memory");
+            else {
+                const auto memory = memory_of<Effects>(_1, _2, _3);
+                asm volatile("svc #0"
+                             : "+r"(x0), JM_INLINE_SYSCALL_WRITE_OPERANDS(memory)
+                             : "r"(x8),
+                               "r"(x1),
+                               "r"(x2),
+                               JM_INLINE_SYSCALL_READ_OPERANDS(memory));
+            }
+            return x0;
+        }
 
-            void*          unused_output;
-            register void* unused_output2 asm("r11");
+        template<class Effects, class T1, class T2, class T3, class T4>
+        JM_INLINE_SYSCALL_STUB(std::uint32_t id, T1 _1, T2 _2, T3 _3, T4 _4)
+        {
+            register long x8 asm("x8") = id;
+            register long x0 asm("x0") = syscall_arg(_1);
+            register long x1 asm("x1") = syscall_arg(_2);
+            register long x2 asm("x2") = syscall_arg(_3);
+            register long x3 asm("x3") = syscall_arg(_4);
+
+            if constexpr(std::is_void_v<Effects>)
+                asm volatile("svc #0"
+                             : "+r"(x0)
+                             : "r"(x8),
+                               "r"(x1),
+                               "r"(x2),
+                               "r"(x3)
+                             : "memory");
+            else {
+                const auto memory = memory_of<Effects>(_1, _2, _3, _4);
+                asm volatile("svc #0"
+                             : "+r"(x0), JM_INLINE_SYSCALL_WRITE_OPERANDS(memory)
+                             : "r"(x8),
+                               "r"(x1),
+                               "r"(x2),
+                               "r"(x3),
+                               JM_INLINE_SYSCALL_READ_OPERANDS(memory));
+            }
+            return x0;
+        }
 
-            std::int32_t status;
-            asm volatile("sub $96, %%rsp\n"
-                        "movq %[a5], 40(%%rsp)\n"
-                        "movq %[a6], 48(%%rsp)\n"
-                        "movq %[a7], 56(%%rsp)\n"
-                        "movq %[a8], 64(%%rsp)\n"
-                        "movq %[a9], 72(%%rsp)\n"
-                        "movq %[a10], 80(%%rsp)\n"
-                        "movq %[a11], 88(%%rsp)\n"
-                        "syscall\n"
-                        "add $96, %%rsp"
-                        : "=a"(status),
-                        "=r"(a1),
-                        "=d"(_2),
-                        "=r"(a3),
-                        "=r"(a4),
-                        "=c"(unused_output),
-                        "=r"(unused_output2)
-                        : "a"(id),
-                        "r"(a1),
-                        "d"(_2),
-                        "r"(a3),
-                        "r"(a4),
-                        [ a5 ] "re"(reinterpret_cast<void*>(_5)),
-                        [ a6 ] "re"(reinterpret_cast<void*>(_6)),
-                        [ a7 ] "re"(reinterpret_cast<void*>(_7)),
-                        [ a8 ] "re"(reinterpret_cast<void*>(_8)),
-                        [ a9 ] "re"(reinterpret_cast<void*>(_9)),
-                        [ a10 ] "re"(reinterpret_cast<void*>(_10)),
-                        [ a11 ] "re"(reinterpret_cast<void*>(_11))
-                        : "memory", "cc");
-            return status;
+        template<class Effects, class T1, class T2, class T3, class T4, class T5>
+        JM_INLINE_SYSCALL_STUB(std::uint32_t id, T1 _1, T2 _2, T3 _3, T4 _4, T5 _5)
+        {
+            register long x8 asm("x8") = id;
+            register long x0 asm("x0") = syscall_arg(_1);
+            register long x1 asm("x1") = syscall_arg(_2);
+            register long x2 asm("x2") = syscall_arg(_3);
+            register long x3 asm("x3") = syscall_arg(_4);
+            register long x4 asm("x4") = syscall_arg(_5);
+
+            if constexpr(std::is_void_v<Effects>)
+                asm volatile("svc #0"
+                             : "+r"(x0)
+                             : "r"(x8),
+                               "r"(x1),
+                               "r"(x2),
+                               "r"(x3),
+                               "r"(x4)
+                             : "memory");
+            else {
+                const auto memory = memory_of<Effects>(_1, _2, _3, _4, _5);
+                asm volatile("svc #0"
+                             : "+r"(x0), JM_INLINE_SYSCALL_WRITE_OPERANDS(memory)
+                             : "r"(x8),
+                               "r"(x1),
+                               "r"(x2),
+                               "r"(x3),
+                               "r"(x4),
+                               JM_INLINE_SYSCALL_READ_OPERANDS(memory));
+            }
+            return x0;
         }
 
-        template<class T1, class T2, class T3, class T4, class T5, class T6, class T7, class T8, class T9, class T10, class T11, class T12>
-        JM_INLINE_SYSCALL_STUB(std::uint32_t id, T1 _1, T2 _2, T3 _3, T4 _4, T5 _5, T6 _6, T7 _7, T8 _8, T9 _9, T10 _10, T11 _11, T12 _12)
+        template<class Effects, class T1, class T2, class T3, class T4, class T5, class T6>
+        JM_INLINE_SYSCALL_STUB(std::uint32_t id, T1 _1, T2 _2, T3 _3, T4 _4, T5 _5, T6 _6)
         {
-            register auto a1 asm("r10") = _1;
-            register auto a3 asm("r8")  = _3;
-            register auto a4 asm("r9")  = _4;
+            register long x8 asm("x8") = id;
+            register long x0 asm("x0") = syscall_arg(_1);
+            register long x1 asm("x1") = syscall_arg(_2);
+            register long x2 asm("x2") = syscall_arg(_3);
+            register long x3 asm("x3") = syscall_arg(_4);
+            register long x4 asm("x4") = syscall_arg(_5);
+            register long x5 asm("x5") = syscall_arg(_6);
+
+            if constexpr(std::is_void_v<Effects>)
+                asm volatile("svc #0"
+                             : "+r"(x0)
+                             : "r"(x8),
+                               "r"(x1),
+                               "r"(x2),
+                               "r"(x3),
+                               "r"(x4),
+                               "r"(x5)
+                             : "memory");
+            else {
+                const auto memory = memory_of<Effects>(_1, _2, _3, _4, _5, _6);
+                asm volatile("svc #0"
+                             : "+r"(x0), JM_INLINE_SYSCALL_WRITE_OPERANDS(memory)
+                             : "r"(x8),
+                               "r"(x1),
+                               "r"(x2),
+                               "r"(x3),
+                               "r"(x4),
+                               "r"(x5),
+                               JM_INLINE_SYSCALL_READ_OPERANDS(memory));
+            }
+            return x0;
+        }
 
-            void*          unused_output;
-            register void* unused_output2 asm("r11");
+#elif defined(__linux__)
+#error "inline_syscall only supports x86-64 and arm64 linux"
+#else
 
-            std::int32_t status;
-            asm volatile("sub $112, %%rsp\n"
-                        "movq %[a5], 40(%%rsp)\n"
-                        "movq %[a6], 48(%%rsp)\n"
-                        "movq %[a7], 56(%%rsp)\n"
-                        "movq %[a8], 64(%%rsp)\n"
-                        "movq %[a9], 72(%%rsp)\n"
-                        "movq %[a10], 80(%%rsp)\n"
-                        "movq %[a11], 88(%%rsp)\n"
-                        "movq %[a12], 96(%%rsp)\n"
-                        "syscall\n"
-                        "add $112, %%rsp"
-                        : "=a"(status),
-                        "=r"(a1),
-                        "=d"(_2),
-                        "=r"(a3),
-                        "=r"(a4),
-                        "=c"(unused_output),
-                        "=r"(unused_output2)
-                        : "a"(id),
-                        "r"(a1),
-                        "d"(_2),
-                        "r"(a3),
-                        "r"(a4),
-                        [ a5 ] "re"(reinterpret_cast<void*>(_5)),
-                        [ a6 ] "re"(reinterpret_cast<void*>(_6)),
-                        [ a7 ] "re"(reinterpret_cast<void*>(_7)),
-                        [ a8 ] "re"(reinterpret_cast<void*>(_8)),
-                        [ a9 ] "re"(reinterpret_cast<void*>(_9)),
-                        [ a10 ] "re"(reinterpret_cast<void*>(_10)),
-                        [ a11 ] "re"(reinterpret_cast<void*>(_11)),
-                        [ a12 ] "re"(reinterpret_cast<void*>(_12))
-                        : "memory", "cc");
-            return status;
+        // converts a stack argument to the 8 byte slot that the kernel reads it from.
+        template<class T>
+        JM_INLINE_SYSCALL_FORCEINLINE std::uintptr_t stack_arg(T value) noexcept
+        {
+            if constexpr(std::is_pointer_v<T>)
+                return reinterpret_cast<std::uintptr_t>(value);
+            else
+                return static_cast<std::uintptr_t>(value);
         }
 
+        // the type of the register that holds the argument with the given index.
+        // Registers without an argument are untyped.
+        template<std::size_t I, class... Ts>
+        using register_arg_t =
+            std::tuple_element_t<I, std::tuple<Ts..., void*, void*, void*, void*>>;
+
+        // the bytes below rsp that the compiler may use without adjusting rsp. The windows
+        // ABI has none, but the stubs can also end up in code compiled for the SysV ABI.
+#if defined(_WIN32)
+        constexpr std::size_t red_zone_size = 0;
+#else
+        constexpr std::size_t red_zone_size = 128;
+#endif
 
-        template<class T1, class T2, class T3, class T4, class T5, class T6, class T7, class T8, class T9, class T10, class T11, class T12, class T13>
-        JM_INLINE_SYSCALL_STUB(std::uint32_t id, T1 _1, T2 _2, T3 _3, T4 _4, T5 _5, T6 _6, T7 _7, T8 _8, T9 _9, T10 _10, T11 _11, T12 _12, T13 _13)
+        // the number of stack arguments that are stored by the stub straight from their
+        // operands. Every one of them can take up a register, and an asm statement has
+        // at most 30 operands, of which the memory effects use 16. Calls with more stack
+        // arguments copy them from a local array.
+        template<class Effects>
+        constexpr std::size_t direct_stack_args = std::is_void_v<Effects> ? 8 : 4;
+
+// stores stack argument i of the first count ones to where the kernel reads it from.
+#define JM_INLINE_SYSCALL_STACK_STORE(i)                                                \
+    ".if %c[count] > " #i "\n"                                                          \
+    "movq %[s" #i "], 0x28 + 8 * " #i "(%%rsp)\n"                                        \
+    ".endif\n"
+#define JM_INLINE_SYSCALL_STACK_STORES_4                                                \
+    JM_INLINE_SYSCALL_STACK_STORE(0)                                                    \
+    JM_INLINE_SYSCALL_STACK_STORE(1) JM_INLINE_SYSCALL_STACK_STORE(2)                   \
+        JM_INLINE_SYSCALL_STACK_STORE(3)
+#define JM_INLINE_SYSCALL_STACK_STORES_8                                                \
+    JM_INLINE_SYSCALL_STACK_STORES_4                                                    \
+    JM_INLINE_SYSCALL_STACK_STORE(4) JM_INLINE_SYSCALL_STACK_STORE(5)                   \
+        JM_INLINE_SYSCALL_STACK_STORE(6) JM_INLINE_SYSCALL_STACK_STORE(7)
+
+// the operands of the stores. Missing arguments are a constant 0 even without
+// optimizations, so that they don't take up a register.
+#define JM_INLINE_SYSCALL_STACK_OPERAND(i, count, args) \
+    [s##i] "re"(count > i ? stack_arg(nth_arg<4 + (count > i ? i : 0)>(args...)) : 0)
+#define JM_INLINE_SYSCALL_STACK_OPERANDS_4(count, args)                                 \
+    JM_INLINE_SYSCALL_STACK_OPERAND(0, count, args),                                    \
+        JM_INLINE_SYSCALL_STACK_OPERAND(1, count, args),                                \
+        JM_INLINE_SYSCALL_STACK_OPERAND(2, count, args),                                \
+        JM_INLINE_SYSCALL_STACK_OPERAND(3, count, args)
+#define JM_INLINE_SYSCALL_STACK_OPERANDS_8(count, args)                                 \
+    JM_INLINE_SYSCALL_STACK_OPERANDS_4(count, args),                                    \
+        JM_INLINE_SYSCALL_STACK_OPERAND(4, count, args),                                \
+        JM_INLINE_SYSCALL_STACK_OPERAND(5, count, args),                                \
+        JM_INLINE_SYSCALL_STACK_OPERAND(6, count, args),                                \
+        JM_INLINE_SYSCALL_STACK_OPERAND(7, count, args)
+
+        /* windows syscall stub.
+         *
+         * The first 4 arguments are passed in r10, rdx, r8 and r9. The rest are read
+         * by the kernel from [rsp + 0x28] onwards, where the stub in ntdll would find
+         * them after the return address and the shadow space. The asm statement moves
+         * rsp below everything that the compiler owns and stores the stack arguments
+         * there, so an APC or exception that is delivered during the syscall pushes its
+         * CONTEXT below them and can't overwrite any live data.
+         */
+
+        template<class Effects, std::size_t... Is, class... Ts>
+        JM_INLINE_SYSCALL_FORCEINLINE syscall_status
+        syscall(std::index_sequence<Is...>, std::uint32_t id, Ts... args) noexcept
         {
-            register auto a1 asm("r10") = _1;
-            register auto a3 asm("r8")  = _3;
-            register auto a4 asm("r9")  = _4;
+            register register_arg_t<0, Ts...> a1 asm("r10");
+            register register_arg_t<1, Ts...> a2 asm("rdx");
+            register register_arg_t<2, Ts...> a3 asm("r8");
+            register register_arg_t<3, Ts...> a4 asm("r9");
+
+            // registers without an argument are given a value by an empty asm statement
+            // so that they can be bound as inputs without emitting any instructions.
+            if constexpr(sizeof...(Ts) > 0) a1 = nth_arg<0>(args...);
+            else asm volatile("" : "=r"(a1));
+            if constexpr(sizeof...(Ts) > 1) a2 = nth_arg<1>(args...);
+            else asm volatile("" : "=r"(a2));
+            if constexpr(sizeof...(Ts) > 2) a3 = nth_arg<2>(args...);
+            else asm volatile("" : "=r"(a3));
+            if constexpr(sizeof...(Ts) > 3) a4 = nth_arg<3>(args...);
+            else asm volatile("" : "=r"(a4));
 
             void*          unused_output;
             register void* unused_output2 asm("r11");
 
             std::int32_t status;
-            asm volatile("sub $112, %%rsp\n"
-                        "movq %[a5], 40(%%rsp)\n"
-                        "movq %[a6], 48(%%rsp)\n"
-                        "movq %[a7], 56(%%rsp)\n"
-                        "movq %[a8], 64(%%rsp)\n"
-                        "movq %[a9], 72(%%rsp)\n"
-                        "movq %[a10], 80(%%rsp)\n"
-                        "movq %[a11], 88(%%rsp)\n"
-                        "movq %[a12], 96(%%rsp)\n"
-                        "movq %[a13], 104(%%rsp)\n"
-                        "syscall\n"
-                        "add $112, %%rsp"
-                        : "=a"(status),
-                        "=r"(a1),
-                        "=d"(_2),
-                        "=r"(a3),
-                        "=r"(a4),
-                        "=c"(unused_output),
-                        "=r"(unused_output2)
-                        : "a"(id),
-                        "r"(a1),
-                        "d"(_2),
-                        "r"(a3),
-                        "r"(a4),
-                        [ a5 ] "re"(reinterpret_cast<void*>(_5)),
-                        [ a6 ] "re"(reinterpret_cast<void*>(_6)),
-                        [ a7 ] "re"(reinterpret_cast<void*>(_7)),
-                        [ a8 ] "re"(reinterpret_cast<void*>(_8)),
-                        [ a9 ] "re"(reinterpret_cast<void*>(_9)),
-                        [ a10 ] "re"(reinterpret_cast<void*>(_10)),
-                        [ a11 ] "re"(reinterpret_cast<void*>(_11)),
-                        [ a12 ] "re"(reinterpret_cast<void*>(_12)),
-                        [ a13 ] "re"(reinterpret_cast<void*>(_13))
-                        : "memory", "cc");
+            if constexpr(sizeof...(Is) == 0) {
+                if constexpr(std::is_void_v<Effects>)
+                    asm volatile("syscall\n"
+                                 : "=a"(status),
+                                   "+r"(a1),
+                                   "+r"(a2),
+                                   "+r"(a3),
+                                   "+r"(a4),
+                                   "=c"(unused_output),
+                                   "=r"(unused_output2)
+                                 : "a"(id)
+                                 : "memory", "cc");
+                else {
+                    const auto memory = memory_of<Effects>(args...);
+                    asm volatile("syscall\n"
+                                 : "=a"(status),
+                                   "+r"(a1),
+                                   "+r"(a2),
+                                   "+r"(a3),
+                                   "+r"(a4),
+                                   "=c"(unused_output),
+                                   "=r"(unused_output2),
+                                   JM_INLINE_SYSCALL_WRITE_OPERANDS(memory)
+                                 : "a"(id), JM_INLINE_SYSCALL_READ_OPERANDS(memory)
+                                 : "cc");
+                }
+            }
+            else if constexpr(sizeof...(Is) <= direct_stack_args<Effects>) {
+                // the return address, the shadow space and the stack arguments rounded
+                // up so that rsp stays 16 byte aligned, below the red zone.
+                constexpr auto frame_size =
+                    red_zone_size + 8 * ((5 + sizeof...(Is) + 1) & ~std::size_t{ 1 });
+
+                // the registers and immediates of the arguments are stored directly
+                if constexpr(std::is_void_v<Effects>)
+                    asm volatile("sub %[size], %%rsp\n" JM_INLINE_SYSCALL_STACK_STORES_8
+                                 "syscall\n"
+                                 "add %[size], %%rsp"
+                                 : "=a"(status),
+                                   "+r"(a1),
+                                   "+r"(a2),
+                                   "+r"(a3),
+                                   "+r"(a4),
+                                   "=c"(unused_output),
+                                   "=r"(unused_output2)
+                                 : "a"(id),
+                                   [ size ] "i"(frame_size),
+                                   [ count ] "i"(sizeof...(Is)),
+                                   JM_INLINE_SYSCALL_STACK_OPERANDS_8(sizeof...(Is), args)
+                                 : "memory", "cc");
+                else {
+                    const auto memory = memory_of<Effects>(args...);
+                    asm volatile("sub %[size], %%rsp\n" JM_INLINE_SYSCALL_STACK_STORES_4
+                                 "syscall\n"
+                                 "add %[size], %%rsp"
+                                 : "=a"(status),
+                                   "+r"(a1),
+                                   "+r"(a2),
+                                   "+r"(a3),
+                                   "+r"(a4),
+                                   "=c"(unused_output),
+                                   "=r"(unused_output2),
+                                   JM_INLINE_SYSCALL_WRITE_OPERANDS(memory)
+                                 : "a"(id),
+                                   [ size ] "i"(frame_size),
+                                   [ count ] "i"(sizeof...(Is)),
+                                   JM_INLINE_SYSCALL_STACK_OPERANDS_4(sizeof...(Is), args),
+                                   JM_INLINE_SYSCALL_READ_OPERANDS(memory)
+                                 : "cc");
+                }
+            }
+            else {
+                constexpr auto frame_size =
+                    red_zone_size + 8 * ((5 + sizeof...(Is) + 1) & ~std::size_t{ 1 });
+                const std::uintptr_t stack_args[] = { stack_arg(nth_arg<4 + Is>(args...))... };
+
+                // rcx is free until the syscall overwrites it with the return address, so
+                // it is used to copy the stack arguments.
+                if constexpr(std::is_void_v<Effects>)
+                    asm volatile("sub %[size], %%rsp\n"
+                                 ".set .Ljm_stack_arg, 0\n"
+                                 ".rept %c[count]\n"
+                                 "mov .Ljm_stack_arg(%[args]), %%rcx\n"
+                                 "mov %%rcx, 0x28 + .Ljm_stack_arg(%%rsp)\n"
+                                 ".set .Ljm_stack_arg, .Ljm_stack_arg + 8\n"
+                                 ".endr\n"
+                                 "syscall\n"
+                                 "add %[size], %%rsp"
+                                 : "=a"(status),
+                                   "+r"(a1),
+                                   "+r"(a2),
+                                   "+r"(a3),
+                                   "+r"(a4),
+                                   "=&c"(unused_output),
+                                   "=r"(unused_output2)
+                                 : "a"(id),
+                                   [ args ] "r"(stack_args),
+                                   [ size ] "i"(frame_size),
+                                   [ count ] "i"(sizeof...(Is))
+                                 : "memory", "cc");
+                else {
+                    // without the memory clobber the stores of the stack arguments have
+                    // to be kept alive by the array operand.
+                    const auto memory = memory_of<Effects>(args...);
+                    asm volatile("sub %[size], %%rsp\n"
+                                 ".set .Ljm_stack_arg, 0\n"
+                                 ".rept %c[count]\n"
+                                 "mov .Ljm_stack_arg(%[args]), %%rcx\n"
+                                 "mov %%rcx, 0x28 + .Ljm_stack_arg(%%rsp)\n"
+                                 ".set .Ljm_stack_arg, .Ljm_stack_arg + 8\n"
+                                 ".endr\n"
+                                 "syscall\n"
+                                 "add %[size], %%rsp"
+                                 : "=a"(status),
+                                   "+r"(a1),
+                                   "+r"(a2),
+                                   "+r"(a3),
+                                   "+r"(a4),
+                                   "=&c"(unused_output),
+                                   "=r"(unused_output2),
+                                   JM_INLINE_SYSCALL_WRITE_OPERANDS(memory)
+                                 : "a"(id),
+                                   [ args ] "r"(stack_args),
+                                   [ size ] "i"(frame_size),
+                                   [ count ] "i"(sizeof...(Is)),
+                                   "m"(stack_args),
+                                   JM_INLINE_SYSCALL_READ_OPERANDS(memory)
+                                 : "cc");
+                }
+            }
             return status;
         }
 
-        // clang-format on
+        template<class Effects, class... Ts>
+        JM_INLINE_SYSCALL_STUB(std::uint32_t id, Ts... args)
+        {
+            constexpr auto stack_args = sizeof...(Ts) > 4 ? sizeof...(Ts) - 4 : 0;
+            return syscall<Effects>(std::make_index_sequence<stack_args>{}, id, args...);
+        }
+
+#endif
 
 #pragma GCC diagnostic pop
 
     } // namespace detail
 
+#if defined(JM_INLINE_SYSCALL_STATS)
+    inline void syscall_stats_entry::record(std::uint64_t cycles) noexcept
+    {
+        auto& shard = shards[detail::current_stats_shard()];
+
+        // floor(log2(cycles)) clamped to the last bucket
+        auto bucket = static_cast<std::size_t>(63 - __builtin_clzll(cycles | 1));
+        if(bucket >= syscall_stats_summary::buckets)
+            bucket = syscall_stats_summary::buckets - 1;
+
+        // plain loads and stores are enough as every shard normally has a single writer,
+        // the atomics only make sure that readers never see torn values.
+        const auto increment = [](std::uint64_t& counter, std::uint64_t value) {
+            __atomic_store_n(
+                &counter, __atomic_load_n(&counter, __ATOMIC_RELAXED) + value, __ATOMIC_RELAXED);
+        };
+        increment(shard.calls, 1);
+        increment(shard.cycles, cycles);
+        increment(shard.histogram[bucket], 1);
+    }
+
+    inline syscall_stats_summary syscall_stats_entry::summary() const noexcept
+    {
+        syscall_stats_summary summary;
+        summary.hash = hash;
+        for(const auto& shard : shards) {
+            summary.calls += __atomic_load_n(&shard.calls, __ATOMIC_RELAXED);
+            summary.cycles += __atomic_load_n(&shard.cycles, __ATOMIC_RELAXED);
+            for(std::size_t i = 0; i < syscall_stats_summary::buckets; ++i)
+                summary.histogram[i] += __atomic_load_n(&shard.histogram[i], __ATOMIC_RELAXED);
+        }
+        return summary;
+    }
+#endif
+
     template<class R, class... Args>
     inline R syscall_function<R(Args...)>::operator()(Args... args) const noexcept
     {
-        return detail::syscall(_id, args...);
+        return call<void>(args...);
+    }
+
+    template<class R, class... Args>
+    template<class Effects>
+    JM_INLINE_SYSCALL_FORCEINLINE R syscall_function<R(Args...)>::call(Args... args) const
+        noexcept
+    {
+#if defined(JM_INLINE_SYSCALL_INSTRUMENTED)
+        const auto start  = detail::timestamp();
+        const auto status = detail::syscall<Effects>(_id, args...);
+        const auto end    = detail::timestamp();
+#if defined(JM_INLINE_SYSCALL_STATS)
+        if(_site.stats)
+            _site.stats->record(end - start);
+#endif
+#if defined(JM_INLINE_SYSCALL_TRACE)
+        if(_site.hash)
+            detail::trace(_site.hash, _id, status, start, end, args...);
+#endif
+#else
+        const auto status = detail::syscall<Effects>(_id, args...);
+#endif
+        return detail::syscall_result<R>(status);
     }
 
     inline JM_INLINE_SYSCALL_ENTRY_TYPE* syscall_entries() noexcept
     {
-        return &detail::syscall_holder<0>::entry + 1;
+        return detail::first_syscall_entry();
     }
 
+    inline JM_INLINE_SYSCALL_ENTRY_TYPE* syscall_entries_end() noexcept
+    {
+        return detail::last_syscall_entry();
+    }
+
+    template<class Entry>
+    inline const std::uint32_t* syscall_hashes() noexcept
+    {
+        static_assert(std::is_same_v<Entry, syscall_entry_split>,
+                      "only split syscall entries store their hashes separately");
+        return detail::first_syscall_hash();
+    }
+
+    template<class Entry>
+    inline void release_syscall_hashes() noexcept
+    {
+        constexpr std::uintptr_t page_size = 0x1000;
+
+        const auto first = syscall_hashes<Entry>();
+        const auto last  = detail::last_syscall_hash();
+
+        const auto begin =
+            (reinterpret_cast<std::uintptr_t>(first) + page_size - 1) & ~(page_size - 1);
+        const auto end = reinterpret_cast<std::uintptr_t>(last) & ~(page_size - 1);
+        if(begin >= end)
+            return;
+
+        auto        address = reinterpret_cast<void*>(begin);
+        std::size_t size    = end - begin;
+#if defined(__linux__)
+        // MADV_PAGEOUT, older kernels reject it which leaves the hashes resident
+        syscall_function<long(void*, std::size_t, int)>{ __NR_madvise }(address, size, 21);
+#else
+        // unlocking pages that aren't locked removes them from the working set
+        using NtUnlockVirtualMemory = std::int32_t(void*, void**, std::size_t*, std::uint32_t);
+        INLINE_SYSCALL_T(NtUnlockVirtualMemory)
+        (reinterpret_cast<void*>(-1), &address, &size, 1 /* MAP_PROCESS */);
+#endif
+    }
+
+#if defined(JM_INLINE_SYSCALL_STATS)
+    inline syscall_stats_entry* syscall_stats() noexcept
+    {
+        return detail::syscall_stats_list;
+    }
+
+    inline const syscall_stats_entry* find_syscall_stats(std::uint32_t hash) noexcept
+    {
+        for(auto entry = syscall_stats(); entry; entry = entry->next)
+            if(entry->hash == hash)
+                return entry;
+
+        return nullptr;
+    }
+#endif
+
+#if defined(JM_INLINE_SYSCALL_TRACE)
+    inline void syscall_trace_ring::push(const syscall_trace_record& record) noexcept
+    {
+        constexpr std::uint64_t mask = JM_INLINE_SYSCALL_TRACE_RING_SIZE - 1;
+
+        // only the owning thread writes the head
+        const auto head = _head;
+        auto&      slot = _slots[head & mask];
+
+        __atomic_store_n(&slot.sequence, 2 * head + 1, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_RELEASE);
+        detail::copy_trace_record(slot.record, record);
+        __atomic_store_n(&slot.sequence, 2 * head + 2, __ATOMIC_RELEASE);
+        __atomic_store_n(&_head, head + 1, __ATOMIC_RELEASE);
+    }
+
+    inline std::size_t syscall_trace_ring::pop(syscall_trace_record* records,
+                                               std::size_t           capacity,
+                                               std::uint64_t&        lost) noexcept
+    {
+        constexpr std::uint64_t size = JM_INLINE_SYSCALL_TRACE_RING_SIZE;
+
+        const auto head = __atomic_load_n(&_head, __ATOMIC_ACQUIRE);
+        auto       tail = _tail;
+        if(head - tail > size) {
+            lost += head - tail - size;
+            tail = head - size;
+        }
+
+        std::size_t count = 0;
+        for(; tail != head && count < capacity; ++tail) {
+            const auto& slot     = _slots[tail & (size - 1)];
+            const auto  expected = 2 * tail + 2;
+
+            // the record is valid if it wasn't being overwritten before or while copying
+            if(__atomic_load_n(&slot.sequence, __ATOMIC_ACQUIRE) == expected) {
+                detail::copy_trace_record(records[count], slot.record);
+                __atomic_thread_fence(__ATOMIC_ACQUIRE);
+                if(__atomic_load_n(&slot.sequence, __ATOMIC_RELAXED) == expected) {
+                    ++count;
+                    continue;
+                }
+            }
+            ++lost;
+        }
+
+        __atomic_store_n(&_tail, tail, __ATOMIC_RELEASE);
+        return count;
+    }
+
+    inline bool syscall_trace_ring::try_acquire(std::uint32_t thread_) noexcept
+    {
+        if(!__atomic_load_n(&_retired, __ATOMIC_ACQUIRE) ||
+           __atomic_load_n(&_tail, __ATOMIC_ACQUIRE) != __atomic_load_n(&_head, __ATOMIC_RELAXED))
+            return false;
+
+        bool retired = true;
+        if(!__atomic_compare_exchange_n(
+               &_retired, &retired, false, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+            return false;
+
+        __atomic_store_n(&thread, thread_, __ATOMIC_RELAXED);
+        return true;
+    }
+
+    inline void syscall_trace_ring::retire() noexcept
+    {
+        __atomic_store_n(&_retired, true, __ATOMIC_RELEASE);
+    }
+
+    inline syscall_trace_ring* syscall_trace_rings() noexcept
+    {
+        return detail::trace_rings.load(std::memory_order_acquire);
+    }
+#endif
+
 } // namespace jm
 
+#if defined(__linux__) && (defined(__x86_64__) || defined(__aarch64__)) && \
+    !defined(JM_INLINE_SYSCALL_NO_VDSO)
+#include "vdso.inl"
+#endif
+
 #endif // JM_INLINE_SYSCALL_INL
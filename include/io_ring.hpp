@@ -0,0 +1,484 @@
+/*
+ * Copyright 2018-2020 Justas Masiulis
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef JM_INLINE_SYSCALL_IO_RING_HPP
+#define JM_INLINE_SYSCALL_IO_RING_HPP
+
+#include "inline_syscall.hpp"
+#include <cerrno>
+#include <csignal>
+#include <cstddef>
+#include <cstring>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+#if __cplusplus >= 202002L && __has_include(<coroutine>)
+#include <coroutine>
+#define JM_INLINE_SYSCALL_IO_RING_COROUTINES
+#endif
+
+namespace jm {
+
+    /// \brief Base of operations whose completion is dispatched by io_ring::run_once.
+    ///        The address of it is used as user_data of the submission queue entry.
+    struct io_ring_completion {
+        void (*complete)(io_ring_completion* self, std::int32_t result, std::uint32_t flags);
+    };
+
+    /// \brief A minimal io_uring instance that talks to the kernel through inlined
+    ///        syscalls only.
+    /// \note Not thread safe. Every thread is expected to own its ring.
+    class io_ring {
+        using io_uring_setup    = int(unsigned entries, io_uring_params* params);
+        using io_uring_enter    = int(int             fd,
+                                   unsigned        to_submit,
+                                   unsigned        min_complete,
+                                   unsigned        flags,
+                                   const sigset_t* sig,
+                                   std::size_t     sigsz);
+        using io_uring_register = int(int fd, unsigned opcode, const void* arg, unsigned count);
+        using close             = int(int fd);
+
+        int           _fd    = -1;
+        int           _error = 0;
+        std::uint32_t _flags = 0;
+
+        // submission queue
+        unsigned*     _sq_head    = nullptr;
+        unsigned*     _sq_tail    = nullptr;
+        unsigned*     _sq_flags   = nullptr;
+        unsigned*     _sq_array   = nullptr;
+        unsigned      _sq_mask    = 0;
+        unsigned      _sq_entries = 0;
+        io_uring_sqe* _sqes       = nullptr;
+
+        // entries handed out by get_sqe but not yet published to the kernel
+        unsigned _sqe_head = 0;
+        unsigned _sqe_tail = 0;
+
+        // completion queue
+        unsigned*     _cq_head = nullptr;
+        unsigned*     _cq_tail = nullptr;
+        unsigned      _cq_mask = 0;
+        io_uring_cqe* _cqes    = nullptr;
+
+        void*       _sq_ring      = MAP_FAILED;
+        void*       _cq_ring      = MAP_FAILED;
+        std::size_t _sq_ring_size = 0;
+        std::size_t _cq_ring_size = 0;
+        std::size_t _sqes_size    = 0;
+
+        static void* map(std::size_t size, int fd, std::uint64_t offset) noexcept
+        {
+            return INLINE_SYSCALL(mmap)(nullptr,
+                                        size,
+                                        PROT_READ | PROT_WRITE,
+                                        MAP_SHARED | MAP_POPULATE,
+                                        fd,
+                                        static_cast<off_t>(offset));
+        }
+
+        // the kernel returns -errno which ends up as an address in the last page
+        static bool map_failed(void* address) noexcept
+        {
+            return reinterpret_cast<std::uintptr_t>(address) > static_cast<std::uintptr_t>(-4096);
+        }
+
+        template<class T>
+        T* at(void* ring, std::uint32_t offset) noexcept
+        {
+            return reinterpret_cast<T*>(static_cast<char*>(ring) + offset);
+        }
+
+        // moves the entries filled in since the last flush into the submission queue.
+        // Returns the number of entries that the kernel hasn't consumed yet.
+        unsigned flush() noexcept
+        {
+            auto tail = *_sq_tail;
+            for(; _sqe_head != _sqe_tail; ++_sqe_head, ++tail)
+                _sq_array[tail & _sq_mask] = _sqe_head & _sq_mask;
+
+            __atomic_store_n(_sq_tail, tail, __ATOMIC_RELEASE);
+            return tail - __atomic_load_n(_sq_head, __ATOMIC_ACQUIRE);
+        }
+
+        int enter(unsigned to_submit, unsigned min_complete, unsigned flags) noexcept
+        {
+            return INLINE_SYSCALL_T(io_uring_enter)(
+                _fd, to_submit, min_complete, flags, nullptr, _NSIG / 8);
+        }
+
+        // errors of io_uring_enter after which the completions have to be reaped before
+        // trying again
+        static bool backpressure(int result) noexcept
+        {
+            return result == -EINTR || result == -EBUSY || result == -EAGAIN;
+        }
+
+    public:
+        /// \brief Creates the ring and maps its queues.
+        /// \param entries The size of submission queue.
+        /// \param flags IORING_SETUP_* flags, for example IORING_SETUP_SQPOLL.
+        /// \param sq_thread_idle Milliseconds the SQPOLL thread spins before sleeping.
+        /// \note Check error() to see whether the creation succeeded.
+        explicit io_ring(unsigned      entries,
+                         std::uint32_t flags          = 0,
+                         unsigned      sq_thread_idle = 0) noexcept
+        {
+            io_uring_params params;
+            std::memset(&params, 0, sizeof(params));
+            params.flags          = flags;
+            params.sq_thread_idle = sq_thread_idle;
+
+            _fd = INLINE_SYSCALL_T(io_uring_setup)(entries, &params);
+            if(_fd < 0) {
+                _error = _fd;
+                return;
+            }
+
+            _flags        = params.flags;
+            _sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+            _cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+            _sqes_size    = params.sq_entries * sizeof(io_uring_sqe);
+
+            const bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+            if(single_mmap && _cq_ring_size > _sq_ring_size)
+                _sq_ring_size = _cq_ring_size;
+
+            _sq_ring = map(_sq_ring_size, _fd, IORING_OFF_SQ_RING);
+            if(map_failed(_sq_ring)) {
+                _error   = static_cast<int>(reinterpret_cast<std::intptr_t>(_sq_ring));
+                _sq_ring = MAP_FAILED;
+                return;
+            }
+
+            if(single_mmap)
+                _cq_ring = _sq_ring;
+            else {
+                _cq_ring = map(_cq_ring_size, _fd, IORING_OFF_CQ_RING);
+                if(map_failed(_cq_ring)) {
+                    _error   = static_cast<int>(reinterpret_cast<std::intptr_t>(_cq_ring));
+                    _cq_ring = MAP_FAILED;
+                    return;
+                }
+            }
+
+            const auto sqes = map(_sqes_size, _fd, IORING_OFF_SQES);
+            if(map_failed(sqes)) {
+                _error = static_cast<int>(reinterpret_cast<std::intptr_t>(sqes));
+                return;
+            }
+            _sqes = static_cast<io_uring_sqe*>(sqes);
+
+            _sq_head    = at<unsigned>(_sq_ring, params.sq_off.head);
+            _sq_tail    = at<unsigned>(_sq_ring, params.sq_off.tail);
+            _sq_flags   = at<unsigned>(_sq_ring, params.sq_off.flags);
+            _sq_array   = at<unsigned>(_sq_ring, params.sq_off.array);
+            _sq_mask    = *at<unsigned>(_sq_ring, params.sq_off.ring_mask);
+            _sq_entries = *at<unsigned>(_sq_ring, params.sq_off.ring_entries);
+
+            _cq_head = at<unsigned>(_cq_ring, params.cq_off.head);
+            _cq_tail = at<unsigned>(_cq_ring, params.cq_off.tail);
+            _cq_mask = *at<unsigned>(_cq_ring, params.cq_off.ring_mask);
+            _cqes    = at<io_uring_cqe>(_cq_ring, params.cq_off.cqes);
+
+            _sqe_head = _sqe_tail = *_sq_tail;
+        }
+
+        io_ring(const io_ring&) = delete;
+        io_ring& operator=(const io_ring&) = delete;
+
+        ~io_ring()
+        {
+            if(_sqes)
+                INLINE_SYSCALL(munmap)(_sqes, _sqes_size);
+            if(_cq_ring != MAP_FAILED && _cq_ring != _sq_ring)
+                INLINE_SYSCALL(munmap)(_cq_ring, _cq_ring_size);
+            if(_sq_ring != MAP_FAILED)
+                INLINE_SYSCALL(munmap)(_sq_ring, _sq_ring_size);
+            if(_fd >= 0)
+                INLINE_SYSCALL_T(close)(_fd);
+        }
+
+        /// \brief Returns 0 if the ring was created successfully or -errno otherwise.
+        int error() const noexcept { return _error; }
+
+        int fd() const noexcept { return _fd; }
+
+        /// \brief Returns the next free submission queue entry or nullptr if the queue is
+        ///        full. The entry is submitted by the next call to submit or run_once.
+        io_uring_sqe* get_sqe() noexcept
+        {
+            const auto head = __atomic_load_n(_sq_head, __ATOMIC_ACQUIRE);
+            if(_sqe_tail - head >= _sq_entries)
+                return nullptr;
+
+            return &_sqes[_sqe_tail++ & _sq_mask];
+        }
+
+        /// \brief Submits every filled in entry with at most a single io_uring_enter and
+        ///        optionally waits for completions.
+        /// \returns The number of entries submitted or -errno.
+        int submit(unsigned wait_for = 0) noexcept
+        {
+            const auto pending = flush();
+
+            if(_flags & IORING_SETUP_SQPOLL) {
+                // the kernel thread picks up the entries by itself unless it went to sleep.
+                // The fence orders the tail store before the flags load.
+                __atomic_thread_fence(__ATOMIC_SEQ_CST);
+                unsigned flags = wait_for ? IORING_ENTER_GETEVENTS : 0;
+                if(__atomic_load_n(_sq_flags, __ATOMIC_RELAXED) & IORING_SQ_NEED_WAKEUP)
+                    flags |= IORING_ENTER_SQ_WAKEUP;
+
+                if(flags == 0)
+                    return static_cast<int>(pending);
+
+                const auto result = enter(pending, wait_for, flags);
+                return result < 0 ? result : static_cast<int>(pending);
+            }
+
+            if(pending == 0 && wait_for == 0)
+                return 0;
+
+            return enter(pending, wait_for, wait_for ? IORING_ENTER_GETEVENTS : 0);
+        }
+
+        /// \brief Calls fn(const io_uring_cqe&) for every available completion and marks
+        ///        them as consumed.
+        /// \note Every completion is consumed before fn is called with a copy of it, so fn
+        ///       can submit and reap again without seeing it a second time.
+        /// \returns The number of completions that were consumed.
+        template<class Fn>
+        unsigned reap(Fn&& fn) noexcept(noexcept(fn(std::declval<const io_uring_cqe&>())))
+        {
+            unsigned count = 0;
+            for(;; ++count) {
+                // reloaded every time as fn might have reaped as well
+                const auto head = *_cq_head;
+                if(head == __atomic_load_n(_cq_tail, __ATOMIC_ACQUIRE))
+                    return count;
+
+                const auto cqe = _cqes[head & _cq_mask];
+                __atomic_store_n(_cq_head, head + 1, __ATOMIC_RELEASE);
+                fn(cqe);
+            }
+        }
+
+        /// \brief Submits pending entries, waits for at least wait_for completions and
+        ///        dispatches all available completions to their io_ring_completion.
+        ///        Completions with zero user_data are dropped.
+        /// \note If the completion queue overflowed, the kernel keeps the completions that
+        ///       didn't fit and submission fails with -EBUSY or -EAGAIN until they are
+        ///       reaped. They are flushed to the queue and dispatched as well, and the
+        ///       entries that weren't submitted are submitted by the next call.
+        /// \returns The number of completions or -errno if submission failed.
+        int run_once(unsigned wait_for = 1) noexcept
+        {
+            const auto submitted = submit(wait_for);
+            if(submitted < 0 && !backpressure(submitted))
+                return submitted;
+
+            const auto dispatch = [](const io_uring_cqe& cqe) {
+                if(const auto completion = reinterpret_cast<io_ring_completion*>(cqe.user_data))
+                    completion->complete(completion, cqe.res, cqe.flags);
+            };
+
+            auto count = reap(dispatch);
+            while(__atomic_load_n(_sq_flags, __ATOMIC_RELAXED) & IORING_SQ_CQ_OVERFLOW) {
+                // the overflowed completions are only moved to the queue by the kernel
+                const auto result = enter(0, 0, IORING_ENTER_GETEVENTS);
+                if(result < 0 && !backpressure(result))
+                    break;
+
+                const auto flushed = reap(dispatch);
+                if(flushed == 0)
+                    break;
+                count += flushed;
+            }
+            return static_cast<int>(count);
+        }
+
+        /// \brief Registers files with the ring so they can be used with IOSQE_FIXED_FILE.
+        int register_files(const int* fds, unsigned count) noexcept
+        {
+            return INLINE_SYSCALL_T(io_uring_register)(_fd, IORING_REGISTER_FILES, fds, count);
+        }
+
+        /// \brief Registers buffers with the ring for use with IORING_OP_*_FIXED.
+        int register_buffers(const iovec* buffers, unsigned count) noexcept
+        {
+            return INLINE_SYSCALL_T(io_uring_register)(
+                _fd, IORING_REGISTER_BUFFERS, buffers, count);
+        }
+    };
+
+    namespace detail {
+
+        inline void prepare_sqe(io_uring_sqe& sqe,
+                                std::uint8_t  opcode,
+                                int           fd,
+                                const void*   address,
+                                std::uint32_t length,
+                                std::uint64_t offset) noexcept
+        {
+            std::memset(&sqe, 0, sizeof(sqe));
+            sqe.opcode = opcode;
+            sqe.fd     = fd;
+            sqe.addr   = reinterpret_cast<std::uint64_t>(address);
+            sqe.len    = length;
+            sqe.off    = offset;
+        }
+
+    } // namespace detail
+
+    /// \brief Fills in the submission queue entry for a read(2) at the given offset.
+    inline void prepare_read(
+        io_uring_sqe& sqe, int fd, void* buffer, std::uint32_t size, std::uint64_t offset) noexcept
+    {
+        detail::prepare_sqe(sqe, IORING_OP_READ, fd, buffer, size, offset);
+    }
+
+    /// \brief Fills in the submission queue entry for a write(2) at the given offset.
+    inline void prepare_write(io_uring_sqe& sqe,
+                              int           fd,
+                              const void*   buffer,
+                              std::uint32_t size,
+                              std::uint64_t offset) noexcept
+    {
+        detail::prepare_sqe(sqe, IORING_OP_WRITE, fd, buffer, size, offset);
+    }
+
+    /// \brief Fills in the submission queue entry for an accept4(2).
+    inline void prepare_accept(
+        io_uring_sqe& sqe, int fd, sockaddr* address, socklen_t* length, int flags) noexcept
+    {
+        detail::prepare_sqe(sqe, IORING_OP_ACCEPT, fd, address, 0, 0);
+        sqe.addr2        = reinterpret_cast<std::uint64_t>(length);
+        sqe.accept_flags = static_cast<std::uint32_t>(flags);
+    }
+
+    /// \brief Fills in the submission queue entry for an openat(2).
+    inline void prepare_openat(
+        io_uring_sqe& sqe, int dirfd, const char* path, int flags, unsigned mode) noexcept
+    {
+        detail::prepare_sqe(sqe, IORING_OP_OPENAT, dirfd, path, mode, 0);
+        sqe.open_flags = static_cast<std::uint32_t>(flags);
+    }
+
+#if defined(JM_INLINE_SYSCALL_IO_RING_COROUTINES)
+
+    /// \brief Awaitable that queues an operation on the ring when awaited and resumes the
+    ///        coroutine with the result of the operation once it is dispatched by
+    ///        io_ring::run_once. The operation is submitted together with everything
+    ///        else that was queued until then.
+    template<class Prepare>
+    class io_ring_operation : io_ring_completion {
+        io_ring&                _ring;
+        Prepare                 _prepare;
+        std::coroutine_handle<> _handle;
+        std::int32_t            _result = 0;
+
+        static void on_complete(io_ring_completion* self,
+                                std::int32_t        result,
+                                std::uint32_t) noexcept
+        {
+            const auto operation = static_cast<io_ring_operation*>(self);
+            operation->_result   = result;
+            operation->_handle.resume();
+        }
+
+    public:
+        io_ring_operation(io_ring& ring, Prepare prepare) noexcept
+            : io_ring_completion{ &on_complete }, _ring(ring), _prepare(prepare)
+        {}
+
+        bool await_ready() const noexcept { return false; }
+
+        bool await_suspend(std::coroutine_handle<> handle) noexcept
+        {
+            auto sqe = _ring.get_sqe();
+            if(!sqe) {
+                // make room by handing everything queued so far to the kernel
+                _ring.submit();
+                sqe = _ring.get_sqe();
+            }
+
+            if(!sqe) {
+                _result = -EBUSY;
+                return false;
+            }
+
+            _prepare(*sqe);
+            sqe->user_data =
+                reinterpret_cast<std::uint64_t>(static_cast<io_ring_completion*>(this));
+            _handle = handle;
+            return true;
+        }
+
+        /// \brief Returns the result of the operation or -errno.
+        std::int32_t await_resume() const noexcept { return _result; }
+    };
+
+    /// \brief co_await-able read(2) at the given offset.
+    inline auto async_read(
+        io_ring& ring, int fd, void* buffer, std::uint32_t size, std::uint64_t offset) noexcept
+    {
+        return io_ring_operation(ring, [=](io_uring_sqe& sqe) noexcept {
+            prepare_read(sqe, fd, buffer, size, offset);
+        });
+    }
+
+    /// \brief co_await-able write(2) at the given offset.
+    inline auto async_write(io_ring&      ring,
+                            int           fd,
+                            const void*   buffer,
+                            std::uint32_t size,
+                            std::uint64_t offset) noexcept
+    {
+        return io_ring_operation(ring, [=](io_uring_sqe& sqe) noexcept {
+            prepare_write(sqe, fd, buffer, size, offset);
+        });
+    }
+
+    /// \brief co_await-able accept4(2).
+    inline auto async_accept(io_ring&   ring,
+                             int        fd,
+                             sockaddr*  address = nullptr,
+                             socklen_t* length  = nullptr,
+                             int        flags   = 0) noexcept
+    {
+        return io_ring_operation(ring, [=](io_uring_sqe& sqe) noexcept {
+            prepare_accept(sqe, fd, address, length, flags);
+        });
+    }
+
+    /// \brief co_await-able openat(2).
+    inline auto async_openat(
+        io_ring& ring, int dirfd, const char* path, int flags, unsigned mode = 0) noexcept
+    {
+        return io_ring_operation(ring, [=](io_uring_sqe& sqe) noexcept {
+            prepare_openat(sqe, dirfd, path, flags, mode);
+        });
+    }
+
+#endif
+
+} // namespace jm
+
+#endif // JM_INLINE_SYSCALL_IO_RING_HPP
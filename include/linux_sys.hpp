@@ -0,0 +1,1423 @@
+/*
+ * Copyright 2018-2020 Justas Masiulis
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Generated by tools/linux_catalog.py from the x86-64 syscall table and the sys_*
+// prototypes of linux 6.1. Do not edit, rerun it against a newer kernel instead.
+
+#ifndef JM_INLINE_SYSCALL_LINUX_SYS_HPP
+#define JM_INLINE_SYSCALL_LINUX_SYS_HPP
+
+#include "inline_syscall.hpp"
+#include <csignal>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <sys/select.h>
+#include <sys/types.h>
+
+#if !defined(__linux__) || !defined(__x86_64__)
+#error "linux_sys.hpp is only available on x86-64 linux"
+#endif
+
+#if defined(JM_INLINE_SYSCALL_INSTRUMENTED)
+#define JM_INLINE_SYSCALL_SYS_ARGS(name) \
+    ::jm::sys::nr::name, ::jm::detail::syscall_site_of<::jm::hash(#name)>()
+#else
+#define JM_INLINE_SYSCALL_SYS_ARGS(name) ::jm::sys::nr::name
+#endif
+
+// defines jm::sys::name, which makes the syscall with its number as an immediate. The
+// call is routed like INLINE_SYSCALL, so it goes through the vDSO where there is one and
+// otherwise through the memory effects, statistics and tracing.
+#define JM_INLINE_SYSCALL_SYS(name, params, args)                 \
+    JM_INLINE_SYSCALL_FORCEINLINE long name params noexcept       \
+    {                                                             \
+        using function = ::jm::syscall_function<long params>;     \
+        return ::jm::detail::route_syscall<::jm::hash(#name)>(    \
+            function{ JM_INLINE_SYSCALL_SYS_ARGS(name) }) args;   \
+    }
+
+// the structs that the kernel reads and writes. Some of them have no userspace header
+// and have to be defined by the caller, like struct linux_dirent64 and the kernel's
+// struct sigaction, here named struct kernel_sigaction.
+struct __aio_sigset;
+struct __user_cap_data_struct;
+struct __user_cap_header_struct;
+struct clone_args;
+struct epoll_event;
+struct file_handle;
+struct futex_waitv;
+struct getcpu_cache;
+struct io_event;
+struct io_uring_params;
+struct iocb;
+struct iovec;
+struct itimerspec;
+struct itimerval;
+struct kernel_sigaction;
+struct kexec_segment;
+struct landlock_ruleset_attr;
+struct linux_dirent;
+struct linux_dirent64;
+struct mmsghdr;
+struct mount_attr;
+struct mq_attr;
+struct msgbuf;
+struct msghdr;
+struct msqid_ds;
+struct open_how;
+struct perf_event_attr;
+struct pollfd;
+struct rlimit;
+struct rlimit64;
+struct robust_list_head;
+struct rseq;
+struct rusage;
+struct sched_attr;
+struct sched_param;
+struct sembuf;
+struct shmid_ds;
+struct sigevent;
+struct sockaddr;
+struct stat;
+struct statfs;
+struct statx;
+struct sysinfo;
+struct timespec;
+struct timeval;
+struct timex;
+struct timezone;
+struct tms;
+struct ustat;
+struct utimbuf;
+struct utsname;
+union bpf_attr;
+
+namespace jm {
+
+    /// \brief The 346 syscalls of x86-64 linux with the argument types of the
+    ///        kernel. jm::sys::read(fd, buffer, size) compiles to an inlined syscall with
+    ///        the number as an immediate and returns the raw result or -errno.
+    namespace sys {
+
+        // the number of every syscall
+        namespace nr {
+            inline constexpr std::uint32_t read                    = 0;
+            inline constexpr std::uint32_t write                   = 1;
+            inline constexpr std::uint32_t open                    = 2;
+            inline constexpr std::uint32_t close                   = 3;
+            inline constexpr std::uint32_t stat                    = 4;
+            inline constexpr std::uint32_t fstat                   = 5;
+            inline constexpr std::uint32_t lstat                   = 6;
+            inline constexpr std::uint32_t poll                    = 7;
+            inline constexpr std::uint32_t lseek                   = 8;
+            inline constexpr std::uint32_t mmap                    = 9;
+            inline constexpr std::uint32_t mprotect                = 10;
+            inline constexpr std::uint32_t munmap                  = 11;
+            inline constexpr std::uint32_t brk                     = 12;
+            inline constexpr std::uint32_t rt_sigaction            = 13;
+            inline constexpr std::uint32_t rt_sigprocmask          = 14;
+            inline constexpr std::uint32_t rt_sigreturn            = 15;
+            inline constexpr std::uint32_t ioctl                   = 16;
+            inline constexpr std::uint32_t pread64                 = 17;
+            inline constexpr std::uint32_t pwrite64                = 18;
+            inline constexpr std::uint32_t readv                   = 19;
+            inline constexpr std::uint32_t writev                  = 20;
+            inline constexpr std::uint32_t access                  = 21;
+            inline constexpr std::uint32_t pipe                    = 22;
+            inline constexpr std::uint32_t select                  = 23;
+            inline constexpr std::uint32_t sched_yield             = 24;
+            inline constexpr std::uint32_t mremap                  = 25;
+            inline constexpr std::uint32_t msync                   = 26;
+            inline constexpr std::uint32_t mincore                 = 27;
+            inline constexpr std::uint32_t madvise                 = 28;
+            inline constexpr std::uint32_t shmget                  = 29;
+            inline constexpr std::uint32_t shmat                   = 30;
+            inline constexpr std::uint32_t shmctl                  = 31;
+            inline constexpr std::uint32_t dup                     = 32;
+            inline constexpr std::uint32_t dup2                    = 33;
+            inline constexpr std::uint32_t pause                   = 34;
+            inline constexpr std::uint32_t nanosleep               = 35;
+            inline constexpr std::uint32_t getitimer               = 36;
+            inline constexpr std::uint32_t alarm                   = 37;
+            inline constexpr std::uint32_t setitimer               = 38;
+            inline constexpr std::uint32_t getpid                  = 39;
+            inline constexpr std::uint32_t sendfile                = 40;
+            inline constexpr std::uint32_t socket                  = 41;
+            inline constexpr std::uint32_t connect                 = 42;
+            inline constexpr std::uint32_t accept                  = 43;
+            inline constexpr std::uint32_t sendto                  = 44;
+            inline constexpr std::uint32_t recvfrom                = 45;
+            inline constexpr std::uint32_t sendmsg                 = 46;
+            inline constexpr std::uint32_t recvmsg                 = 47;
+            inline constexpr std::uint32_t shutdown                = 48;
+            inline constexpr std::uint32_t bind                    = 49;
+            inline constexpr std::uint32_t listen                  = 50;
+            inline constexpr std::uint32_t getsockname             = 51;
+            inline constexpr std::uint32_t getpeername             = 52;
+            inline constexpr std::uint32_t socketpair              = 53;
+            inline constexpr std::uint32_t setsockopt              = 54;
+            inline constexpr std::uint32_t getsockopt              = 55;
+            inline constexpr std::uint32_t clone                   = 56;
+            inline constexpr std::uint32_t fork                    = 57;
+            inline constexpr std::uint32_t vfork                   = 58;
+            inline constexpr std::uint32_t execve                  = 59;
+            inline constexpr std::uint32_t exit                    = 60;
+            inline constexpr std::uint32_t wait4                   = 61;
+            inline constexpr std::uint32_t kill                    = 62;
+            inline constexpr std::uint32_t uname                   = 63;
+            inline constexpr std::uint32_t semget                  = 64;
+            inline constexpr std::uint32_t semop                   = 65;
+            inline constexpr std::uint32_t semctl                  = 66;
+            inline constexpr std::uint32_t shmdt                   = 67;
+            inline constexpr std::uint32_t msgget                  = 68;
+            inline constexpr std::uint32_t msgsnd                  = 69;
+            inline constexpr std::uint32_t msgrcv                  = 70;
+            inline constexpr std::uint32_t msgctl                  = 71;
+            inline constexpr std::uint32_t fcntl                   = 72;
+            inline constexpr std::uint32_t flock                   = 73;
+            inline constexpr std::uint32_t fsync                   = 74;
+            inline constexpr std::uint32_t fdatasync               = 75;
+            inline constexpr std::uint32_t truncate                = 76;
+            inline constexpr std::uint32_t ftruncate               = 77;
+            inline constexpr std::uint32_t getdents                = 78;
+            inline constexpr std::uint32_t getcwd                  = 79;
+            inline constexpr std::uint32_t chdir                   = 80;
+            inline constexpr std::uint32_t fchdir                  = 81;
+            inline constexpr std::uint32_t rename                  = 82;
+            inline constexpr std::uint32_t mkdir                   = 83;
+            inline constexpr std::uint32_t rmdir                   = 84;
+            inline constexpr std::uint32_t creat                   = 85;
+            inline constexpr std::uint32_t link                    = 86;
+            inline constexpr std::uint32_t unlink                  = 87;
+            inline constexpr std::uint32_t symlink                 = 88;
+            inline constexpr std::uint32_t readlink                = 89;
+            inline constexpr std::uint32_t chmod                   = 90;
+            inline constexpr std::uint32_t fchmod                  = 91;
+            inline constexpr std::uint32_t chown                   = 92;
+            inline constexpr std::uint32_t fchown                  = 93;
+            inline constexpr std::uint32_t lchown                  = 94;
+            inline constexpr std::uint32_t umask                   = 95;
+            inline constexpr std::uint32_t gettimeofday            = 96;
+            inline constexpr std::uint32_t getrlimit               = 97;
+            inline constexpr std::uint32_t getrusage               = 98;
+            inline constexpr std::uint32_t sysinfo                 = 99;
+            inline constexpr std::uint32_t times                   = 100;
+            inline constexpr std::uint32_t ptrace                  = 101;
+            inline constexpr std::uint32_t getuid                  = 102;
+            inline constexpr std::uint32_t syslog                  = 103;
+            inline constexpr std::uint32_t getgid                  = 104;
+            inline constexpr std::uint32_t setuid                  = 105;
+            inline constexpr std::uint32_t setgid                  = 106;
+            inline constexpr std::uint32_t geteuid                 = 107;
+            inline constexpr std::uint32_t getegid                 = 108;
+            inline constexpr std::uint32_t setpgid                 = 109;
+            inline constexpr std::uint32_t getppid                 = 110;
+            inline constexpr std::uint32_t getpgrp                 = 111;
+            inline constexpr std::uint32_t setsid                  = 112;
+            inline constexpr std::uint32_t setreuid                = 113;
+            inline constexpr std::uint32_t setregid                = 114;
+            inline constexpr std::uint32_t getgroups               = 115;
+            inline constexpr std::uint32_t setgroups               = 116;
+            inline constexpr std::uint32_t setresuid               = 117;
+            inline constexpr std::uint32_t getresuid               = 118;
+            inline constexpr std::uint32_t setresgid               = 119;
+            inline constexpr std::uint32_t getresgid               = 120;
+            inline constexpr std::uint32_t getpgid                 = 121;
+            inline constexpr std::uint32_t setfsuid                = 122;
+            inline constexpr std::uint32_t setfsgid                = 123;
+            inline constexpr std::uint32_t getsid                  = 124;
+            inline constexpr std::uint32_t capget                  = 125;
+            inline constexpr std::uint32_t capset                  = 126;
+            inline constexpr std::uint32_t rt_sigpending           = 127;
+            inline constexpr std::uint32_t rt_sigtimedwait         = 128;
+            inline constexpr std::uint32_t rt_sigqueueinfo         = 129;
+            inline constexpr std::uint32_t rt_sigsuspend           = 130;
+            inline constexpr std::uint32_t sigaltstack             = 131;
+            inline constexpr std::uint32_t utime                   = 132;
+            inline constexpr std::uint32_t mknod                   = 133;
+            inline constexpr std::uint32_t personality             = 135;
+            inline constexpr std::uint32_t ustat                   = 136;
+            inline constexpr std::uint32_t statfs                  = 137;
+            inline constexpr std::uint32_t fstatfs                 = 138;
+            inline constexpr std::uint32_t sysfs                   = 139;
+            inline constexpr std::uint32_t getpriority             = 140;
+            inline constexpr std::uint32_t setpriority             = 141;
+            inline constexpr std::uint32_t sched_setparam          = 142;
+            inline constexpr std::uint32_t sched_getparam          = 143;
+            inline constexpr std::uint32_t sched_setscheduler      = 144;
+            inline constexpr std::uint32_t sched_getscheduler      = 145;
+            inline constexpr std::uint32_t sched_get_priority_max  = 146;
+            inline constexpr std::uint32_t sched_get_priority_min  = 147;
+            inline constexpr std::uint32_t sched_rr_get_interval   = 148;
+            inline constexpr std::uint32_t mlock                   = 149;
+            inline constexpr std::uint32_t munlock                 = 150;
+            inline constexpr std::uint32_t mlockall                = 151;
+            inline constexpr std::uint32_t munlockall              = 152;
+            inline constexpr std::uint32_t vhangup                 = 153;
+            inline constexpr std::uint32_t modify_ldt              = 154;
+            inline constexpr std::uint32_t pivot_root              = 155;
+            inline constexpr std::uint32_t prctl                   = 157;
+            inline constexpr std::uint32_t arch_prctl              = 158;
+            inline constexpr std::uint32_t adjtimex                = 159;
+            inline constexpr std::uint32_t setrlimit               = 160;
+            inline constexpr std::uint32_t chroot                  = 161;
+            inline constexpr std::uint32_t sync                    = 162;
+            inline constexpr std::uint32_t acct                    = 163;
+            inline constexpr std::uint32_t settimeofday            = 164;
+            inline constexpr std::uint32_t mount                   = 165;
+            inline constexpr std::uint32_t umount2                 = 166;
+            inline constexpr std::uint32_t swapon                  = 167;
+            inline constexpr std::uint32_t swapoff                 = 168;
+            inline constexpr std::uint32_t reboot                  = 169;
+            inline constexpr std::uint32_t sethostname             = 170;
+            inline constexpr std::uint32_t setdomainname           = 171;
+            inline constexpr std::uint32_t iopl                    = 172;
+            inline constexpr std::uint32_t ioperm                  = 173;
+            inline constexpr std::uint32_t init_module             = 175;
+            inline constexpr std::uint32_t delete_module           = 176;
+            inline constexpr std::uint32_t quotactl                = 179;
+            inline constexpr std::uint32_t gettid                  = 186;
+            inline constexpr std::uint32_t readahead               = 187;
+            inline constexpr std::uint32_t setxattr                = 188;
+            inline constexpr std::uint32_t lsetxattr               = 189;
+            inline constexpr std::uint32_t fsetxattr               = 190;
+            inline constexpr std::uint32_t getxattr                = 191;
+            inline constexpr std::uint32_t lgetxattr               = 192;
+            inline constexpr std::uint32_t fgetxattr               = 193;
+            inline constexpr std::uint32_t listxattr               = 194;
+            inline constexpr std::uint32_t llistxattr              = 195;
+            inline constexpr std::uint32_t flistxattr              = 196;
+            inline constexpr std::uint32_t removexattr             = 197;
+            inline constexpr std::uint32_t lremovexattr            = 198;
+            inline constexpr std::uint32_t fremovexattr            = 199;
+            inline constexpr std::uint32_t tkill                   = 200;
+            inline constexpr std::uint32_t time                    = 201;
+            inline constexpr std::uint32_t futex                   = 202;
+            inline constexpr std::uint32_t sched_setaffinity       = 203;
+            inline constexpr std::uint32_t sched_getaffinity       = 204;
+            inline constexpr std::uint32_t io_setup                = 206;
+            inline constexpr std::uint32_t io_destroy              = 207;
+            inline constexpr std::uint32_t io_getevents            = 208;
+            inline constexpr std::uint32_t io_submit               = 209;
+            inline constexpr std::uint32_t io_cancel               = 210;
+            inline constexpr std::uint32_t lookup_dcookie          = 212;
+            inline constexpr std::uint32_t epoll_create            = 213;
+            inline constexpr std::uint32_t remap_file_pages        = 216;
+            inline constexpr std::uint32_t getdents64              = 217;
+            inline constexpr std::uint32_t set_tid_address         = 218;
+            inline constexpr std::uint32_t restart_syscall         = 219;
+            inline constexpr std::uint32_t semtimedop              = 220;
+            inline constexpr std::uint32_t fadvise64               = 221;
+            inline constexpr std::uint32_t timer_create            = 222;
+            inline constexpr std::uint32_t timer_settime           = 223;
+            inline constexpr std::uint32_t timer_gettime           = 224;
+            inline constexpr std::uint32_t timer_getoverrun        = 225;
+            inline constexpr std::uint32_t timer_delete            = 226;
+            inline constexpr std::uint32_t clock_settime           = 227;
+            inline constexpr std::uint32_t clock_gettime           = 228;
+            inline constexpr std::uint32_t clock_getres            = 229;
+            inline constexpr std::uint32_t clock_nanosleep         = 230;
+            inline constexpr std::uint32_t exit_group              = 231;
+            inline constexpr std::uint32_t epoll_wait              = 232;
+            inline constexpr std::uint32_t epoll_ctl               = 233;
+            inline constexpr std::uint32_t tgkill                  = 234;
+            inline constexpr std::uint32_t utimes                  = 235;
+            inline constexpr std::uint32_t mbind                   = 237;
+            inline constexpr std::uint32_t set_mempolicy           = 238;
+            inline constexpr std::uint32_t get_mempolicy           = 239;
+            inline constexpr std::uint32_t mq_open                 = 240;
+            inline constexpr std::uint32_t mq_unlink               = 241;
+            inline constexpr std::uint32_t mq_timedsend            = 242;
+            inline constexpr std::uint32_t mq_timedreceive         = 243;
+            inline constexpr std::uint32_t mq_notify               = 244;
+            inline constexpr std::uint32_t mq_getsetattr           = 245;
+            inline constexpr std::uint32_t kexec_load              = 246;
+            inline constexpr std::uint32_t waitid                  = 247;
+            inline constexpr std::uint32_t add_key                 = 248;
+            inline constexpr std::uint32_t request_key             = 249;
+            inline constexpr std::uint32_t keyctl                  = 250;
+            inline constexpr std::uint32_t ioprio_set              = 251;
+            inline constexpr std::uint32_t ioprio_get              = 252;
+            inline constexpr std::uint32_t inotify_init            = 253;
+            inline constexpr std::uint32_t inotify_add_watch       = 254;
+            inline constexpr std::uint32_t inotify_rm_watch        = 255;
+            inline constexpr std::uint32_t migrate_pages           = 256;
+            inline constexpr std::uint32_t openat                  = 257;
+            inline constexpr std::uint32_t mkdirat                 = 258;
+            inline constexpr std::uint32_t mknodat                 = 259;
+            inline constexpr std::uint32_t fchownat                = 260;
+            inline constexpr std::uint32_t futimesat               = 261;
+            inline constexpr std::uint32_t newfstatat              = 262;
+            inline constexpr std::uint32_t unlinkat                = 263;
+            inline constexpr std::uint32_t renameat                = 264;
+            inline constexpr std::uint32_t linkat                  = 265;
+            inline constexpr std::uint32_t symlinkat               = 266;
+            inline constexpr std::uint32_t readlinkat              = 267;
+            inline constexpr std::uint32_t fchmodat                = 268;
+            inline constexpr std::uint32_t faccessat               = 269;
+            inline constexpr std::uint32_t pselect6                = 270;
+            inline constexpr std::uint32_t ppoll                   = 271;
+            inline constexpr std::uint32_t unshare                 = 272;
+            inline constexpr std::uint32_t set_robust_list         = 273;
+            inline constexpr std::uint32_t get_robust_list         = 274;
+            inline constexpr std::uint32_t splice                  = 275;
+            inline constexpr std::uint32_t tee                     = 276;
+            inline constexpr std::uint32_t sync_file_range         = 277;
+            inline constexpr std::uint32_t vmsplice                = 278;
+            inline constexpr std::uint32_t move_pages              = 279;
+            inline constexpr std::uint32_t utimensat               = 280;
+            inline constexpr std::uint32_t epoll_pwait             = 281;
+            inline constexpr std::uint32_t signalfd                = 282;
+            inline constexpr std::uint32_t timerfd_create          = 283;
+            inline constexpr std::uint32_t eventfd                 = 284;
+            inline constexpr std::uint32_t fallocate               = 285;
+            inline constexpr std::uint32_t timerfd_settime         = 286;
+            inline constexpr std::uint32_t timerfd_gettime         = 287;
+            inline constexpr std::uint32_t accept4                 = 288;
+            inline constexpr std::uint32_t signalfd4               = 289;
+            inline constexpr std::uint32_t eventfd2                = 290;
+            inline constexpr std::uint32_t epoll_create1           = 291;
+            inline constexpr std::uint32_t dup3                    = 292;
+            inline constexpr std::uint32_t pipe2                   = 293;
+            inline constexpr std::uint32_t inotify_init1           = 294;
+            inline constexpr std::uint32_t preadv                  = 295;
+            inline constexpr std::uint32_t pwritev                 = 296;
+            inline constexpr std::uint32_t rt_tgsigqueueinfo       = 297;
+            inline constexpr std::uint32_t perf_event_open         = 298;
+            inline constexpr std::uint32_t recvmmsg                = 299;
+            inline constexpr std::uint32_t fanotify_init           = 300;
+            inline constexpr std::uint32_t fanotify_mark           = 301;
+            inline constexpr std::uint32_t prlimit64               = 302;
+            inline constexpr std::uint32_t name_to_handle_at       = 303;
+            inline constexpr std::uint32_t open_by_handle_at       = 304;
+            inline constexpr std::uint32_t clock_adjtime           = 305;
+            inline constexpr std::uint32_t syncfs                  = 306;
+            inline constexpr std::uint32_t sendmmsg                = 307;
+            inline constexpr std::uint32_t setns                   = 308;
+            inline constexpr std::uint32_t getcpu                  = 309;
+            inline constexpr std::uint32_t process_vm_readv        = 310;
+            inline constexpr std::uint32_t process_vm_writev       = 311;
+            inline constexpr std::uint32_t kcmp                    = 312;
+            inline constexpr std::uint32_t finit_module            = 313;
+            inline constexpr std::uint32_t sched_setattr           = 314;
+            inline constexpr std::uint32_t sched_getattr           = 315;
+            inline constexpr std::uint32_t renameat2               = 316;
+            inline constexpr std::uint32_t seccomp                 = 317;
+            inline constexpr std::uint32_t getrandom               = 318;
+            inline constexpr std::uint32_t memfd_create            = 319;
+            inline constexpr std::uint32_t kexec_file_load         = 320;
+            inline constexpr std::uint32_t bpf                     = 321;
+            inline constexpr std::uint32_t execveat                = 322;
+            inline constexpr std::uint32_t userfaultfd             = 323;
+            inline constexpr std::uint32_t membarrier              = 324;
+            inline constexpr std::uint32_t mlock2                  = 325;
+            inline constexpr std::uint32_t copy_file_range         = 326;
+            inline constexpr std::uint32_t preadv2                 = 327;
+            inline constexpr std::uint32_t pwritev2                = 328;
+            inline constexpr std::uint32_t pkey_mprotect           = 329;
+            inline constexpr std::uint32_t pkey_alloc              = 330;
+            inline constexpr std::uint32_t pkey_free               = 331;
+            inline constexpr std::uint32_t statx                   = 332;
+            inline constexpr std::uint32_t io_pgetevents           = 333;
+            inline constexpr std::uint32_t rseq                    = 334;
+            inline constexpr std::uint32_t pidfd_send_signal       = 424;
+            inline constexpr std::uint32_t io_uring_setup          = 425;
+            inline constexpr std::uint32_t io_uring_enter          = 426;
+            inline constexpr std::uint32_t io_uring_register       = 427;
+            inline constexpr std::uint32_t open_tree               = 428;
+            inline constexpr std::uint32_t move_mount              = 429;
+            inline constexpr std::uint32_t fsopen                  = 430;
+            inline constexpr std::uint32_t fsconfig                = 431;
+            inline constexpr std::uint32_t fsmount                 = 432;
+            inline constexpr std::uint32_t fspick                  = 433;
+            inline constexpr std::uint32_t pidfd_open              = 434;
+            inline constexpr std::uint32_t clone3                  = 435;
+            inline constexpr std::uint32_t close_range             = 436;
+            inline constexpr std::uint32_t openat2                 = 437;
+            inline constexpr std::uint32_t pidfd_getfd             = 438;
+            inline constexpr std::uint32_t faccessat2              = 439;
+            inline constexpr std::uint32_t process_madvise         = 440;
+            inline constexpr std::uint32_t epoll_pwait2            = 441;
+            inline constexpr std::uint32_t mount_setattr           = 442;
+            inline constexpr std::uint32_t quotactl_fd             = 443;
+            inline constexpr std::uint32_t landlock_create_ruleset = 444;
+            inline constexpr std::uint32_t landlock_add_rule       = 445;
+            inline constexpr std::uint32_t landlock_restrict_self  = 446;
+            inline constexpr std::uint32_t memfd_secret            = 447;
+            inline constexpr std::uint32_t process_mrelease        = 448;
+            inline constexpr std::uint32_t futex_waitv             = 449;
+            inline constexpr std::uint32_t set_mempolicy_home_node = 450;
+        } // namespace nr
+
+        JM_INLINE_SYSCALL_SYS(read,
+                              (unsigned int fd, char* buf, std::size_t count),
+                              (fd, buf, count))
+        JM_INLINE_SYSCALL_SYS(write,
+                              (unsigned int fd, const char* buf, std::size_t count),
+                              (fd, buf, count))
+        JM_INLINE_SYSCALL_SYS(open,
+                              (const char* filename, int flags, mode_t mode),
+                              (filename, flags, mode))
+        JM_INLINE_SYSCALL_SYS(close, (unsigned int fd), (fd))
+        JM_INLINE_SYSCALL_SYS(stat,
+                              (const char* filename, struct stat* statbuf),
+                              (filename, statbuf))
+        JM_INLINE_SYSCALL_SYS(fstat, (unsigned int fd, struct stat* statbuf), (fd, statbuf))
+        JM_INLINE_SYSCALL_SYS(lstat,
+                              (const char* filename, struct stat* statbuf),
+                              (filename, statbuf))
+        JM_INLINE_SYSCALL_SYS(poll,
+                              (struct pollfd* ufds, unsigned int nfds, int timeout),
+                              (ufds, nfds, timeout))
+        JM_INLINE_SYSCALL_SYS(lseek,
+                              (unsigned int fd, off_t offset, unsigned int whence),
+                              (fd, offset, whence))
+        JM_INLINE_SYSCALL_SYS(mmap,
+                              (unsigned long addr, unsigned long len, unsigned long prot,
+                               unsigned long flags, unsigned long fd, unsigned long off),
+                              (addr, len, prot, flags, fd, off))
+        JM_INLINE_SYSCALL_SYS(mprotect,
+                              (unsigned long start, std::size_t len, unsigned long prot),
+                              (start, len, prot))
+        JM_INLINE_SYSCALL_SYS(munmap, (unsigned long addr, std::size_t len), (addr, len))
+        JM_INLINE_SYSCALL_SYS(brk, (unsigned long brk_), (brk_))
+        JM_INLINE_SYSCALL_SYS(rt_sigaction,
+                              (int a0, const struct kernel_sigaction* a1,
+                               struct kernel_sigaction* a2, std::size_t a3),
+                              (a0, a1, a2, a3))
+        JM_INLINE_SYSCALL_SYS(rt_sigprocmask,
+                              (int how, sigset_t* set, sigset_t* oset,
+                               std::size_t sigsetsize),
+                              (how, set, oset, sigsetsize))
+        JM_INLINE_SYSCALL_SYS(rt_sigreturn, (), ())
+        JM_INLINE_SYSCALL_SYS(ioctl,
+                              (unsigned int fd, unsigned int cmd, unsigned long arg),
+                              (fd, cmd, arg))
+        JM_INLINE_SYSCALL_SYS(pread64,
+                              (unsigned int fd, char* buf, std::size_t count,
+                               long long pos),
+                              (fd, buf, count, pos))
+        JM_INLINE_SYSCALL_SYS(pwrite64,
+                              (unsigned int fd, const char* buf, std::size_t count,
+                               long long pos),
+                              (fd, buf, count, pos))
+        JM_INLINE_SYSCALL_SYS(readv,
+                              (unsigned long fd, const struct iovec* vec,
+                               unsigned long vlen),
+                              (fd, vec, vlen))
+        JM_INLINE_SYSCALL_SYS(writev,
+                              (unsigned long fd, const struct iovec* vec,
+                               unsigned long vlen),
+                              (fd, vec, vlen))
+        JM_INLINE_SYSCALL_SYS(access, (const char* filename, int mode), (filename, mode))
+        JM_INLINE_SYSCALL_SYS(pipe, (int* fildes), (fildes))
+        JM_INLINE_SYSCALL_SYS(select,
+                              (int n, fd_set* inp, fd_set* outp, fd_set* exp,
+                               struct timeval* tvp),
+                              (n, inp, outp, exp, tvp))
+        JM_INLINE_SYSCALL_SYS(sched_yield, (), ())
+        JM_INLINE_SYSCALL_SYS(mremap,
+                              (unsigned long addr, unsigned long old_len,
+                               unsigned long new_len, unsigned long flags,
+                               unsigned long new_addr),
+                              (addr, old_len, new_len, flags, new_addr))
+        JM_INLINE_SYSCALL_SYS(msync,
+                              (unsigned long start, std::size_t len, int flags),
+                              (start, len, flags))
+        JM_INLINE_SYSCALL_SYS(mincore,
+                              (unsigned long start, std::size_t len, unsigned char* vec),
+                              (start, len, vec))
+        JM_INLINE_SYSCALL_SYS(madvise,
+                              (unsigned long start, std::size_t len, int behavior),
+                              (start, len, behavior))
+        JM_INLINE_SYSCALL_SYS(shmget,
+                              (key_t key, std::size_t size, int flag),
+                              (key, size, flag))
+        JM_INLINE_SYSCALL_SYS(shmat,
+                              (int shmid, char* shmaddr, int shmflg),
+                              (shmid, shmaddr, shmflg))
+        JM_INLINE_SYSCALL_SYS(shmctl,
+                              (int shmid, int cmd, struct shmid_ds* buf),
+                              (shmid, cmd, buf))
+        JM_INLINE_SYSCALL_SYS(dup, (unsigned int fildes), (fildes))
+        JM_INLINE_SYSCALL_SYS(dup2,
+                              (unsigned int oldfd, unsigned int newfd),
+                              (oldfd, newfd))
+        JM_INLINE_SYSCALL_SYS(pause, (), ())
+        JM_INLINE_SYSCALL_SYS(nanosleep,
+                              (struct timespec* rqtp, struct timespec* rmtp),
+                              (rqtp, rmtp))
+        JM_INLINE_SYSCALL_SYS(getitimer,
+                              (int which, struct itimerval* value),
+                              (which, value))
+        JM_INLINE_SYSCALL_SYS(alarm, (unsigned int seconds), (seconds))
+        JM_INLINE_SYSCALL_SYS(setitimer,
+                              (int which, struct itimerval* value,
+                               struct itimerval* ovalue),
+                              (which, value, ovalue))
+        JM_INLINE_SYSCALL_SYS(getpid, (), ())
+        JM_INLINE_SYSCALL_SYS(sendfile,
+                              (int out_fd, int in_fd, long long* offset, std::size_t count),
+                              (out_fd, in_fd, offset, count))
+        JM_INLINE_SYSCALL_SYS(socket, (int a0, int a1, int a2), (a0, a1, a2))
+        JM_INLINE_SYSCALL_SYS(connect, (int a0, struct sockaddr* a1, int a2), (a0, a1, a2))
+        JM_INLINE_SYSCALL_SYS(accept, (int a0, struct sockaddr* a1, int* a2), (a0, a1, a2))
+        JM_INLINE_SYSCALL_SYS(sendto,
+                              (int a0, void* a1, std::size_t a2, unsigned int a3,
+                               struct sockaddr* a4, int a5),
+                              (a0, a1, a2, a3, a4, a5))
+        JM_INLINE_SYSCALL_SYS(recvfrom,
+                              (int a0, void* a1, std::size_t a2, unsigned int a3,
+                               struct sockaddr* a4, int* a5),
+                              (a0, a1, a2, a3, a4, a5))
+        JM_INLINE_SYSCALL_SYS(sendmsg,
+                              (int fd, struct msghdr* msg, unsigned int flags),
+                              (fd, msg, flags))
+        JM_INLINE_SYSCALL_SYS(recvmsg,
+                              (int fd, struct msghdr* msg, unsigned int flags),
+                              (fd, msg, flags))
+        JM_INLINE_SYSCALL_SYS(shutdown, (int a0, int a1), (a0, a1))
+        JM_INLINE_SYSCALL_SYS(bind, (int a0, struct sockaddr* a1, int a2), (a0, a1, a2))
+        JM_INLINE_SYSCALL_SYS(listen, (int a0, int a1), (a0, a1))
+        JM_INLINE_SYSCALL_SYS(getsockname,
+                              (int a0, struct sockaddr* a1, int* a2),
+                              (a0, a1, a2))
+        JM_INLINE_SYSCALL_SYS(getpeername,
+                              (int a0, struct sockaddr* a1, int* a2),
+                              (a0, a1, a2))
+        JM_INLINE_SYSCALL_SYS(socketpair,
+                              (int a0, int a1, int a2, int* a3),
+                              (a0, a1, a2, a3))
+        JM_INLINE_SYSCALL_SYS(setsockopt,
+                              (int fd, int level, int optname, char* optval, int optlen),
+                              (fd, level, optname, optval, optlen))
+        JM_INLINE_SYSCALL_SYS(getsockopt,
+                              (int fd, int level, int optname, char* optval, int* optlen),
+                              (fd, level, optname, optval, optlen))
+        JM_INLINE_SYSCALL_SYS(clone,
+                              (unsigned long a0, unsigned long a1, int* a2, int* a3,
+                               unsigned long a4),
+                              (a0, a1, a2, a3, a4))
+        JM_INLINE_SYSCALL_SYS(fork, (), ())
+        JM_INLINE_SYSCALL_SYS(vfork, (), ())
+        JM_INLINE_SYSCALL_SYS(execve,
+                              (const char* filename, const char* const* argv,
+                               const char* const* envp),
+                              (filename, argv, envp))
+        JM_INLINE_SYSCALL_SYS(exit, (int error_code), (error_code))
+        JM_INLINE_SYSCALL_SYS(wait4,
+                              (pid_t pid, int* stat_addr, int options, struct rusage* ru),
+                              (pid, stat_addr, options, ru))
+        JM_INLINE_SYSCALL_SYS(kill, (pid_t pid, int sig), (pid, sig))
+        JM_INLINE_SYSCALL_SYS(uname, (struct utsname* name), (name))
+        JM_INLINE_SYSCALL_SYS(semget,
+                              (key_t key, int nsems, int semflg),
+                              (key, nsems, semflg))
+        JM_INLINE_SYSCALL_SYS(semop,
+                              (int semid, struct sembuf* sops, unsigned int nsops),
+                              (semid, sops, nsops))
+        JM_INLINE_SYSCALL_SYS(semctl,
+                              (int semid, int semnum, int cmd, unsigned long arg),
+                              (semid, semnum, cmd, arg))
+        JM_INLINE_SYSCALL_SYS(shmdt, (char* shmaddr), (shmaddr))
+        JM_INLINE_SYSCALL_SYS(msgget, (key_t key, int msgflg), (key, msgflg))
+        JM_INLINE_SYSCALL_SYS(msgsnd,
+                              (int msqid, struct msgbuf* msgp, std::size_t msgsz,
+                               int msgflg),
+                              (msqid, msgp, msgsz, msgflg))
+        JM_INLINE_SYSCALL_SYS(msgrcv,
+                              (int msqid, struct msgbuf* msgp, std::size_t msgsz,
+                               long msgtyp, int msgflg),
+                              (msqid, msgp, msgsz, msgtyp, msgflg))
+        JM_INLINE_SYSCALL_SYS(msgctl,
+                              (int msqid, int cmd, struct msqid_ds* buf),
+                              (msqid, cmd, buf))
+        JM_INLINE_SYSCALL_SYS(fcntl,
+                              (unsigned int fd, unsigned int cmd, unsigned long arg),
+                              (fd, cmd, arg))
+        JM_INLINE_SYSCALL_SYS(flock, (unsigned int fd, unsigned int cmd), (fd, cmd))
+        JM_INLINE_SYSCALL_SYS(fsync, (unsigned int fd), (fd))
+        JM_INLINE_SYSCALL_SYS(fdatasync, (unsigned int fd), (fd))
+        JM_INLINE_SYSCALL_SYS(truncate, (const char* path, long length), (path, length))
+        JM_INLINE_SYSCALL_SYS(ftruncate,
+                              (unsigned int fd, unsigned long length),
+                              (fd, length))
+        JM_INLINE_SYSCALL_SYS(getdents,
+                              (unsigned int fd, struct linux_dirent* dirent,
+                               unsigned int count),
+                              (fd, dirent, count))
+        JM_INLINE_SYSCALL_SYS(getcwd, (char* buf, unsigned long size), (buf, size))
+        JM_INLINE_SYSCALL_SYS(chdir, (const char* filename), (filename))
+        JM_INLINE_SYSCALL_SYS(fchdir, (unsigned int fd), (fd))
+        JM_INLINE_SYSCALL_SYS(rename,
+                              (const char* oldname, const char* newname),
+                              (oldname, newname))
+        JM_INLINE_SYSCALL_SYS(mkdir, (const char* pathname, mode_t mode), (pathname, mode))
+        JM_INLINE_SYSCALL_SYS(rmdir, (const char* pathname), (pathname))
+        JM_INLINE_SYSCALL_SYS(creat, (const char* pathname, mode_t mode), (pathname, mode))
+        JM_INLINE_SYSCALL_SYS(link,
+                              (const char* oldname, const char* newname),
+                              (oldname, newname))
+        JM_INLINE_SYSCALL_SYS(unlink, (const char* pathname), (pathname))
+        JM_INLINE_SYSCALL_SYS(symlink, (const char* old, const char* new_), (old, new_))
+        JM_INLINE_SYSCALL_SYS(readlink,
+                              (const char* path, char* buf, int bufsiz),
+                              (path, buf, bufsiz))
+        JM_INLINE_SYSCALL_SYS(chmod, (const char* filename, mode_t mode), (filename, mode))
+        JM_INLINE_SYSCALL_SYS(fchmod, (unsigned int fd, mode_t mode), (fd, mode))
+        JM_INLINE_SYSCALL_SYS(chown,
+                              (const char* filename, uid_t user, gid_t group),
+                              (filename, user, group))
+        JM_INLINE_SYSCALL_SYS(fchown,
+                              (unsigned int fd, uid_t user, gid_t group),
+                              (fd, user, group))
+        JM_INLINE_SYSCALL_SYS(lchown,
+                              (const char* filename, uid_t user, gid_t group),
+                              (filename, user, group))
+        JM_INLINE_SYSCALL_SYS(umask, (int mask), (mask))
+        JM_INLINE_SYSCALL_SYS(gettimeofday,
+                              (struct timeval* tv, struct timezone* tz),
+                              (tv, tz))
+        JM_INLINE_SYSCALL_SYS(getrlimit,
+                              (unsigned int resource, struct rlimit* rlim),
+                              (resource, rlim))
+        JM_INLINE_SYSCALL_SYS(getrusage, (int who, struct rusage* ru), (who, ru))
+        JM_INLINE_SYSCALL_SYS(sysinfo, (struct sysinfo* info), (info))
+        JM_INLINE_SYSCALL_SYS(times, (struct tms* tbuf), (tbuf))
+        JM_INLINE_SYSCALL_SYS(ptrace,
+                              (long request, long pid, unsigned long addr,
+                               unsigned long data),
+                              (request, pid, addr, data))
+        JM_INLINE_SYSCALL_SYS(getuid, (), ())
+        JM_INLINE_SYSCALL_SYS(syslog, (int type, char* buf, int len), (type, buf, len))
+        JM_INLINE_SYSCALL_SYS(getgid, (), ())
+        JM_INLINE_SYSCALL_SYS(setuid, (uid_t uid), (uid))
+        JM_INLINE_SYSCALL_SYS(setgid, (gid_t gid), (gid))
+        JM_INLINE_SYSCALL_SYS(geteuid, (), ())
+        JM_INLINE_SYSCALL_SYS(getegid, (), ())
+        JM_INLINE_SYSCALL_SYS(setpgid, (pid_t pid, pid_t pgid), (pid, pgid))
+        JM_INLINE_SYSCALL_SYS(getppid, (), ())
+        JM_INLINE_SYSCALL_SYS(getpgrp, (), ())
+        JM_INLINE_SYSCALL_SYS(setsid, (), ())
+        JM_INLINE_SYSCALL_SYS(setreuid, (uid_t ruid, uid_t euid), (ruid, euid))
+        JM_INLINE_SYSCALL_SYS(setregid, (gid_t rgid, gid_t egid), (rgid, egid))
+        JM_INLINE_SYSCALL_SYS(getgroups,
+                              (int gidsetsize, gid_t* grouplist),
+                              (gidsetsize, grouplist))
+        JM_INLINE_SYSCALL_SYS(setgroups,
+                              (int gidsetsize, gid_t* grouplist),
+                              (gidsetsize, grouplist))
+        JM_INLINE_SYSCALL_SYS(setresuid,
+                              (uid_t ruid, uid_t euid, uid_t suid),
+                              (ruid, euid, suid))
+        JM_INLINE_SYSCALL_SYS(getresuid,
+                              (uid_t* ruid, uid_t* euid, uid_t* suid),
+                              (ruid, euid, suid))
+        JM_INLINE_SYSCALL_SYS(setresgid,
+                              (gid_t rgid, gid_t egid, gid_t sgid),
+                              (rgid, egid, sgid))
+        JM_INLINE_SYSCALL_SYS(getresgid,
+                              (gid_t* rgid, gid_t* egid, gid_t* sgid),
+                              (rgid, egid, sgid))
+        JM_INLINE_SYSCALL_SYS(getpgid, (pid_t pid), (pid))
+        JM_INLINE_SYSCALL_SYS(setfsuid, (uid_t uid), (uid))
+        JM_INLINE_SYSCALL_SYS(setfsgid, (gid_t gid), (gid))
+        JM_INLINE_SYSCALL_SYS(getsid, (pid_t pid), (pid))
+        JM_INLINE_SYSCALL_SYS(capget,
+                              (struct __user_cap_header_struct* header,
+                               struct __user_cap_data_struct* dataptr),
+                              (header, dataptr))
+        JM_INLINE_SYSCALL_SYS(capset,
+                              (struct __user_cap_header_struct* header,
+                               const struct __user_cap_data_struct* data),
+                              (header, data))
+        JM_INLINE_SYSCALL_SYS(rt_sigpending,
+                              (sigset_t* set, std::size_t sigsetsize),
+                              (set, sigsetsize))
+        JM_INLINE_SYSCALL_SYS(rt_sigtimedwait,
+                              (const sigset_t* uthese, siginfo_t* uinfo,
+                               const struct timespec* uts, std::size_t sigsetsize),
+                              (uthese, uinfo, uts, sigsetsize))
+        JM_INLINE_SYSCALL_SYS(rt_sigqueueinfo,
+                              (pid_t pid, int sig, siginfo_t* uinfo),
+                              (pid, sig, uinfo))
+        JM_INLINE_SYSCALL_SYS(rt_sigsuspend,
+                              (sigset_t* unewset, std::size_t sigsetsize),
+                              (unewset, sigsetsize))
+        JM_INLINE_SYSCALL_SYS(sigaltstack, (const stack_t* uss, stack_t* uoss), (uss, uoss))
+        JM_INLINE_SYSCALL_SYS(utime,
+                              (char* filename, struct utimbuf* times),
+                              (filename, times))
+        JM_INLINE_SYSCALL_SYS(mknod,
+                              (const char* filename, mode_t mode, unsigned int dev),
+                              (filename, mode, dev))
+        JM_INLINE_SYSCALL_SYS(personality, (unsigned int personality_), (personality_))
+        JM_INLINE_SYSCALL_SYS(ustat, (unsigned int dev, struct ustat* ubuf), (dev, ubuf))
+        JM_INLINE_SYSCALL_SYS(statfs, (const char* path, struct statfs* buf), (path, buf))
+        JM_INLINE_SYSCALL_SYS(fstatfs, (unsigned int fd, struct statfs* buf), (fd, buf))
+        JM_INLINE_SYSCALL_SYS(sysfs,
+                              (int option, unsigned long arg1, unsigned long arg2),
+                              (option, arg1, arg2))
+        JM_INLINE_SYSCALL_SYS(getpriority, (int which, int who), (which, who))
+        JM_INLINE_SYSCALL_SYS(setpriority,
+                              (int which, int who, int niceval),
+                              (which, who, niceval))
+        JM_INLINE_SYSCALL_SYS(sched_setparam,
+                              (pid_t pid, struct sched_param* param),
+                              (pid, param))
+        JM_INLINE_SYSCALL_SYS(sched_getparam,
+                              (pid_t pid, struct sched_param* param),
+                              (pid, param))
+        JM_INLINE_SYSCALL_SYS(sched_setscheduler,
+                              (pid_t pid, int policy, struct sched_param* param),
+                              (pid, policy, param))
+        JM_INLINE_SYSCALL_SYS(sched_getscheduler, (pid_t pid), (pid))
+        JM_INLINE_SYSCALL_SYS(sched_get_priority_max, (int policy), (policy))
+        JM_INLINE_SYSCALL_SYS(sched_get_priority_min, (int policy), (policy))
+        JM_INLINE_SYSCALL_SYS(sched_rr_get_interval,
+                              (pid_t pid, struct timespec* interval),
+                              (pid, interval))
+        JM_INLINE_SYSCALL_SYS(mlock, (unsigned long start, std::size_t len), (start, len))
+        JM_INLINE_SYSCALL_SYS(munlock, (unsigned long start, std::size_t len), (start, len))
+        JM_INLINE_SYSCALL_SYS(mlockall, (int flags), (flags))
+        JM_INLINE_SYSCALL_SYS(munlockall, (), ())
+        JM_INLINE_SYSCALL_SYS(vhangup, (), ())
+        JM_INLINE_SYSCALL_SYS(modify_ldt,
+                              (int func, void* ptr, unsigned long bytecount),
+                              (func, ptr, bytecount))
+        JM_INLINE_SYSCALL_SYS(pivot_root,
+                              (const char* new_root, const char* put_old),
+                              (new_root, put_old))
+        JM_INLINE_SYSCALL_SYS(prctl,
+                              (int option, unsigned long arg2, unsigned long arg3,
+                               unsigned long arg4, unsigned long arg5),
+                              (option, arg2, arg3, arg4, arg5))
+        JM_INLINE_SYSCALL_SYS(arch_prctl, (int option, unsigned long arg2), (option, arg2))
+        JM_INLINE_SYSCALL_SYS(adjtimex, (struct timex* txc_p), (txc_p))
+        JM_INLINE_SYSCALL_SYS(setrlimit,
+                              (unsigned int resource, struct rlimit* rlim),
+                              (resource, rlim))
+        JM_INLINE_SYSCALL_SYS(chroot, (const char* filename), (filename))
+        JM_INLINE_SYSCALL_SYS(sync, (), ())
+        JM_INLINE_SYSCALL_SYS(acct, (const char* name), (name))
+        JM_INLINE_SYSCALL_SYS(settimeofday,
+                              (struct timeval* tv, struct timezone* tz),
+                              (tv, tz))
+        JM_INLINE_SYSCALL_SYS(mount,
+                              (char* dev_name, char* dir_name, char* type,
+                               unsigned long flags, void* data),
+                              (dev_name, dir_name, type, flags, data))
+        JM_INLINE_SYSCALL_SYS(umount2, (char* name, int flags), (name, flags))
+        JM_INLINE_SYSCALL_SYS(swapon,
+                              (const char* specialfile, int swap_flags),
+                              (specialfile, swap_flags))
+        JM_INLINE_SYSCALL_SYS(swapoff, (const char* specialfile), (specialfile))
+        JM_INLINE_SYSCALL_SYS(reboot,
+                              (int magic1, int magic2, unsigned int cmd, void* arg),
+                              (magic1, magic2, cmd, arg))
+        JM_INLINE_SYSCALL_SYS(sethostname, (char* name, int len), (name, len))
+        JM_INLINE_SYSCALL_SYS(setdomainname, (char* name, int len), (name, len))
+        JM_INLINE_SYSCALL_SYS(iopl, (unsigned int level), (level))
+        JM_INLINE_SYSCALL_SYS(ioperm,
+                              (unsigned long from, unsigned long num, int on),
+                              (from, num, on))
+        JM_INLINE_SYSCALL_SYS(init_module,
+                              (void* umod, unsigned long len, const char* uargs),
+                              (umod, len, uargs))
+        JM_INLINE_SYSCALL_SYS(delete_module,
+                              (const char* name_user, unsigned int flags),
+                              (name_user, flags))
+        JM_INLINE_SYSCALL_SYS(quotactl,
+                              (unsigned int cmd, const char* special, unsigned int id,
+                               void* addr),
+                              (cmd, special, id, addr))
+        JM_INLINE_SYSCALL_SYS(gettid, (), ())
+        JM_INLINE_SYSCALL_SYS(readahead,
+                              (int fd, long long offset, std::size_t count),
+                              (fd, offset, count))
+        JM_INLINE_SYSCALL_SYS(setxattr,
+                              (const char* path, const char* name, const void* value,
+                               std::size_t size, int flags),
+                              (path, name, value, size, flags))
+        JM_INLINE_SYSCALL_SYS(lsetxattr,
+                              (const char* path, const char* name, const void* value,
+                               std::size_t size, int flags),
+                              (path, name, value, size, flags))
+        JM_INLINE_SYSCALL_SYS(fsetxattr,
+                              (int fd, const char* name, const void* value,
+                               std::size_t size, int flags),
+                              (fd, name, value, size, flags))
+        JM_INLINE_SYSCALL_SYS(getxattr,
+                              (const char* path, const char* name, void* value,
+                               std::size_t size),
+                              (path, name, value, size))
+        JM_INLINE_SYSCALL_SYS(lgetxattr,
+                              (const char* path, const char* name, void* value,
+                               std::size_t size),
+                              (path, name, value, size))
+        JM_INLINE_SYSCALL_SYS(fgetxattr,
+                              (int fd, const char* name, void* value, std::size_t size),
+                              (fd, name, value, size))
+        JM_INLINE_SYSCALL_SYS(listxattr,
+                              (const char* path, char* list, std::size_t size),
+                              (path, list, size))
+        JM_INLINE_SYSCALL_SYS(llistxattr,
+                              (const char* path, char* list, std::size_t size),
+                              (path, list, size))
+        JM_INLINE_SYSCALL_SYS(flistxattr,
+                              (int fd, char* list, std::size_t size),
+                              (fd, list, size))
+        JM_INLINE_SYSCALL_SYS(removexattr,
+                              (const char* path, const char* name),
+                              (path, name))
+        JM_INLINE_SYSCALL_SYS(lremovexattr,
+                              (const char* path, const char* name),
+                              (path, name))
+        JM_INLINE_SYSCALL_SYS(fremovexattr, (int fd, const char* name), (fd, name))
+        JM_INLINE_SYSCALL_SYS(tkill, (pid_t pid, int sig), (pid, sig))
+        JM_INLINE_SYSCALL_SYS(time, (time_t* tloc), (tloc))
+        JM_INLINE_SYSCALL_SYS(futex,
+                              (std::uint32_t* uaddr, int op, std::uint32_t val,
+                               const struct timespec* utime, std::uint32_t* uaddr2,
+                               std::uint32_t val3),
+                              (uaddr, op, val, utime, uaddr2, val3))
+        JM_INLINE_SYSCALL_SYS(sched_setaffinity,
+                              (pid_t pid, unsigned int len, unsigned long* user_mask_ptr),
+                              (pid, len, user_mask_ptr))
+        JM_INLINE_SYSCALL_SYS(sched_getaffinity,
+                              (pid_t pid, unsigned int len, unsigned long* user_mask_ptr),
+                              (pid, len, user_mask_ptr))
+        JM_INLINE_SYSCALL_SYS(io_setup,
+                              (unsigned int nr_reqs, unsigned long* ctx),
+                              (nr_reqs, ctx))
+        JM_INLINE_SYSCALL_SYS(io_destroy, (unsigned long ctx), (ctx))
+        JM_INLINE_SYSCALL_SYS(io_getevents,
+                              (unsigned long ctx_id, long min_nr, long nr,
+                               struct io_event* events, struct timespec* timeout),
+                              (ctx_id, min_nr, nr, events, timeout))
+        JM_INLINE_SYSCALL_SYS(io_submit,
+                              (unsigned long a0, long a1, struct iocb** a2),
+                              (a0, a1, a2))
+        JM_INLINE_SYSCALL_SYS(io_cancel,
+                              (unsigned long ctx_id, struct iocb* iocb,
+                               struct io_event* result),
+                              (ctx_id, iocb, result))
+        JM_INLINE_SYSCALL_SYS(lookup_dcookie,
+                              (std::uint64_t cookie64, char* buf, std::size_t len),
+                              (cookie64, buf, len))
+        JM_INLINE_SYSCALL_SYS(epoll_create, (int size), (size))
+        JM_INLINE_SYSCALL_SYS(remap_file_pages,
+                              (unsigned long start, unsigned long size, unsigned long prot,
+                               unsigned long pgoff, unsigned long flags),
+                              (start, size, prot, pgoff, flags))
+        JM_INLINE_SYSCALL_SYS(getdents64,
+                              (unsigned int fd, struct linux_dirent64* dirent,
+                               unsigned int count),
+                              (fd, dirent, count))
+        JM_INLINE_SYSCALL_SYS(set_tid_address, (int* tidptr), (tidptr))
+        JM_INLINE_SYSCALL_SYS(restart_syscall, (), ())
+        JM_INLINE_SYSCALL_SYS(semtimedop,
+                              (int semid, struct sembuf* sops, unsigned int nsops,
+                               const struct timespec* timeout),
+                              (semid, sops, nsops, timeout))
+        JM_INLINE_SYSCALL_SYS(fadvise64,
+                              (int fd, long long offset, std::size_t len, int advice),
+                              (fd, offset, len, advice))
+        JM_INLINE_SYSCALL_SYS(timer_create,
+                              (clockid_t which_clock, struct sigevent* timer_event_spec,
+                               int* created_timer_id),
+                              (which_clock, timer_event_spec, created_timer_id))
+        JM_INLINE_SYSCALL_SYS(timer_settime,
+                              (int timer_id, int flags,
+                               const struct itimerspec* new_setting,
+                               struct itimerspec* old_setting),
+                              (timer_id, flags, new_setting, old_setting))
+        JM_INLINE_SYSCALL_SYS(timer_gettime,
+                              (int timer_id, struct itimerspec* setting),
+                              (timer_id, setting))
+        JM_INLINE_SYSCALL_SYS(timer_getoverrun, (int timer_id), (timer_id))
+        JM_INLINE_SYSCALL_SYS(timer_delete, (int timer_id), (timer_id))
+        JM_INLINE_SYSCALL_SYS(clock_settime,
+                              (clockid_t which_clock, const struct timespec* tp),
+                              (which_clock, tp))
+        JM_INLINE_SYSCALL_SYS(clock_gettime,
+                              (clockid_t which_clock, struct timespec* tp),
+                              (which_clock, tp))
+        JM_INLINE_SYSCALL_SYS(clock_getres,
+                              (clockid_t which_clock, struct timespec* tp),
+                              (which_clock, tp))
+        JM_INLINE_SYSCALL_SYS(clock_nanosleep,
+                              (clockid_t which_clock, int flags,
+                               const struct timespec* rqtp, struct timespec* rmtp),
+                              (which_clock, flags, rqtp, rmtp))
+        JM_INLINE_SYSCALL_SYS(exit_group, (int error_code), (error_code))
+        JM_INLINE_SYSCALL_SYS(epoll_wait,
+                              (int epfd, struct epoll_event* events, int maxevents,
+                               int timeout),
+                              (epfd, events, maxevents, timeout))
+        JM_INLINE_SYSCALL_SYS(epoll_ctl,
+                              (int epfd, int op, int fd, struct epoll_event* event),
+                              (epfd, op, fd, event))
+        JM_INLINE_SYSCALL_SYS(tgkill, (pid_t tgid, pid_t pid, int sig), (tgid, pid, sig))
+        JM_INLINE_SYSCALL_SYS(utimes,
+                              (char* filename, struct timeval* utimes_),
+                              (filename, utimes_))
+        JM_INLINE_SYSCALL_SYS(mbind,
+                              (unsigned long start, unsigned long len, unsigned long mode,
+                               const unsigned long* nmask, unsigned long maxnode,
+                               unsigned int flags),
+                              (start, len, mode, nmask, maxnode, flags))
+        JM_INLINE_SYSCALL_SYS(set_mempolicy,
+                              (int mode, const unsigned long* nmask, unsigned long maxnode),
+                              (mode, nmask, maxnode))
+        JM_INLINE_SYSCALL_SYS(get_mempolicy,
+                              (int* policy, unsigned long* nmask, unsigned long maxnode,
+                               unsigned long addr, unsigned long flags),
+                              (policy, nmask, maxnode, addr, flags))
+        JM_INLINE_SYSCALL_SYS(mq_open,
+                              (const char* name, int oflag, mode_t mode,
+                               struct mq_attr* attr),
+                              (name, oflag, mode, attr))
+        JM_INLINE_SYSCALL_SYS(mq_unlink, (const char* name), (name))
+        JM_INLINE_SYSCALL_SYS(mq_timedsend,
+                              (int mqdes, const char* msg_ptr, std::size_t msg_len,
+                               unsigned int msg_prio, const struct timespec* abs_timeout),
+                              (mqdes, msg_ptr, msg_len, msg_prio, abs_timeout))
+        JM_INLINE_SYSCALL_SYS(mq_timedreceive,
+                              (int mqdes, char* msg_ptr, std::size_t msg_len,
+                               unsigned int* msg_prio, const struct timespec* abs_timeout),
+                              (mqdes, msg_ptr, msg_len, msg_prio, abs_timeout))
+        JM_INLINE_SYSCALL_SYS(mq_notify,
+                              (int mqdes, const struct sigevent* notification),
+                              (mqdes, notification))
+        JM_INLINE_SYSCALL_SYS(mq_getsetattr,
+                              (int mqdes, const struct mq_attr* mqstat,
+                               struct mq_attr* omqstat),
+                              (mqdes, mqstat, omqstat))
+        JM_INLINE_SYSCALL_SYS(kexec_load,
+                              (unsigned long entry, unsigned long nr_segments,
+                               struct kexec_segment* segments, unsigned long flags),
+                              (entry, nr_segments, segments, flags))
+        JM_INLINE_SYSCALL_SYS(waitid,
+                              (int which, pid_t pid, siginfo_t* infop, int options,
+                               struct rusage* ru),
+                              (which, pid, infop, options, ru))
+        JM_INLINE_SYSCALL_SYS(add_key,
+                              (const char* _type, const char* _description,
+                               const void* _payload, std::size_t plen,
+                               std::int32_t destringid),
+                              (_type, _description, _payload, plen, destringid))
+        JM_INLINE_SYSCALL_SYS(request_key,
+                              (const char* _type, const char* _description,
+                               const char* _callout_info, std::int32_t destringid),
+                              (_type, _description, _callout_info, destringid))
+        JM_INLINE_SYSCALL_SYS(keyctl,
+                              (int cmd, unsigned long arg2, unsigned long arg3,
+                               unsigned long arg4, unsigned long arg5),
+                              (cmd, arg2, arg3, arg4, arg5))
+        JM_INLINE_SYSCALL_SYS(ioprio_set,
+                              (int which, int who, int ioprio),
+                              (which, who, ioprio))
+        JM_INLINE_SYSCALL_SYS(ioprio_get, (int which, int who), (which, who))
+        JM_INLINE_SYSCALL_SYS(inotify_init, (), ())
+        JM_INLINE_SYSCALL_SYS(inotify_add_watch,
+                              (int fd, const char* path, std::uint32_t mask),
+                              (fd, path, mask))
+        JM_INLINE_SYSCALL_SYS(inotify_rm_watch, (int fd, std::int32_t wd), (fd, wd))
+        JM_INLINE_SYSCALL_SYS(migrate_pages,
+                              (pid_t pid, unsigned long maxnode, const unsigned long* from,
+                               const unsigned long* to),
+                              (pid, maxnode, from, to))
+        JM_INLINE_SYSCALL_SYS(openat,
+                              (int dfd, const char* filename, int flags, mode_t mode),
+                              (dfd, filename, flags, mode))
+        JM_INLINE_SYSCALL_SYS(mkdirat,
+                              (int dfd, const char* pathname, mode_t mode),
+                              (dfd, pathname, mode))
+        JM_INLINE_SYSCALL_SYS(mknodat,
+                              (int dfd, const char* filename, mode_t mode,
+                               unsigned int dev),
+                              (dfd, filename, mode, dev))
+        JM_INLINE_SYSCALL_SYS(fchownat,
+                              (int dfd, const char* filename, uid_t user, gid_t group,
+                               int flag),
+                              (dfd, filename, user, group, flag))
+        JM_INLINE_SYSCALL_SYS(futimesat,
+                              (int dfd, const char* filename, struct timeval* utimes),
+                              (dfd, filename, utimes))
+        JM_INLINE_SYSCALL_SYS(newfstatat,
+                              (int dfd, const char* filename, struct stat* statbuf,
+                               int flag),
+                              (dfd, filename, statbuf, flag))
+        JM_INLINE_SYSCALL_SYS(unlinkat,
+                              (int dfd, const char* pathname, int flag),
+                              (dfd, pathname, flag))
+        JM_INLINE_SYSCALL_SYS(renameat,
+                              (int olddfd, const char* oldname, int newdfd,
+                               const char* newname),
+                              (olddfd, oldname, newdfd, newname))
+        JM_INLINE_SYSCALL_SYS(linkat,
+                              (int olddfd, const char* oldname, int newdfd,
+                               const char* newname, int flags),
+                              (olddfd, oldname, newdfd, newname, flags))
+        JM_INLINE_SYSCALL_SYS(symlinkat,
+                              (const char* oldname, int newdfd, const char* newname),
+                              (oldname, newdfd, newname))
+        JM_INLINE_SYSCALL_SYS(readlinkat,
+                              (int dfd, const char* path, char* buf, int bufsiz),
+                              (dfd, path, buf, bufsiz))
+        JM_INLINE_SYSCALL_SYS(fchmodat,
+                              (int dfd, const char* filename, mode_t mode),
+                              (dfd, filename, mode))
+        JM_INLINE_SYSCALL_SYS(faccessat,
+                              (int dfd, const char* filename, int mode),
+                              (dfd, filename, mode))
+        JM_INLINE_SYSCALL_SYS(pselect6,
+                              (int a0, fd_set* a1, fd_set* a2, fd_set* a3,
+                               struct timespec* a4, void* a5),
+                              (a0, a1, a2, a3, a4, a5))
+        JM_INLINE_SYSCALL_SYS(ppoll,
+                              (struct pollfd* a0, unsigned int a1, struct timespec* a2,
+                               const sigset_t* a3, std::size_t a4),
+                              (a0, a1, a2, a3, a4))
+        JM_INLINE_SYSCALL_SYS(unshare, (unsigned long unshare_flags), (unshare_flags))
+        JM_INLINE_SYSCALL_SYS(set_robust_list,
+                              (struct robust_list_head* head, std::size_t len),
+                              (head, len))
+        JM_INLINE_SYSCALL_SYS(get_robust_list,
+                              (int pid, struct robust_list_head** head_ptr,
+                               std::size_t* len_ptr),
+                              (pid, head_ptr, len_ptr))
+        JM_INLINE_SYSCALL_SYS(splice,
+                              (int fd_in, long long* off_in, int fd_out, long long* off_out,
+                               std::size_t len, unsigned int flags),
+                              (fd_in, off_in, fd_out, off_out, len, flags))
+        JM_INLINE_SYSCALL_SYS(tee,
+                              (int fdin, int fdout, std::size_t len, unsigned int flags),
+                              (fdin, fdout, len, flags))
+        JM_INLINE_SYSCALL_SYS(sync_file_range,
+                              (int fd, long long offset, long long nbytes,
+                               unsigned int flags),
+                              (fd, offset, nbytes, flags))
+        JM_INLINE_SYSCALL_SYS(vmsplice,
+                              (int fd, const struct iovec* vec, unsigned long nr_segs,
+                               unsigned int flags),
+                              (fd, vec, nr_segs, flags))
+        JM_INLINE_SYSCALL_SYS(move_pages,
+                              (pid_t pid, unsigned long nr_pages, const void** pages,
+                               const int* nodes, int* status, int flags),
+                              (pid, nr_pages, pages, nodes, status, flags))
+        JM_INLINE_SYSCALL_SYS(utimensat,
+                              (int dfd, const char* filename, struct timespec* utimes,
+                               int flags),
+                              (dfd, filename, utimes, flags))
+        JM_INLINE_SYSCALL_SYS(epoll_pwait,
+                              (int epfd, struct epoll_event* events, int maxevents,
+                               int timeout, const sigset_t* sigmask,
+                               std::size_t sigsetsize),
+                              (epfd, events, maxevents, timeout, sigmask, sigsetsize))
+        JM_INLINE_SYSCALL_SYS(signalfd,
+                              (int ufd, sigset_t* user_mask, std::size_t sizemask),
+                              (ufd, user_mask, sizemask))
+        JM_INLINE_SYSCALL_SYS(timerfd_create, (int clockid, int flags), (clockid, flags))
+        JM_INLINE_SYSCALL_SYS(eventfd, (unsigned int count), (count))
+        JM_INLINE_SYSCALL_SYS(fallocate,
+                              (int fd, int mode, long long offset, long long len),
+                              (fd, mode, offset, len))
+        JM_INLINE_SYSCALL_SYS(timerfd_settime,
+                              (int ufd, int flags, const struct itimerspec* utmr,
+                               struct itimerspec* otmr),
+                              (ufd, flags, utmr, otmr))
+        JM_INLINE_SYSCALL_SYS(timerfd_gettime,
+                              (int ufd, struct itimerspec* otmr),
+                              (ufd, otmr))
+        JM_INLINE_SYSCALL_SYS(accept4,
+                              (int a0, struct sockaddr* a1, int* a2, int a3),
+                              (a0, a1, a2, a3))
+        JM_INLINE_SYSCALL_SYS(signalfd4,
+                              (int ufd, sigset_t* user_mask, std::size_t sizemask,
+                               int flags),
+                              (ufd, user_mask, sizemask, flags))
+        JM_INLINE_SYSCALL_SYS(eventfd2, (unsigned int count, int flags), (count, flags))
+        JM_INLINE_SYSCALL_SYS(epoll_create1, (int flags), (flags))
+        JM_INLINE_SYSCALL_SYS(dup3,
+                              (unsigned int oldfd, unsigned int newfd, int flags),
+                              (oldfd, newfd, flags))
+        JM_INLINE_SYSCALL_SYS(pipe2, (int* fildes, int flags), (fildes, flags))
+        JM_INLINE_SYSCALL_SYS(inotify_init1, (int flags), (flags))
+        JM_INLINE_SYSCALL_SYS(preadv,
+                              (unsigned long fd, const struct iovec* vec,
+                               unsigned long vlen, unsigned long pos_l,
+                               unsigned long pos_h),
+                              (fd, vec, vlen, pos_l, pos_h))
+        JM_INLINE_SYSCALL_SYS(pwritev,
+                              (unsigned long fd, const struct iovec* vec,
+                               unsigned long vlen, unsigned long pos_l,
+                               unsigned long pos_h),
+                              (fd, vec, vlen, pos_l, pos_h))
+        JM_INLINE_SYSCALL_SYS(rt_tgsigqueueinfo,
+                              (pid_t tgid, pid_t pid, int sig, siginfo_t* uinfo),
+                              (tgid, pid, sig, uinfo))
+        JM_INLINE_SYSCALL_SYS(perf_event_open,
+                              (struct perf_event_attr* attr_uptr, pid_t pid, int cpu,
+                               int group_fd, unsigned long flags),
+                              (attr_uptr, pid, cpu, group_fd, flags))
+        JM_INLINE_SYSCALL_SYS(recvmmsg,
+                              (int fd, struct mmsghdr* msg, unsigned int vlen,
+                               unsigned int flags, struct timespec* timeout),
+                              (fd, msg, vlen, flags, timeout))
+        JM_INLINE_SYSCALL_SYS(fanotify_init,
+                              (unsigned int flags, unsigned int event_f_flags),
+                              (flags, event_f_flags))
+        JM_INLINE_SYSCALL_SYS(fanotify_mark,
+                              (int fanotify_fd, unsigned int flags, std::uint64_t mask,
+                               int fd, const char* pathname),
+                              (fanotify_fd, flags, mask, fd, pathname))
+        JM_INLINE_SYSCALL_SYS(prlimit64,
+                              (pid_t pid, unsigned int resource,
+                               const struct rlimit64* new_rlim, struct rlimit64* old_rlim),
+                              (pid, resource, new_rlim, old_rlim))
+        JM_INLINE_SYSCALL_SYS(name_to_handle_at,
+                              (int dfd, const char* name, struct file_handle* handle,
+                               int* mnt_id, int flag),
+                              (dfd, name, handle, mnt_id, flag))
+        JM_INLINE_SYSCALL_SYS(open_by_handle_at,
+                              (int mountdirfd, struct file_handle* handle, int flags),
+                              (mountdirfd, handle, flags))
+        JM_INLINE_SYSCALL_SYS(clock_adjtime,
+                              (clockid_t which_clock, struct timex* tx),
+                              (which_clock, tx))
+        JM_INLINE_SYSCALL_SYS(syncfs, (int fd), (fd))
+        JM_INLINE_SYSCALL_SYS(sendmmsg,
+                              (int fd, struct mmsghdr* msg, unsigned int vlen,
+                               unsigned int flags),
+                              (fd, msg, vlen, flags))
+        JM_INLINE_SYSCALL_SYS(setns, (int fd, int nstype), (fd, nstype))
+        JM_INLINE_SYSCALL_SYS(getcpu,
+                              (unsigned int* cpu, unsigned int* node,
+                               struct getcpu_cache* cache),
+                              (cpu, node, cache))
+        JM_INLINE_SYSCALL_SYS(process_vm_readv,
+                              (pid_t pid, const struct iovec* lvec, unsigned long liovcnt,
+                               const struct iovec* rvec, unsigned long riovcnt,
+                               unsigned long flags),
+                              (pid, lvec, liovcnt, rvec, riovcnt, flags))
+        JM_INLINE_SYSCALL_SYS(process_vm_writev,
+                              (pid_t pid, const struct iovec* lvec, unsigned long liovcnt,
+                               const struct iovec* rvec, unsigned long riovcnt,
+                               unsigned long flags),
+                              (pid, lvec, liovcnt, rvec, riovcnt, flags))
+        JM_INLINE_SYSCALL_SYS(kcmp,
+                              (pid_t pid1, pid_t pid2, int type, unsigned long idx1,
+                               unsigned long idx2),
+                              (pid1, pid2, type, idx1, idx2))
+        JM_INLINE_SYSCALL_SYS(finit_module,
+                              (int fd, const char* uargs, int flags),
+                              (fd, uargs, flags))
+        JM_INLINE_SYSCALL_SYS(sched_setattr,
+                              (pid_t pid, struct sched_attr* attr, unsigned int flags),
+                              (pid, attr, flags))
+        JM_INLINE_SYSCALL_SYS(sched_getattr,
+                              (pid_t pid, struct sched_attr* attr, unsigned int size,
+                               unsigned int flags),
+                              (pid, attr, size, flags))
+        JM_INLINE_SYSCALL_SYS(renameat2,
+                              (int olddfd, const char* oldname, int newdfd,
+                               const char* newname, unsigned int flags),
+                              (olddfd, oldname, newdfd, newname, flags))
+        JM_INLINE_SYSCALL_SYS(seccomp,
+                              (unsigned int op, unsigned int flags, void* uargs),
+                              (op, flags, uargs))
+        JM_INLINE_SYSCALL_SYS(getrandom,
+                              (char* buf, std::size_t count, unsigned int flags),
+                              (buf, count, flags))
+        JM_INLINE_SYSCALL_SYS(memfd_create,
+                              (const char* uname_ptr, unsigned int flags),
+                              (uname_ptr, flags))
+        JM_INLINE_SYSCALL_SYS(kexec_file_load,
+                              (int kernel_fd, int initrd_fd, unsigned long cmdline_len,
+                               const char* cmdline_ptr, unsigned long flags),
+                              (kernel_fd, initrd_fd, cmdline_len, cmdline_ptr, flags))
+        JM_INLINE_SYSCALL_SYS(bpf,
+                              (int cmd, union bpf_attr* attr, unsigned int size),
+                              (cmd, attr, size))
+        JM_INLINE_SYSCALL_SYS(execveat,
+                              (int dfd, const char* filename, const char* const* argv,
+                               const char* const* envp, int flags),
+                              (dfd, filename, argv, envp, flags))
+        JM_INLINE_SYSCALL_SYS(userfaultfd, (int flags), (flags))
+        JM_INLINE_SYSCALL_SYS(membarrier,
+                              (int cmd, unsigned int flags, int cpu_id),
+                              (cmd, flags, cpu_id))
+        JM_INLINE_SYSCALL_SYS(mlock2,
+                              (unsigned long start, std::size_t len, int flags),
+                              (start, len, flags))
+        JM_INLINE_SYSCALL_SYS(copy_file_range,
+                              (int fd_in, long long* off_in, int fd_out, long long* off_out,
+                               std::size_t len, unsigned int flags),
+                              (fd_in, off_in, fd_out, off_out, len, flags))
+        JM_INLINE_SYSCALL_SYS(preadv2,
+                              (unsigned long fd, const struct iovec* vec,
+                               unsigned long vlen, unsigned long pos_l, unsigned long pos_h,
+                               int flags),
+                              (fd, vec, vlen, pos_l, pos_h, flags))
+        JM_INLINE_SYSCALL_SYS(pwritev2,
+                              (unsigned long fd, const struct iovec* vec,
+                               unsigned long vlen, unsigned long pos_l, unsigned long pos_h,
+                               int flags),
+                              (fd, vec, vlen, pos_l, pos_h, flags))
+        JM_INLINE_SYSCALL_SYS(pkey_mprotect,
+                              (unsigned long start, std::size_t len, unsigned long prot,
+                               int pkey),
+                              (start, len, prot, pkey))
+        JM_INLINE_SYSCALL_SYS(pkey_alloc,
+                              (unsigned long flags, unsigned long init_val),
+                              (flags, init_val))
+        JM_INLINE_SYSCALL_SYS(pkey_free, (int pkey), (pkey))
+        JM_INLINE_SYSCALL_SYS(statx,
+                              (int dfd, const char* path, unsigned int flags,
+                               unsigned int mask, struct statx* buffer),
+                              (dfd, path, flags, mask, buffer))
+        JM_INLINE_SYSCALL_SYS(io_pgetevents,
+                              (unsigned long ctx_id, long min_nr, long nr,
+                               struct io_event* events, struct timespec* timeout,
+                               const struct __aio_sigset* sig),
+                              (ctx_id, min_nr, nr, events, timeout, sig))
+        JM_INLINE_SYSCALL_SYS(rseq,
+                              (struct rseq* rseq_, std::uint32_t rseq_len, int flags,
+                               std::uint32_t sig),
+                              (rseq_, rseq_len, flags, sig))
+        JM_INLINE_SYSCALL_SYS(pidfd_send_signal,
+                              (int pidfd, int sig, siginfo_t* info, unsigned int flags),
+                              (pidfd, sig, info, flags))
+        JM_INLINE_SYSCALL_SYS(io_uring_setup,
+                              (std::uint32_t entries, struct io_uring_params* p),
+                              (entries, p))
+        JM_INLINE_SYSCALL_SYS(io_uring_enter,
+                              (unsigned int fd, std::uint32_t to_submit,
+                               std::uint32_t min_complete, std::uint32_t flags,
+                               const void* argp, std::size_t argsz),
+                              (fd, to_submit, min_complete, flags, argp, argsz))
+        JM_INLINE_SYSCALL_SYS(io_uring_register,
+                              (unsigned int fd, unsigned int op, void* arg,
+                               unsigned int nr_args),
+                              (fd, op, arg, nr_args))
+        JM_INLINE_SYSCALL_SYS(open_tree,
+                              (int dfd, const char* path, unsigned int flags),
+                              (dfd, path, flags))
+        JM_INLINE_SYSCALL_SYS(move_mount,
+                              (int from_dfd, const char* from_path, int to_dfd,
+                               const char* to_path, unsigned int ms_flags),
+                              (from_dfd, from_path, to_dfd, to_path, ms_flags))
+        JM_INLINE_SYSCALL_SYS(fsopen,
+                              (const char* fs_name, unsigned int flags),
+                              (fs_name, flags))
+        JM_INLINE_SYSCALL_SYS(fsconfig,
+                              (int fs_fd, unsigned int cmd, const char* key,
+                               const void* value, int aux),
+                              (fs_fd, cmd, key, value, aux))
+        JM_INLINE_SYSCALL_SYS(fsmount,
+                              (int fs_fd, unsigned int flags, unsigned int ms_flags),
+                              (fs_fd, flags, ms_flags))
+        JM_INLINE_SYSCALL_SYS(fspick,
+                              (int dfd, const char* path, unsigned int flags),
+                              (dfd, path, flags))
+        JM_INLINE_SYSCALL_SYS(pidfd_open, (pid_t pid, unsigned int flags), (pid, flags))
+        JM_INLINE_SYSCALL_SYS(clone3,
+                              (struct clone_args* uargs, std::size_t size),
+                              (uargs, size))
+        JM_INLINE_SYSCALL_SYS(close_range,
+                              (unsigned int fd, unsigned int max_fd, unsigned int flags),
+                              (fd, max_fd, flags))
+        JM_INLINE_SYSCALL_SYS(openat2,
+                              (int dfd, const char* filename, struct open_how* how,
+                               std::size_t size),
+                              (dfd, filename, how, size))
+        JM_INLINE_SYSCALL_SYS(pidfd_getfd,
+                              (int pidfd, int fd, unsigned int flags),
+                              (pidfd, fd, flags))
+        JM_INLINE_SYSCALL_SYS(faccessat2,
+                              (int dfd, const char* filename, int mode, int flags),
+                              (dfd, filename, mode, flags))
+        JM_INLINE_SYSCALL_SYS(process_madvise,
+                              (int pidfd, const struct iovec* vec, std::size_t vlen,
+                               int behavior, unsigned int flags),
+                              (pidfd, vec, vlen, behavior, flags))
+        JM_INLINE_SYSCALL_SYS(epoll_pwait2,
+                              (int epfd, struct epoll_event* events, int maxevents,
+                               const struct timespec* timeout, const sigset_t* sigmask,
+                               std::size_t sigsetsize),
+                              (epfd, events, maxevents, timeout, sigmask, sigsetsize))
+        JM_INLINE_SYSCALL_SYS(mount_setattr,
+                              (int dfd, const char* path, unsigned int flags,
+                               struct mount_attr* uattr, std::size_t usize),
+                              (dfd, path, flags, uattr, usize))
+        JM_INLINE_SYSCALL_SYS(quotactl_fd,
+                              (unsigned int fd, unsigned int cmd, unsigned int id,
+                               void* addr),
+                              (fd, cmd, id, addr))
+        JM_INLINE_SYSCALL_SYS(landlock_create_ruleset,
+                              (const struct landlock_ruleset_attr* attr, std::size_t size,
+                               std::uint32_t flags),
+                              (attr, size, flags))
+        JM_INLINE_SYSCALL_SYS(landlock_add_rule,
+                              (int ruleset_fd, int rule_type, const void* rule_attr,
+                               std::uint32_t flags),
+                              (ruleset_fd, rule_type, rule_attr, flags))
+        JM_INLINE_SYSCALL_SYS(landlock_restrict_self,
+                              (int ruleset_fd, std::uint32_t flags),
+                              (ruleset_fd, flags))
+        JM_INLINE_SYSCALL_SYS(memfd_secret, (unsigned int flags), (flags))
+        JM_INLINE_SYSCALL_SYS(process_mrelease,
+                              (int pidfd, unsigned int flags),
+                              (pidfd, flags))
+        JM_INLINE_SYSCALL_SYS(futex_waitv,
+                              (struct futex_waitv* waiters, unsigned int nr_futexes,
+                               unsigned int flags, struct timespec* timeout,
+                               clockid_t clockid),
+                              (waiters, nr_futexes, flags, timeout, clockid))
+        JM_INLINE_SYSCALL_SYS(set_mempolicy_home_node,
+                              (unsigned long start, unsigned long len,
+                               unsigned long home_node, unsigned long flags),
+                              (start, len, home_node, flags))
+
+    } // namespace sys
+
+} // namespace jm
+
+#undef JM_INLINE_SYSCALL_SYS
+#undef JM_INLINE_SYSCALL_SYS_ARGS
+
+// entries of the syscall table without an entry point or a prototype:
+// 134 uselib
+// 156 _sysctl
+// 174 create_module
+// 177 get_kernel_syms
+// 178 query_module
+// 180 nfsservctl
+// 181 getpmsg
+// 182 putpmsg
+// 183 afs_syscall
+// 184 tuxcall
+// 185 security
+// 205 set_thread_area
+// 211 get_thread_area
+// 214 epoll_ctl_old
+// 215 epoll_wait_old
+// 236 vserver
+
+#endif // JM_INLINE_SYSCALL_LINUX_SYS_HPP
@@ -0,0 +1,1208 @@
+/*
+ * Copyright 2018-2020 Justas Masiulis
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// List of linux syscall names for JM_INLINE_SYSCALL_LINUX_SYSCALL(name).
+// Taken from the x86-64 and generic <asm/unistd.h> uapi headers. Every name is guarded
+// by its __NR_ macro so the list can be shared between architectures and kernel versions.
+
+#ifdef __NR_read
+JM_INLINE_SYSCALL_LINUX_SYSCALL(read)
+#endif
+#ifdef __NR_write
+JM_INLINE_SYSCALL_LINUX_SYSCALL(write)
+#endif
+#ifdef __NR_open
+JM_INLINE_SYSCALL_LINUX_SYSCALL(open)
+#endif
+#ifdef __NR_close
+JM_INLINE_SYSCALL_LINUX_SYSCALL(close)
+#endif
+#ifdef __NR_stat
+JM_INLINE_SYSCALL_LINUX_SYSCALL(stat)
+#endif
+#ifdef __NR_fstat
+JM_INLINE_SYSCALL_LINUX_SYSCALL(fstat)
+#endif
+#ifdef __NR_lstat
+JM_INLINE_SYSCALL_LINUX_SYSCALL(lstat)
+#endif
+#ifdef __NR_poll
+JM_INLINE_SYSCALL_LINUX_SYSCALL(poll)
+#endif
+#ifdef __NR_lseek
+JM_INLINE_SYSCALL_LINUX_SYSCALL(lseek)
+#endif
+#ifdef __NR_mmap
+JM_INLINE_SYSCALL_LINUX_SYSCALL(mmap)
+#endif
+#ifdef __NR_mprotect
+JM_INLINE_SYSCALL_LINUX_SYSCALL(mprotect)
+#endif
+#ifdef __NR_munmap
+JM_INLINE_SYSCALL_LINUX_SYSCALL(munmap)
+#endif
+#ifdef __NR_brk
+JM_INLINE_SYSCALL_LINUX_SYSCALL(brk)
+#endif
+#ifdef __NR_rt_sigaction
+JM_INLINE_SYSCALL_LINUX_SYSCALL(rt_sigaction)
+#endif
+#ifdef __NR_rt_sigprocmask
+JM_INLINE_SYSCALL_LINUX_SYSCALL(rt_sigprocmask)
+#endif
+#ifdef __NR_rt_sigreturn
+JM_INLINE_SYSCALL_LINUX_SYSCALL(rt_sigreturn)
+#endif
+#ifdef __NR_ioctl
+JM_INLINE_SYSCALL_LINUX_SYSCALL(ioctl)
+#endif
+#ifdef __NR_pread64
+JM_INLINE_SYSCALL_LINUX_SYSCALL(pread64)
+#endif
+#ifdef __NR_pwrite64
+JM_INLINE_SYSCALL_LINUX_SYSCALL(pwrite64)
+#endif
+#ifdef __NR_readv
+JM_INLINE_SYSCALL_LINUX_SYSCALL(readv)
+#endif
+#ifdef __NR_writev
+JM_INLINE_SYSCALL_LINUX_SYSCALL(writev)
+#endif
+#ifdef __NR_access
+JM_INLINE_SYSCALL_LINUX_SYSCALL(access)
+#endif
+#ifdef __NR_pipe
+JM_INLINE_SYSCALL_LINUX_SYSCALL(pipe)
+#endif
+#ifdef __NR_select
+JM_INLINE_SYSCALL_LINUX_SYSCALL(select)
+#endif
+#ifdef __NR_sched_yield
+JM_INLINE_SYSCALL_LINUX_SYSCALL(sched_yield)
+#endif
+#ifdef __NR_mremap
+JM_INLINE_SYSCALL_LINUX_SYSCALL(mremap)
+#endif
+#ifdef __NR_msync
+JM_INLINE_SYSCALL_LINUX_SYSCALL(msync)
+#endif
+#ifdef __NR_mincore
+JM_INLINE_SYSCALL_LINUX_SYSCALL(mincore)
+#endif
+#ifdef __NR_madvise
+JM_INLINE_SYSCALL_LINUX_SYSCALL(madvise)
+#endif
+#ifdef __NR_shmget
+JM_INLINE_SYSCALL_LINUX_SYSCALL(shmget)
+#endif
+#ifdef __NR_shmat
+JM_INLINE_SYSCALL_LINUX_SYSCALL(shmat)
+#endif
+#ifdef __NR_shmctl
+JM_INLINE_SYSCALL_LINUX_SYSCALL(shmctl)
+#endif
+#ifdef __NR_dup
+JM_INLINE_SYSCALL_LINUX_SYSCALL(dup)
+#endif
+#ifdef __NR_dup2
+JM_INLINE_SYSCALL_LINUX_SYSCALL(dup2)
+#endif
+#ifdef __NR_pause
+JM_INLINE_SYSCALL_LINUX_SYSCALL(pause)
+#endif
+#ifdef __NR_nanosleep
+JM_INLINE_SYSCALL_LINUX_SYSCALL(nanosleep)
+#endif
+#ifdef __NR_getitimer
+JM_INLINE_SYSCALL_LINUX_SYSCALL(getitimer)
+#endif
+#ifdef __NR_alarm
+JM_INLINE_SYSCALL_LINUX_SYSCALL(alarm)
+#endif
+#ifdef __NR_setitimer
+JM_INLINE_SYSCALL_LINUX_SYSCALL(setitimer)
+#endif
+#ifdef __NR_getpid
+JM_INLINE_SYSCALL_LINUX_SYSCALL(getpid)
+#endif
+#ifdef __NR_sendfile
+JM_INLINE_SYSCALL_LINUX_SYSCALL(sendfile)
+#endif
+#ifdef __NR_socket
+JM_INLINE_SYSCALL_LINUX_SYSCALL(socket)
+#endif
+#ifdef __NR_connect
+JM_INLINE_SYSCALL_LINUX_SYSCALL(connect)
+#endif
+#ifdef __NR_accept
+JM_INLINE_SYSCALL_LINUX_SYSCALL(accept)
+#endif
+#ifdef __NR_sendto
+JM_INLINE_SYSCALL_LINUX_SYSCALL(sendto)
+#endif
+#ifdef __NR_recvfrom
+JM_INLINE_SYSCALL_LINUX_SYSCALL(recvfrom)
+#endif
+#ifdef __NR_sendmsg
+JM_INLINE_SYSCALL_LINUX_SYSCALL(sendmsg)
+#endif
+#ifdef __NR_recvmsg
+JM_INLINE_SYSCALL_LINUX_SYSCALL(recvmsg)
+#endif
+#ifdef __NR_shutdown
+JM_INLINE_SYSCALL_LINUX_SYSCALL(shutdown)
+#endif
+#ifdef __NR_bind
+JM_INLINE_SYSCALL_LINUX_SYSCALL(bind)
+#endif
+#ifdef __NR_listen
+JM_INLINE_SYSCALL_LINUX_SYSCALL(listen)
+#endif
+#ifdef __NR_getsockname
+JM_INLINE_SYSCALL_LINUX_SYSCALL(getsockname)
+#endif
+#ifdef __NR_getpeername
+JM_INLINE_SYSCALL_LINUX_SYSCALL(getpeername)
+#endif
+#ifdef __NR_socketpair
+JM_INLINE_SYSCALL_LINUX_SYSCALL(socketpair)
+#endif
+#ifdef __NR_setsockopt
+JM_INLINE_SYSCALL_LINUX_SYSCALL(setsockopt)
+#endif
+#ifdef __NR_getsockopt
+JM_INLINE_SYSCALL_LINUX_SYSCALL(getsockopt)
+#endif
+#ifdef __NR_clone
+JM_INLINE_SYSCALL_LINUX_SYSCALL(clone)
+#endif
+#ifdef __NR_fork
+JM_INLINE_SYSCALL_LINUX_SYSCALL(fork)
+#endif
+#ifdef __NR_vfork
+JM_INLINE_SYSCALL_LINUX_SYSCALL(vfork)
+#endif
+#ifdef __NR_execve
+JM_INLINE_SYSCALL_LINUX_SYSCALL(execve)
+#endif
+#ifdef __NR_exit
+JM_INLINE_SYSCALL_LINUX_SYSCALL(exit)
+#endif
+#ifdef __NR_wait4
+JM_INLINE_SYSCALL_LINUX_SYSCALL(wait4)
+#endif
+#ifdef __NR_kill
+JM_INLINE_SYSCALL_LINUX_SYSCALL(kill)
+#endif
+#ifdef __NR_uname
+JM_INLINE_SYSCALL_LINUX_SYSCALL(uname)
+#endif
+#ifdef __NR_semget
+JM_INLINE_SYSCALL_LINUX_SYSCALL(semget)
+#endif
+#ifdef __NR_semop
+JM_INLINE_SYSCALL_LINUX_SYSCALL(semop)
+#endif
+#ifdef __NR_semctl
+JM_INLINE_SYSCALL_LINUX_SYSCALL(semctl)
+#endif
+#ifdef __NR_shmdt
+JM_INLINE_SYSCALL_LINUX_SYSCALL(shmdt)
+#endif
+#ifdef __NR_msgget
+JM_INLINE_SYSCALL_LINUX_SYSCALL(msgget)
+#endif
+#ifdef __NR_msgsnd
+JM_INLINE_SYSCALL_LINUX_SYSCALL(msgsnd)
+#endif
+#ifdef __NR_msgrcv
+JM_INLINE_SYSCALL_LINUX_SYSCALL(msgrcv)
+#endif
+#ifdef __NR_msgctl
+JM_INLINE_SYSCALL_LINUX_SYSCALL(msgctl)
+#endif
+#ifdef __NR_fcntl
+JM_INLINE_SYSCALL_LINUX_SYSCALL(fcntl)
+#endif
+#ifdef __NR_flock
+JM_INLINE_SYSCALL_LINUX_SYSCALL(flock)
+#endif
+#ifdef __NR_fsync
+JM_INLINE_SYSCALL_LINUX_SYSCALL(fsync)
+#endif
+#ifdef __NR_fdatasync
+JM_INLINE_SYSCALL_LINUX_SYSCALL(fdatasync)
+#endif
+#ifdef __NR_truncate
+JM_INLINE_SYSCALL_LINUX_SYSCALL(truncate)
+#endif
+#ifdef __NR_ftruncate
+JM_INLINE_SYSCALL_LINUX_SYSCALL(ftruncate)
+#endif
+#ifdef __NR_getdents
+JM_INLINE_SYSCALL_LINUX_SYSCALL(getdents)
+#endif
+#ifdef __NR_getcwd
+JM_INLINE_SYSCALL_LINUX_SYSCALL(getcwd)
+#endif
+#ifdef __NR_chdir
+JM_INLINE_SYSCALL_LINUX_SYSCALL(chdir)
+#endif
+#ifdef __NR_fchdir
+JM_INLINE_SYSCALL_LINUX_SYSCALL(fchdir)
+#endif
+#ifdef __NR_rename
+JM_INLINE_SYSCALL_LINUX_SYSCALL(rename)
+#endif
+#ifdef __NR_mkdir
+JM_INLINE_SYSCALL_LINUX_SYSCALL(mkdir)
+#endif
+#ifdef __NR_rmdir
+JM_INLINE_SYSCALL_LINUX_SYSCALL(rmdir)
+#endif
+#ifdef __NR_creat
+JM_INLINE_SYSCALL_LINUX_SYSCALL(creat)
+#endif
+#ifdef __NR_link
+JM_INLINE_SYSCALL_LINUX_SYSCALL(link)
+#endif
+#ifdef __NR_unlink
+JM_INLINE_SYSCALL_LINUX_SYSCALL(unlink)
+#endif
+#ifdef __NR_symlink
+JM_INLINE_SYSCALL_LINUX_SYSCALL(symlink)
+#endif
+#ifdef __NR_readlink
+JM_INLINE_SYSCALL_LINUX_SYSCALL(readlink)
+#endif
+#ifdef __NR_chmod
+JM_INLINE_SYSCALL_LINUX_SYSCALL(chmod)
+#endif
+#ifdef __NR_fchmod
+JM_INLINE_SYSCALL_LINUX_SYSCALL(fchmod)
+#endif
+#ifdef __NR_chown
+JM_INLINE_SYSCALL_LINUX_SYSCALL(chown)
+#endif
+#ifdef __NR_fchown
+JM_INLINE_SYSCALL_LINUX_SYSCALL(fchown)
+#endif
+#ifdef __NR_lchown
+JM_INLINE_SYSCALL_LINUX_SYSCALL(lchown)
+#endif
+#ifdef __NR_umask
+JM_INLINE_SYSCALL_LINUX_SYSCALL(umask)
+#endif
+#ifdef __NR_gettimeofday
+JM_INLINE_SYSCALL_LINUX_SYSCALL(gettimeofday)
+#endif
+#ifdef __NR_getrlimit
+JM_INLINE_SYSCALL_LINUX_SYSCALL(getrlimit)
+#endif
+#ifdef __NR_getrusage
+JM_INLINE_SYSCALL_LINUX_SYSCALL(getrusage)
+#endif
+#ifdef __NR_sysinfo
+JM_INLINE_SYSCALL_LINUX_SYSCALL(sysinfo)
+#endif
+#ifdef __NR_times
+JM_INLINE_SYSCALL_LINUX_SYSCALL(times)
+#endif
+#ifdef __NR_ptrace
+JM_INLINE_SYSCALL_LINUX_SYSCALL(ptrace)
+#endif
+#ifdef __NR_getuid
+JM_INLINE_SYSCALL_LINUX_SYSCALL(getuid)
+#endif
+#ifdef __NR_syslog
+JM_INLINE_SYSCALL_LINUX_SYSCALL(syslog)
+#endif
+#ifdef __NR_getgid
+JM_INLINE_SYSCALL_LINUX_SYSCALL(getgid)
+#endif
+#ifdef __NR_setuid
+JM_INLINE_SYSCALL_LINUX_SYSCALL(setuid)
+#endif
+#ifdef __NR_setgid
+JM_INLINE_SYSCALL_LINUX_SYSCALL(setgid)
+#endif
+#ifdef __NR_geteuid
+JM_INLINE_SYSCALL_LINUX_SYSCALL(geteuid)
+#endif
+#ifdef __NR_getegid
+JM_INLINE_SYSCALL_LINUX_SYSCALL(getegid)
+#endif
+#ifdef __NR_setpgid
+JM_INLINE_SYSCALL_LINUX_SYSCALL(setpgid)
+#endif
+#ifdef __NR_getppid
+JM_INLINE_SYSCALL_LINUX_SYSCALL(getppid)
+#endif
+#ifdef __NR_getpgrp
+JM_INLINE_SYSCALL_LINUX_SYSCALL(getpgrp)
+#endif
+#ifdef __NR_setsid
+JM_INLINE_SYSCALL_LINUX_SYSCALL(setsid)
+#endif
+#ifdef __NR_setreuid
+JM_INLINE_SYSCALL_LINUX_SYSCALL(setreuid)
+#endif
+#ifdef __NR_setregid
+JM_INLINE_SYSCALL_LINUX_SYSCALL(setregid)
+#endif
+#ifdef __NR_getgroups
+JM_INLINE_SYSCALL_LINUX_SYSCALL(getgroups)
+#endif
+#ifdef __NR_setgroups
+JM_INLINE_SYSCALL_LINUX_SYSCALL(setgroups)
+#endif
+#ifdef __NR_setresuid
+JM_INLINE_SYSCALL_LINUX_SYSCALL(setresuid)
+#endif
+#ifdef __NR_getresuid
+JM_INLINE_SYSCALL_LINUX_SYSCALL(getresuid)
+#endif
+#ifdef __NR_setresgid
+JM_INLINE_SYSCALL_LINUX_SYSCALL(setresgid)
+#endif
+#ifdef __NR_getresgid
+JM_INLINE_SYSCALL_LINUX_SYSCALL(getresgid)
+#endif
+#ifdef __NR_getpgid
+JM_INLINE_SYSCALL_LINUX_SYSCALL(getpgid)
+#endif
+#ifdef __NR_setfsuid
+JM_INLINE_SYSCALL_LINUX_SYSCALL(setfsuid)
+#endif
+#ifdef __NR_setfsgid
+JM_INLINE_SYSCALL_LINUX_SYSCALL(setfsgid)
+#endif
+#ifdef __NR_getsid
+JM_INLINE_SYSCALL_LINUX_SYSCALL(getsid)
+#endif
+#ifdef __NR_capget
+JM_INLINE_SYSCALL_LINUX_SYSCALL(capget)
+#endif
+#ifdef __NR_capset
+JM_INLINE_SYSCALL_LINUX_SYSCALL(capset)
+#endif
+#ifdef __NR_rt_sigpending
+JM_INLINE_SYSCALL_LINUX_SYSCALL(rt_sigpending)
+#endif
+#ifdef __NR_rt_sigtimedwait
+JM_INLINE_SYSCALL_LINUX_SYSCALL(rt_sigtimedwait)
+#endif
+#ifdef __NR_rt_sigqueueinfo
+JM_INLINE_SYSCALL_LINUX_SYSCALL(rt_sigqueueinfo)
+#endif
+#ifdef __NR_rt_sigsuspend
+JM_INLINE_SYSCALL_LINUX_SYSCALL(rt_sigsuspend)
+#endif
+#ifdef __NR_sigaltstack
+JM_INLINE_SYSCALL_LINUX_SYSCALL(sigaltstack)
+#endif
+#ifdef __NR_utime
+JM_INLINE_SYSCALL_LINUX_SYSCALL(utime)
+#endif
+#ifdef __NR_mknod
+JM_INLINE_SYSCALL_LINUX_SYSCALL(mknod)
+#endif
+#ifdef __NR_uselib
+JM_INLINE_SYSCALL_LINUX_SYSCALL(uselib)
+#endif
+#ifdef __NR_personality
+JM_INLINE_SYSCALL_LINUX_SYSCALL(personality)
+#endif
+#ifdef __NR_ustat
+JM_INLINE_SYSCALL_LINUX_SYSCALL(ustat)
+#endif
+#ifdef __NR_statfs
+JM_INLINE_SYSCALL_LINUX_SYSCALL(statfs)
+#endif
+#ifdef __NR_fstatfs
+JM_INLINE_SYSCALL_LINUX_SYSCALL(fstatfs)
+#endif
+#ifdef __NR_sysfs
+JM_INLINE_SYSCALL_LINUX_SYSCALL(sysfs)
+#endif
+#ifdef __NR_getpriority
+JM_INLINE_SYSCALL_LINUX_SYSCALL(getpriority)
+#endif
+#ifdef __NR_setpriority
+JM_INLINE_SYSCALL_LINUX_SYSCALL(setpriority)
+#endif
+#ifdef __NR_sched_setparam
+JM_INLINE_SYSCALL_LINUX_SYSCALL(sched_setparam)
+#endif
+#ifdef __NR_sched_getparam
+JM_INLINE_SYSCALL_LINUX_SYSCALL(sched_getparam)
+#endif
+#ifdef __NR_sched_setscheduler
+JM_INLINE_SYSCALL_LINUX_SYSCALL(sched_setscheduler)
+#endif
+#ifdef __NR_sched_getscheduler
+JM_INLINE_SYSCALL_LINUX_SYSCALL(sched_getscheduler)
+#endif
+#ifdef __NR_sched_get_priority_max
+JM_INLINE_SYSCALL_LINUX_SYSCALL(sched_get_priority_max)
+#endif
+#ifdef __NR_sched_get_priority_min
+JM_INLINE_SYSCALL_LINUX_SYSCALL(sched_get_priority_min)
+#endif
+#ifdef __NR_sched_rr_get_interval
+JM_INLINE_SYSCALL_LINUX_SYSCALL(sched_rr_get_interval)
+#endif
+#ifdef __NR_mlock
+JM_INLINE_SYSCALL_LINUX_SYSCALL(mlock)
+#endif
+#ifdef __NR_munlock
+JM_INLINE_SYSCALL_LINUX_SYSCALL(munlock)
+#endif
+#ifdef __NR_mlockall
+JM_INLINE_SYSCALL_LINUX_SYSCALL(mlockall)
+#endif
+#ifdef __NR_munlockall
+JM_INLINE_SYSCALL_LINUX_SYSCALL(munlockall)
+#endif
+#ifdef __NR_vhangup
+JM_INLINE_SYSCALL_LINUX_SYSCALL(vhangup)
+#endif
+#ifdef __NR_modify_ldt
+JM_INLINE_SYSCALL_LINUX_SYSCALL(modify_ldt)
+#endif
+#ifdef __NR_pivot_root
+JM_INLINE_SYSCALL_LINUX_SYSCALL(pivot_root)
+#endif
+#ifdef __NR__sysctl
+JM_INLINE_SYSCALL_LINUX_SYSCALL(_sysctl)
+#endif
+#ifdef __NR_prctl
+JM_INLINE_SYSCALL_LINUX_SYSCALL(prctl)
+#endif
+#ifdef __NR_arch_prctl
+JM_INLINE_SYSCALL_LINUX_SYSCALL(arch_prctl)
+#endif
+#ifdef __NR_adjtimex
+JM_INLINE_SYSCALL_LINUX_SYSCALL(adjtimex)
+#endif
+#ifdef __NR_setrlimit
+JM_INLINE_SYSCALL_LINUX_SYSCALL(setrlimit)
+#endif
+#ifdef __NR_chroot
+JM_INLINE_SYSCALL_LINUX_SYSCALL(chroot)
+#endif
+#ifdef __NR_sync
+JM_INLINE_SYSCALL_LINUX_SYSCALL(sync)
+#endif
+#ifdef __NR_acct
+JM_INLINE_SYSCALL_LINUX_SYSCALL(acct)
+#endif
+#ifdef __NR_settimeofday
+JM_INLINE_SYSCALL_LINUX_SYSCALL(settimeofday)
+#endif
+#ifdef __NR_mount
+JM_INLINE_SYSCALL_LINUX_SYSCALL(mount)
+#endif
+#ifdef __NR_umount2
+JM_INLINE_SYSCALL_LINUX_SYSCALL(umount2)
+#endif
+#ifdef __NR_swapon
+JM_INLINE_SYSCALL_LINUX_SYSCALL(swapon)
+#endif
+#ifdef __NR_swapoff
+JM_INLINE_SYSCALL_LINUX_SYSCALL(swapoff)
+#endif
+#ifdef __NR_reboot
+JM_INLINE_SYSCALL_LINUX_SYSCALL(reboot)
+#endif
+#ifdef __NR_sethostname
+JM_INLINE_SYSCALL_LINUX_SYSCALL(sethostname)
+#endif
+#ifdef __NR_setdomainname
+JM_INLINE_SYSCALL_LINUX_SYSCALL(setdomainname)
+#endif
+#ifdef __NR_iopl
+JM_INLINE_SYSCALL_LINUX_SYSCALL(iopl)
+#endif
+#ifdef __NR_ioperm
+JM_INLINE_SYSCALL_LINUX_SYSCALL(ioperm)
+#endif
+#ifdef __NR_create_module
+JM_INLINE_SYSCALL_LINUX_SYSCALL(create_module)
+#endif
+#ifdef __NR_init_module
+JM_INLINE_SYSCALL_LINUX_SYSCALL(init_module)
+#endif
+#ifdef __NR_delete_module
+JM_INLINE_SYSCALL_LINUX_SYSCALL(delete_module)
+#endif
+#ifdef __NR_get_kernel_syms
+JM_INLINE_SYSCALL_LINUX_SYSCALL(get_kernel_syms)
+#endif
+#ifdef __NR_query_module
+JM_INLINE_SYSCALL_LINUX_SYSCALL(query_module)
+#endif
+#ifdef __NR_quotactl
+JM_INLINE_SYSCALL_LINUX_SYSCALL(quotactl)
+#endif
+#ifdef __NR_nfsservctl
+JM_INLINE_SYSCALL_LINUX_SYSCALL(nfsservctl)
+#endif
+#ifdef __NR_getpmsg
+JM_INLINE_SYSCALL_LINUX_SYSCALL(getpmsg)
+#endif
+#ifdef __NR_putpmsg
+JM_INLINE_SYSCALL_LINUX_SYSCALL(putpmsg)
+#endif
+#ifdef __NR_afs_syscall
+JM_INLINE_SYSCALL_LINUX_SYSCALL(afs_syscall)
+#endif
+#ifdef __NR_tuxcall
+JM_INLINE_SYSCALL_LINUX_SYSCALL(tuxcall)
+#endif
+#ifdef __NR_security
+JM_INLINE_SYSCALL_LINUX_SYSCALL(security)
+#endif
+#ifdef __NR_gettid
+JM_INLINE_SYSCALL_LINUX_SYSCALL(gettid)
+#endif
+#ifdef __NR_readahead
+JM_INLINE_SYSCALL_LINUX_SYSCALL(readahead)
+#endif
+#ifdef __NR_setxattr
+JM_INLINE_SYSCALL_LINUX_SYSCALL(setxattr)
+#endif
+#ifdef __NR_lsetxattr
+JM_INLINE_SYSCALL_LINUX_SYSCALL(lsetxattr)
+#endif
+#ifdef __NR_fsetxattr
+JM_INLINE_SYSCALL_LINUX_SYSCALL(fsetxattr)
+#endif
+#ifdef __NR_getxattr
+JM_INLINE_SYSCALL_LINUX_SYSCALL(getxattr)
+#endif
+#ifdef __NR_lgetxattr
+JM_INLINE_SYSCALL_LINUX_SYSCALL(lgetxattr)
+#endif
+#ifdef __NR_fgetxattr
+JM_INLINE_SYSCALL_LINUX_SYSCALL(fgetxattr)
+#endif
+#ifdef __NR_listxattr
+JM_INLINE_SYSCALL_LINUX_SYSCALL(listxattr)
+#endif
+#ifdef __NR_llistxattr
+JM_INLINE_SYSCALL_LINUX_SYSCALL(llistxattr)
+#endif
+#ifdef __NR_flistxattr
+JM_INLINE_SYSCALL_LINUX_SYSCALL(flistxattr)
+#endif
+#ifdef __NR_removexattr
+JM_INLINE_SYSCALL_LINUX_SYSCALL(removexattr)
+#endif
+#ifdef __NR_lremovexattr
+JM_INLINE_SYSCALL_LINUX_SYSCALL(lremovexattr)
+#endif
+#ifdef __NR_fremovexattr
+JM_INLINE_SYSCALL_LINUX_SYSCALL(fremovexattr)
+#endif
+#ifdef __NR_tkill
+JM_INLINE_SYSCALL_LINUX_SYSCALL(tkill)
+#endif
+#ifdef __NR_time
+JM_INLINE_SYSCALL_LINUX_SYSCALL(time)
+#endif
+#ifdef __NR_futex
+JM_INLINE_SYSCALL_LINUX_SYSCALL(futex)
+#endif
+#ifdef __NR_sched_setaffinity
+JM_INLINE_SYSCALL_LINUX_SYSCALL(sched_setaffinity)
+#endif
+#ifdef __NR_sched_getaffinity
+JM_INLINE_SYSCALL_LINUX_SYSCALL(sched_getaffinity)
+#endif
+#ifdef __NR_set_thread_area
+JM_INLINE_SYSCALL_LINUX_SYSCALL(set_thread_area)
+#endif
+#ifdef __NR_io_setup
+JM_INLINE_SYSCALL_LINUX_SYSCALL(io_setup)
+#endif
+#ifdef __NR_io_destroy
+JM_INLINE_SYSCALL_LINUX_SYSCALL(io_destroy)
+#endif
+#ifdef __NR_io_getevents
+JM_INLINE_SYSCALL_LINUX_SYSCALL(io_getevents)
+#endif
+#ifdef __NR_io_submit
+JM_INLINE_SYSCALL_LINUX_SYSCALL(io_submit)
+#endif
+#ifdef __NR_io_cancel
+JM_INLINE_SYSCALL_LINUX_SYSCALL(io_cancel)
+#endif
+#ifdef __NR_get_thread_area
+JM_INLINE_SYSCALL_LINUX_SYSCALL(get_thread_area)
+#endif
+#ifdef __NR_lookup_dcookie
+JM_INLINE_SYSCALL_LINUX_SYSCALL(lookup_dcookie)
+#endif
+#ifdef __NR_epoll_create
+JM_INLINE_SYSCALL_LINUX_SYSCALL(epoll_create)
+#endif
+#ifdef __NR_epoll_ctl_old
+JM_INLINE_SYSCALL_LINUX_SYSCALL(epoll_ctl_old)
+#endif
+#ifdef __NR_epoll_wait_old
+JM_INLINE_SYSCALL_LINUX_SYSCALL(epoll_wait_old)
+#endif
+#ifdef __NR_remap_file_pages
+JM_INLINE_SYSCALL_LINUX_SYSCALL(remap_file_pages)
+#endif
+#ifdef __NR_getdents64
+JM_INLINE_SYSCALL_LINUX_SYSCALL(getdents64)
+#endif
+#ifdef __NR_set_tid_address
+JM_INLINE_SYSCALL_LINUX_SYSCALL(set_tid_address)
+#endif
+#ifdef __NR_restart_syscall
+JM_INLINE_SYSCALL_LINUX_SYSCALL(restart_syscall)
+#endif
+#ifdef __NR_semtimedop
+JM_INLINE_SYSCALL_LINUX_SYSCALL(semtimedop)
+#endif
+#ifdef __NR_fadvise64
+JM_INLINE_SYSCALL_LINUX_SYSCALL(fadvise64)
+#endif
+#ifdef __NR_timer_create
+JM_INLINE_SYSCALL_LINUX_SYSCALL(timer_create)
+#endif
+#ifdef __NR_timer_settime
+JM_INLINE_SYSCALL_LINUX_SYSCALL(timer_settime)
+#endif
+#ifdef __NR_timer_gettime
+JM_INLINE_SYSCALL_LINUX_SYSCALL(timer_gettime)
+#endif
+#ifdef __NR_timer_getoverrun
+JM_INLINE_SYSCALL_LINUX_SYSCALL(timer_getoverrun)
+#endif
+#ifdef __NR_timer_delete
+JM_INLINE_SYSCALL_LINUX_SYSCALL(timer_delete)
+#endif
+#ifdef __NR_clock_settime
+JM_INLINE_SYSCALL_LINUX_SYSCALL(clock_settime)
+#endif
+#ifdef __NR_clock_gettime
+JM_INLINE_SYSCALL_LINUX_SYSCALL(clock_gettime)
+#endif
+#ifdef __NR_clock_getres
+JM_INLINE_SYSCALL_LINUX_SYSCALL(clock_getres)
+#endif
+#ifdef __NR_clock_nanosleep
+JM_INLINE_SYSCALL_LINUX_SYSCALL(clock_nanosleep)
+#endif
+#ifdef __NR_exit_group
+JM_INLINE_SYSCALL_LINUX_SYSCALL(exit_group)
+#endif
+#ifdef __NR_epoll_wait
+JM_INLINE_SYSCALL_LINUX_SYSCALL(epoll_wait)
+#endif
+#ifdef __NR_epoll_ctl
+JM_INLINE_SYSCALL_LINUX_SYSCALL(epoll_ctl)
+#endif
+#ifdef __NR_tgkill
+JM_INLINE_SYSCALL_LINUX_SYSCALL(tgkill)
+#endif
+#ifdef __NR_utimes
+JM_INLINE_SYSCALL_LINUX_SYSCALL(utimes)
+#endif
+#ifdef __NR_vserver
+JM_INLINE_SYSCALL_LINUX_SYSCALL(vserver)
+#endif
+#ifdef __NR_mbind
+JM_INLINE_SYSCALL_LINUX_SYSCALL(mbind)
+#endif
+#ifdef __NR_set_mempolicy
+JM_INLINE_SYSCALL_LINUX_SYSCALL(set_mempolicy)
+#endif
+#ifdef __NR_get_mempolicy
+JM_INLINE_SYSCALL_LINUX_SYSCALL(get_mempolicy)
+#endif
+#ifdef __NR_mq_open
+JM_INLINE_SYSCALL_LINUX_SYSCALL(mq_open)
+#endif
+#ifdef __NR_mq_unlink
+JM_INLINE_SYSCALL_LINUX_SYSCALL(mq_unlink)
+#endif
+#ifdef __NR_mq_timedsend
+JM_INLINE_SYSCALL_LINUX_SYSCALL(mq_timedsend)
+#endif
+#ifdef __NR_mq_timedreceive
+JM_INLINE_SYSCALL_LINUX_SYSCALL(mq_timedreceive)
+#endif
+#ifdef __NR_mq_notify
+JM_INLINE_SYSCALL_LINUX_SYSCALL(mq_notify)
+#endif
+#ifdef __NR_mq_getsetattr
+JM_INLINE_SYSCALL_LINUX_SYSCALL(mq_getsetattr)
+#endif
+#ifdef __NR_kexec_load
+JM_INLINE_SYSCALL_LINUX_SYSCALL(kexec_load)
+#endif
+#ifdef __NR_waitid
+JM_INLINE_SYSCALL_LINUX_SYSCALL(waitid)
+#endif
+#ifdef __NR_add_key
+JM_INLINE_SYSCALL_LINUX_SYSCALL(add_key)
+#endif
+#ifdef __NR_request_key
+JM_INLINE_SYSCALL_LINUX_SYSCALL(request_key)
+#endif
+#ifdef __NR_keyctl
+JM_INLINE_SYSCALL_LINUX_SYSCALL(keyctl)
+#endif
+#ifdef __NR_ioprio_set
+JM_INLINE_SYSCALL_LINUX_SYSCALL(ioprio_set)
+#endif
+#ifdef __NR_ioprio_get
+JM_INLINE_SYSCALL_LINUX_SYSCALL(ioprio_get)
+#endif
+#ifdef __NR_inotify_init
+JM_INLINE_SYSCALL_LINUX_SYSCALL(inotify_init)
+#endif
+#ifdef __NR_inotify_add_watch
+JM_INLINE_SYSCALL_LINUX_SYSCALL(inotify_add_watch)
+#endif
+#ifdef __NR_inotify_rm_watch
+JM_INLINE_SYSCALL_LINUX_SYSCALL(inotify_rm_watch)
+#endif
+#ifdef __NR_migrate_pages
+JM_INLINE_SYSCALL_LINUX_SYSCALL(migrate_pages)
+#endif
+#ifdef __NR_openat
+JM_INLINE_SYSCALL_LINUX_SYSCALL(openat)
+#endif
+#ifdef __NR_mkdirat
+JM_INLINE_SYSCALL_LINUX_SYSCALL(mkdirat)
+#endif
+#ifdef __NR_mknodat
+JM_INLINE_SYSCALL_LINUX_SYSCALL(mknodat)
+#endif
+#ifdef __NR_fchownat
+JM_INLINE_SYSCALL_LINUX_SYSCALL(fchownat)
+#endif
+#ifdef __NR_futimesat
+JM_INLINE_SYSCALL_LINUX_SYSCALL(futimesat)
+#endif
+#ifdef __NR_newfstatat
+JM_INLINE_SYSCALL_LINUX_SYSCALL(newfstatat)
+#endif
+#ifdef __NR_unlinkat
+JM_INLINE_SYSCALL_LINUX_SYSCALL(unlinkat)
+#endif
+#ifdef __NR_renameat
+JM_INLINE_SYSCALL_LINUX_SYSCALL(renameat)
+#endif
+#ifdef __NR_linkat
+JM_INLINE_SYSCALL_LINUX_SYSCALL(linkat)
+#endif
+#ifdef __NR_symlinkat
+JM_INLINE_SYSCALL_LINUX_SYSCALL(symlinkat)
+#endif
+#ifdef __NR_readlinkat
+JM_INLINE_SYSCALL_LINUX_SYSCALL(readlinkat)
+#endif
+#ifdef __NR_fchmodat
+JM_INLINE_SYSCALL_LINUX_SYSCALL(fchmodat)
+#endif
+#ifdef __NR_faccessat
+JM_INLINE_SYSCALL_LINUX_SYSCALL(faccessat)
+#endif
+#ifdef __NR_pselect6
+JM_INLINE_SYSCALL_LINUX_SYSCALL(pselect6)
+#endif
+#ifdef __NR_ppoll
+JM_INLINE_SYSCALL_LINUX_SYSCALL(ppoll)
+#endif
+#ifdef __NR_unshare
+JM_INLINE_SYSCALL_LINUX_SYSCALL(unshare)
+#endif
+#ifdef __NR_set_robust_list
+JM_INLINE_SYSCALL_LINUX_SYSCALL(set_robust_list)
+#endif
+#ifdef __NR_get_robust_list
+JM_INLINE_SYSCALL_LINUX_SYSCALL(get_robust_list)
+#endif
+#ifdef __NR_splice
+JM_INLINE_SYSCALL_LINUX_SYSCALL(splice)
+#endif
+#ifdef __NR_tee
+JM_INLINE_SYSCALL_LINUX_SYSCALL(tee)
+#endif
+#ifdef __NR_sync_file_range
+JM_INLINE_SYSCALL_LINUX_SYSCALL(sync_file_range)
+#endif
+#ifdef __NR_vmsplice
+JM_INLINE_SYSCALL_LINUX_SYSCALL(vmsplice)
+#endif
+#ifdef __NR_move_pages
+JM_INLINE_SYSCALL_LINUX_SYSCALL(move_pages)
+#endif
+#ifdef __NR_utimensat
+JM_INLINE_SYSCALL_LINUX_SYSCALL(utimensat)
+#endif
+#ifdef __NR_epoll_pwait
+JM_INLINE_SYSCALL_LINUX_SYSCALL(epoll_pwait)
+#endif
+#ifdef __NR_signalfd
+JM_INLINE_SYSCALL_LINUX_SYSCALL(signalfd)
+#endif
+#ifdef __NR_timerfd_create
+JM_INLINE_SYSCALL_LINUX_SYSCALL(timerfd_create)
+#endif
+#ifdef __NR_eventfd
+JM_INLINE_SYSCALL_LINUX_SYSCALL(eventfd)
+#endif
+#ifdef __NR_fallocate
+JM_INLINE_SYSCALL_LINUX_SYSCALL(fallocate)
+#endif
+#ifdef __NR_timerfd_settime
+JM_INLINE_SYSCALL_LINUX_SYSCALL(timerfd_settime)
+#endif
+#ifdef __NR_timerfd_gettime
+JM_INLINE_SYSCALL_LINUX_SYSCALL(timerfd_gettime)
+#endif
+#ifdef __NR_accept4
+JM_INLINE_SYSCALL_LINUX_SYSCALL(accept4)
+#endif
+#ifdef __NR_signalfd4
+JM_INLINE_SYSCALL_LINUX_SYSCALL(signalfd4)
+#endif
+#ifdef __NR_eventfd2
+JM_INLINE_SYSCALL_LINUX_SYSCALL(eventfd2)
+#endif
+#ifdef __NR_epoll_create1
+JM_INLINE_SYSCALL_LINUX_SYSCALL(epoll_create1)
+#endif
+#ifdef __NR_dup3
+JM_INLINE_SYSCALL_LINUX_SYSCALL(dup3)
+#endif
+#ifdef __NR_pipe2
+JM_INLINE_SYSCALL_LINUX_SYSCALL(pipe2)
+#endif
+#ifdef __NR_inotify_init1
+JM_INLINE_SYSCALL_LINUX_SYSCALL(inotify_init1)
+#endif
+#ifdef __NR_preadv
+JM_INLINE_SYSCALL_LINUX_SYSCALL(preadv)
+#endif
+#ifdef __NR_pwritev
+JM_INLINE_SYSCALL_LINUX_SYSCALL(pwritev)
+#endif
+#ifdef __NR_rt_tgsigqueueinfo
+JM_INLINE_SYSCALL_LINUX_SYSCALL(rt_tgsigqueueinfo)
+#endif
+#ifdef __NR_perf_event_open
+JM_INLINE_SYSCALL_LINUX_SYSCALL(perf_event_open)
+#endif
+#ifdef __NR_recvmmsg
+JM_INLINE_SYSCALL_LINUX_SYSCALL(recvmmsg)
+#endif
+#ifdef __NR_fanotify_init
+JM_INLINE_SYSCALL_LINUX_SYSCALL(fanotify_init)
+#endif
+#ifdef __NR_fanotify_mark
+JM_INLINE_SYSCALL_LINUX_SYSCALL(fanotify_mark)
+#endif
+#ifdef __NR_prlimit64
+JM_INLINE_SYSCALL_LINUX_SYSCALL(prlimit64)
+#endif
+#ifdef __NR_name_to_handle_at
+JM_INLINE_SYSCALL_LINUX_SYSCALL(name_to_handle_at)
+#endif
+#ifdef __NR_open_by_handle_at
+JM_INLINE_SYSCALL_LINUX_SYSCALL(open_by_handle_at)
+#endif
+#ifdef __NR_clock_adjtime
+JM_INLINE_SYSCALL_LINUX_SYSCALL(clock_adjtime)
+#endif
+#ifdef __NR_syncfs
+JM_INLINE_SYSCALL_LINUX_SYSCALL(syncfs)
+#endif
+#ifdef __NR_sendmmsg
+JM_INLINE_SYSCALL_LINUX_SYSCALL(sendmmsg)
+#endif
+#ifdef __NR_setns
+JM_INLINE_SYSCALL_LINUX_SYSCALL(setns)
+#endif
+#ifdef __NR_getcpu
+JM_INLINE_SYSCALL_LINUX_SYSCALL(getcpu)
+#endif
+#ifdef __NR_process_vm_readv
+JM_INLINE_SYSCALL_LINUX_SYSCALL(process_vm_readv)
+#endif
+#ifdef __NR_process_vm_writev
+JM_INLINE_SYSCALL_LINUX_SYSCALL(process_vm_writev)
+#endif
+#ifdef __NR_kcmp
+JM_INLINE_SYSCALL_LINUX_SYSCALL(kcmp)
+#endif
+#ifdef __NR_finit_module
+JM_INLINE_SYSCALL_LINUX_SYSCALL(finit_module)
+#endif
+#ifdef __NR_sched_setattr
+JM_INLINE_SYSCALL_LINUX_SYSCALL(sched_setattr)
+#endif
+#ifdef __NR_sched_getattr
+JM_INLINE_SYSCALL_LINUX_SYSCALL(sched_getattr)
+#endif
+#ifdef __NR_renameat2
+JM_INLINE_SYSCALL_LINUX_SYSCALL(renameat2)
+#endif
+#ifdef __NR_seccomp
+JM_INLINE_SYSCALL_LINUX_SYSCALL(seccomp)
+#endif
+#ifdef __NR_getrandom
+JM_INLINE_SYSCALL_LINUX_SYSCALL(getrandom)
+#endif
+#ifdef __NR_memfd_create
+JM_INLINE_SYSCALL_LINUX_SYSCALL(memfd_create)
+#endif
+#ifdef __NR_kexec_file_load
+JM_INLINE_SYSCALL_LINUX_SYSCALL(kexec_file_load)
+#endif
+#ifdef __NR_bpf
+JM_INLINE_SYSCALL_LINUX_SYSCALL(bpf)
+#endif
+#ifdef __NR_execveat
+JM_INLINE_SYSCALL_LINUX_SYSCALL(execveat)
+#endif
+#ifdef __NR_userfaultfd
+JM_INLINE_SYSCALL_LINUX_SYSCALL(userfaultfd)
+#endif
+#ifdef __NR_membarrier
+JM_INLINE_SYSCALL_LINUX_SYSCALL(membarrier)
+#endif
+#ifdef __NR_mlock2
+JM_INLINE_SYSCALL_LINUX_SYSCALL(mlock2)
+#endif
+#ifdef __NR_copy_file_range
+JM_INLINE_SYSCALL_LINUX_SYSCALL(copy_file_range)
+#endif
+#ifdef __NR_preadv2
+JM_INLINE_SYSCALL_LINUX_SYSCALL(preadv2)
+#endif
+#ifdef __NR_pwritev2
+JM_INLINE_SYSCALL_LINUX_SYSCALL(pwritev2)
+#endif
+#ifdef __NR_pkey_mprotect
+JM_INLINE_SYSCALL_LINUX_SYSCALL(pkey_mprotect)
+#endif
+#ifdef __NR_pkey_alloc
+JM_INLINE_SYSCALL_LINUX_SYSCALL(pkey_alloc)
+#endif
+#ifdef __NR_pkey_free
+JM_INLINE_SYSCALL_LINUX_SYSCALL(pkey_free)
+#endif
+#ifdef __NR_statx
+JM_INLINE_SYSCALL_LINUX_SYSCALL(statx)
+#endif
+#ifdef __NR_io_pgetevents
+JM_INLINE_SYSCALL_LINUX_SYSCALL(io_pgetevents)
+#endif
+#ifdef __NR_rseq
+JM_INLINE_SYSCALL_LINUX_SYSCALL(rseq)
+#endif
+#ifdef __NR_pidfd_send_signal
+JM_INLINE_SYSCALL_LINUX_SYSCALL(pidfd_send_signal)
+#endif
+#ifdef __NR_io_uring_setup
+JM_INLINE_SYSCALL_LINUX_SYSCALL(io_uring_setup)
+#endif
+#ifdef __NR_io_uring_enter
+JM_INLINE_SYSCALL_LINUX_SYSCALL(io_uring_enter)
+#endif
+#ifdef __NR_io_uring_register
+JM_INLINE_SYSCALL_LINUX_SYSCALL(io_uring_register)
+#endif
+#ifdef __NR_open_tree
+JM_INLINE_SYSCALL_LINUX_SYSCALL(open_tree)
+#endif
+#ifdef __NR_move_mount
+JM_INLINE_SYSCALL_LINUX_SYSCALL(move_mount)
+#endif
+#ifdef __NR_fsopen
+JM_INLINE_SYSCALL_LINUX_SYSCALL(fsopen)
+#endif
+#ifdef __NR_fsconfig
+JM_INLINE_SYSCALL_LINUX_SYSCALL(fsconfig)
+#endif
+#ifdef __NR_fsmount
+JM_INLINE_SYSCALL_LINUX_SYSCALL(fsmount)
+#endif
+#ifdef __NR_fspick
+JM_INLINE_SYSCALL_LINUX_SYSCALL(fspick)
+#endif
+#ifdef __NR_pidfd_open
+JM_INLINE_SYSCALL_LINUX_SYSCALL(pidfd_open)
+#endif
+#ifdef __NR_clone3
+JM_INLINE_SYSCALL_LINUX_SYSCALL(clone3)
+#endif
+#ifdef __NR_close_range
+JM_INLINE_SYSCALL_LINUX_SYSCALL(close_range)
+#endif
+#ifdef __NR_openat2
+JM_INLINE_SYSCALL_LINUX_SYSCALL(openat2)
+#endif
+#ifdef __NR_pidfd_getfd
+JM_INLINE_SYSCALL_LINUX_SYSCALL(pidfd_getfd)
+#endif
+#ifdef __NR_faccessat2
+JM_INLINE_SYSCALL_LINUX_SYSCALL(faccessat2)
+#endif
+#ifdef __NR_process_madvise
+JM_INLINE_SYSCALL_LINUX_SYSCALL(process_madvise)
+#endif
+#ifdef __NR_epoll_pwait2
+JM_INLINE_SYSCALL_LINUX_SYSCALL(epoll_pwait2)
+#endif
+#ifdef __NR_mount_setattr
+JM_INLINE_SYSCALL_LINUX_SYSCALL(mount_setattr)
+#endif
+#ifdef __NR_quotactl_fd
+JM_INLINE_SYSCALL_LINUX_SYSCALL(quotactl_fd)
+#endif
+#ifdef __NR_landlock_create_ruleset
+JM_INLINE_SYSCALL_LINUX_SYSCALL(landlock_create_ruleset)
+#endif
+#ifdef __NR_landlock_add_rule
+JM_INLINE_SYSCALL_LINUX_SYSCALL(landlock_add_rule)
+#endif
+#ifdef __NR_landlock_restrict_self
+JM_INLINE_SYSCALL_LINUX_SYSCALL(landlock_restrict_self)
+#endif
+#ifdef __NR_memfd_secret
+JM_INLINE_SYSCALL_LINUX_SYSCALL(memfd_secret)
+#endif
+#ifdef __NR_process_mrelease
+JM_INLINE_SYSCALL_LINUX_SYSCALL(process_mrelease)
+#endif
+#ifdef __NR_futex_waitv
+JM_INLINE_SYSCALL_LINUX_SYSCALL(futex_waitv)
+#endif
+#ifdef __NR_set_mempolicy_home_node
+JM_INLINE_SYSCALL_LINUX_SYSCALL(set_mempolicy_home_node)
+#endif
+#ifdef __NR_sync_file_range2
+JM_INLINE_SYSCALL_LINUX_SYSCALL(sync_file_range2)
+#endif
+#ifdef __NR_clock_gettime64
+JM_INLINE_SYSCALL_LINUX_SYSCALL(clock_gettime64)
+#endif
+#ifdef __NR_clock_settime64
+JM_INLINE_SYSCALL_LINUX_SYSCALL(clock_settime64)
+#endif
+#ifdef __NR_clock_adjtime64
+JM_INLINE_SYSCALL_LINUX_SYSCALL(clock_adjtime64)
+#endif
+#ifdef __NR_clock_getres_time64
+JM_INLINE_SYSCALL_LINUX_SYSCALL(clock_getres_time64)
+#endif
+#ifdef __NR_clock_nanosleep_time64
+JM_INLINE_SYSCALL_LINUX_SYSCALL(clock_nanosleep_time64)
+#endif
+#ifdef __NR_timer_gettime64
+JM_INLINE_SYSCALL_LINUX_SYSCALL(timer_gettime64)
+#endif
+#ifdef __NR_timer_settime64
+JM_INLINE_SYSCALL_LINUX_SYSCALL(timer_settime64)
+#endif
+#ifdef __NR_timerfd_gettime64
+JM_INLINE_SYSCALL_LINUX_SYSCALL(timerfd_gettime64)
+#endif
+#ifdef __NR_timerfd_settime64
+JM_INLINE_SYSCALL_LINUX_SYSCALL(timerfd_settime64)
+#endif
+#ifdef __NR_utimensat_time64
+JM_INLINE_SYSCALL_LINUX_SYSCALL(utimensat_time64)
+#endif
+#ifdef __NR_pselect6_time64
+JM_INLINE_SYSCALL_LINUX_SYSCALL(pselect6_time64)
+#endif
+#ifdef __NR_ppoll_time64
+JM_INLINE_SYSCALL_LINUX_SYSCALL(ppoll_time64)
+#endif
+#ifdef __NR_io_pgetevents_time64
+JM_INLINE_SYSCALL_LINUX_SYSCALL(io_pgetevents_time64)
+#endif
+#ifdef __NR_recvmmsg_time64
+JM_INLINE_SYSCALL_LINUX_SYSCALL(recvmmsg_time64)
+#endif
+#ifdef __NR_mq_timedsend_time64
+JM_INLINE_SYSCALL_LINUX_SYSCALL(mq_timedsend_time64)
+#endif
+#ifdef __NR_mq_timedreceive_time64
+JM_INLINE_SYSCALL_LINUX_SYSCALL(mq_timedreceive_time64)
+#endif
+#ifdef __NR_semtimedop_time64
+JM_INLINE_SYSCALL_LINUX_SYSCALL(semtimedop_time64)
+#endif
+#ifdef __NR_rt_sigtimedwait_time64
+JM_INLINE_SYSCALL_LINUX_SYSCALL(rt_sigtimedwait_time64)
+#endif
+#ifdef __NR_futex_time64
+JM_INLINE_SYSCALL_LINUX_SYSCALL(futex_time64)
+#endif
+#ifdef __NR_sched_rr_get_interval_time64
+JM_INLINE_SYSCALL_LINUX_SYSCALL(sched_rr_get_interval_time64)
+#endif
+#ifdef __NR_fcntl64
+JM_INLINE_SYSCALL_LINUX_SYSCALL(fcntl64)
+#endif
+#ifdef __NR_statfs64
+JM_INLINE_SYSCALL_LINUX_SYSCALL(statfs64)
+#endif
+#ifdef __NR_fstatfs64
+JM_INLINE_SYSCALL_LINUX_SYSCALL(fstatfs64)
+#endif
+#ifdef __NR_truncate64
+JM_INLINE_SYSCALL_LINUX_SYSCALL(truncate64)
+#endif
+#ifdef __NR_ftruncate64
+JM_INLINE_SYSCALL_LINUX_SYSCALL(ftruncate64)
+#endif
+#ifdef __NR_llseek
+JM_INLINE_SYSCALL_LINUX_SYSCALL(llseek)
+#endif
+#ifdef __NR_sendfile64
+JM_INLINE_SYSCALL_LINUX_SYSCALL(sendfile64)
+#endif
+#ifdef __NR_fstatat64
+JM_INLINE_SYSCALL_LINUX_SYSCALL(fstatat64)
+#endif
+#ifdef __NR_fstat64
+JM_INLINE_SYSCALL_LINUX_SYSCALL(fstat64)
+#endif
+#ifdef __NR_mmap2
+JM_INLINE_SYSCALL_LINUX_SYSCALL(mmap2)
+#endif
+#ifdef __NR_fadvise64_64
+JM_INLINE_SYSCALL_LINUX_SYSCALL(fadvise64_64)
+#endif
+#ifdef __NR_stat64
+JM_INLINE_SYSCALL_LINUX_SYSCALL(stat64)
+#endif
+#ifdef __NR_lstat64
+JM_INLINE_SYSCALL_LINUX_SYSCALL(lstat64)
+#endif
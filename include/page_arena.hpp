@@ -0,0 +1,478 @@
+/*
+ * Copyright 2018-2020 Justas Masiulis
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef JM_INLINE_SYSCALL_PAGE_ARENA_HPP
+#define JM_INLINE_SYSCALL_PAGE_ARENA_HPP
+
+#include "inline_syscall.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <sys/auxv.h>
+#include <sys/mman.h>
+
+#if !defined(__linux__)
+#error "page_arena.hpp is only available on linux"
+#endif
+
+namespace jm {
+
+    /// \brief What backs the memory of page_arena, page_buffer and page_pool.
+    enum class huge_pages {
+        none,
+        /// Asks for transparent huge pages with MADV_HUGEPAGE. Falls back to normal pages
+        /// silently if THP is disabled.
+        transparent,
+        /// Maps the memory from the hugetlbfs pool with MAP_HUGETLB, which has to be
+        /// set up through /proc/sys/vm/nr_hugepages. Mapping fails with -ENOMEM when the
+        /// pool runs out.
+        hugetlb,
+    };
+
+    struct page_options {
+        huge_pages huge = huge_pages::none;
+        /// The size of huge pages, which has to be one that the system supports.
+        std::size_t huge_page_size = std::size_t{ 2 } << 20;
+        /// Prefaults the memory when it is mapped instead of on first touch. Transparent
+        /// huge pages and grown page_buffers are prefaulted only since linux 5.14.
+        bool populate = false;
+        /// Gives memory back with MADV_FREE, which lets the kernel reclaim it only under
+        /// memory pressure, instead of MADV_DONTNEED. Touching memory released this way may
+        /// see its old contents instead of zeroes.
+        bool lazy_release = false;
+    };
+
+    namespace detail {
+
+        // libc declares it as variadic
+        using mremap =
+            void*(void* address, std::size_t size, std::size_t new_size, int flags, void*);
+
+        // the kernel returns -errno which ends up as an address in the last page.
+        // Returns 0 if the mapping succeeded.
+        inline int map_error(void* address) noexcept
+        {
+            const auto value = reinterpret_cast<std::uintptr_t>(address);
+            return value > static_cast<std::uintptr_t>(-4096) ? static_cast<int>(value) : 0;
+        }
+
+        inline std::size_t page_size() noexcept
+        {
+            const auto size = ::getauxval(AT_PAGESZ);
+            return size ? size : 4096;
+        }
+
+        inline std::size_t round_up(std::size_t value, std::size_t alignment) noexcept
+        {
+            return (value + alignment - 1) & ~(alignment - 1);
+        }
+
+        // the granularity in which memory of the given options can be mapped and released
+        inline std::size_t mapping_alignment(const page_options& options) noexcept
+        {
+            if(options.huge == huge_pages::none)
+                return page_size();
+            return std::max(options.huge_page_size, page_size());
+        }
+
+        inline int mapping_flags(const page_options& options) noexcept
+        {
+            int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+            // transparent huge pages are populated after MADV_HUGEPAGE, otherwise the
+            // memory would be faulted in as normal pages.
+            if(options.populate && options.huge != huge_pages::transparent)
+                flags |= MAP_POPULATE;
+            if(options.huge == huge_pages::hugetlb)
+                flags |= MAP_HUGETLB |
+                         __builtin_ctzll(options.huge_page_size) << MAP_HUGE_SHIFT;
+            return flags;
+        }
+
+        // faults in the pages of an existing mapping. Does nothing before linux 5.14.
+        inline void populate_pages(void* address, std::size_t size) noexcept
+        {
+            constexpr int populate_write = 23; // MADV_POPULATE_WRITE
+            INLINE_SYSCALL(madvise)(address, size, populate_write);
+        }
+
+        // maps readable and writable memory at the given address, or anywhere if it is
+        // nullptr. Returns the address or -errno as one.
+        inline void* map_pages(void*               address,
+                               std::size_t         size,
+                               const page_options& options) noexcept
+        {
+            const auto flags = mapping_flags(options) | (address ? MAP_FIXED : 0);
+            const auto result =
+                INLINE_SYSCALL(mmap)(address, size, PROT_READ | PROT_WRITE, flags, -1, 0);
+            // THP is a property of the mapping that survives mremap, but not MAP_FIXED
+            if(!map_error(result) && options.huge == huge_pages::transparent) {
+                INLINE_SYSCALL(madvise)(result, size, MADV_HUGEPAGE);
+                if(options.populate)
+                    populate_pages(result, size);
+            }
+            return result;
+        }
+
+        inline void* remap_pages(void*       address,
+                                 std::size_t size,
+                                 std::size_t new_size,
+                                 bool        may_move) noexcept
+        {
+            return INLINE_SYSCALL_T(mremap)(
+                address, size, new_size, may_move ? MREMAP_MAYMOVE : 0, nullptr);
+        }
+
+        inline int release_pages(void*               address,
+                                 std::size_t         size,
+                                 const page_options& options) noexcept
+        {
+            // hugetlb mappings don't support MADV_FREE and linux before 4.5 doesn't have it
+            if(options.lazy_release && options.huge != huge_pages::hugetlb) {
+                const auto result = INLINE_SYSCALL(madvise)(address, size, MADV_FREE);
+                if(result != -EINVAL)
+                    return result;
+            }
+            return INLINE_SYSCALL(madvise)(address, size, MADV_DONTNEED);
+        }
+
+    } // namespace detail
+
+    /// \brief Reserves a range of address space up front and commits it in chunks as
+    ///        allocations reach it, so that the memory is contiguous and never moves.
+    ///        Allocating is a pointer bump unless a new chunk has to be committed.
+    /// \note Not thread safe. Talks to the kernel through inlined syscalls only.
+    class page_arena {
+        char*        _base      = nullptr;
+        std::size_t  _reserved  = 0;
+        std::size_t  _committed = 0;
+        std::size_t  _used      = 0;
+        std::size_t  _chunk     = 0;
+        page_options _options;
+        int          _error = 0;
+
+    public:
+        /// \brief Reserves the address space without committing any of it.
+        /// \param reserve The size of the reservation, which is the most that can be
+        ///                allocated from the arena.
+        /// \param commit_size The size of chunks in which the memory is committed, rounded
+        ///                    up to the page or the huge page size.
+        /// \note Check error() to see whether the reservation succeeded.
+        explicit page_arena(std::size_t  reserve,
+                            page_options options     = {},
+                            std::size_t  commit_size = 0x10000) noexcept
+            : _options(options)
+        {
+            const auto alignment = detail::mapping_alignment(options);
+            _chunk = detail::round_up(std::max(commit_size, alignment), alignment);
+
+            // the reservation is aligned to huge pages so that every committed chunk can be
+            // backed by them. Reserving doesn't need memory nor hugetlb pages.
+            const auto reserved = detail::round_up(reserve, _chunk);
+            const auto size     = reserved + alignment - detail::page_size();
+            const auto flags    = MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE;
+            const auto address  = INLINE_SYSCALL(mmap)(nullptr, size, PROT_NONE, flags, -1, 0);
+            if((_error = detail::map_error(address)))
+                return;
+
+            const auto start = reinterpret_cast<std::uintptr_t>(address);
+            const auto base  = detail::round_up(start, alignment);
+            if(base != start)
+                INLINE_SYSCALL(munmap)(address, base - start);
+            const auto end = base + reserved;
+            if(start + size != end)
+                INLINE_SYSCALL(munmap)(reinterpret_cast<void*>(end), start + size - end);
+
+            _base     = reinterpret_cast<char*>(base);
+            _reserved = reserved;
+        }
+
+        page_arena(const page_arena&) = delete;
+        page_arena& operator=(const page_arena&) = delete;
+
+        ~page_arena()
+        {
+            if(_base)
+                INLINE_SYSCALL(munmap)(_base, _reserved);
+        }
+
+        /// \brief Returns 0 if the address space was reserved successfully or -errno.
+        int error() const noexcept { return _error; }
+
+        char* data() const noexcept { return _base; }
+
+        std::size_t used() const noexcept { return _used; }
+
+        std::size_t committed() const noexcept { return _committed; }
+
+        std::size_t reserved() const noexcept { return _reserved; }
+
+        const page_options& options() const noexcept { return _options; }
+
+        /// \brief Commits memory up to the given offset from data() in whole chunks.
+        /// \returns 0 or -errno, -ENOMEM if it is past the reservation.
+        int commit(std::size_t size) noexcept
+        {
+            if(size <= _committed)
+                return 0;
+            if(size > _reserved)
+                return -ENOMEM;
+
+            // mapping over the reservation commits it, and adjacent chunks are merged into
+            // a single mapping by the kernel.
+            const auto end = std::min(detail::round_up(size, _chunk), _reserved);
+            const auto result =
+                detail::map_pages(_base + _committed, end - _committed, _options);
+            if(const auto error = detail::map_error(result))
+                return error;
+
+            _committed = end;
+            return 0;
+        }
+
+        /// \brief Allocates memory aligned to at most the page size.
+        /// \returns nullptr if the reservation is exhausted or committing memory failed.
+        void* allocate(std::size_t size,
+                       std::size_t alignment = alignof(std::max_align_t)) noexcept
+        {
+            const auto offset = detail::round_up(_used, alignment);
+            if(offset > _reserved || size > _reserved - offset)
+                return nullptr;
+            if(offset + size > _committed && commit(offset + size) != 0)
+                return nullptr;
+
+            _used = offset + size;
+            return _base + offset;
+        }
+
+        /// \brief Frees everything that was allocated. The memory stays committed, use
+        ///        release to give it back to the kernel.
+        void reset() noexcept { _used = 0; }
+
+        /// \brief Gives the committed memory that is neither used nor among the first keep
+        ///        bytes back to the kernel with a single madvise. It stays committed and
+        ///        reads as zeroes when touched again, unless released lazily.
+        /// \returns 0 or -errno.
+        int release(std::size_t keep = 0) noexcept
+        {
+            const auto start = detail::round_up(std::max(keep, _used),
+                                                detail::mapping_alignment(_options));
+            if(start >= _committed)
+                return 0;
+
+            return detail::release_pages(_base + start, _committed - start, _options);
+        }
+    };
+
+    /// \brief A contiguous block of memory that grows and shrinks with mremap, in place
+    ///        when the address space after it is free. The contents are kept.
+    /// \note Not thread safe. Talks to the kernel through inlined syscalls only.
+    class page_buffer {
+        char*        _data = nullptr;
+        std::size_t  _size = 0;
+        page_options _options;
+        int          _error = 0;
+
+    public:
+        /// \brief Maps the buffer rounded up to the page or the huge page size.
+        /// \note Check error() to see whether the mapping succeeded.
+        explicit page_buffer(std::size_t size, page_options options = {}) noexcept
+            : _options(options)
+        {
+            _error = resize(size);
+        }
+
+        page_buffer(const page_buffer&) = delete;
+        page_buffer& operator=(const page_buffer&) = delete;
+
+        ~page_buffer()
+        {
+            if(_data)
+                INLINE_SYSCALL(munmap)(_data, _size);
+        }
+
+        /// \brief Returns 0 if the buffer was mapped successfully or -errno.
+        int error() const noexcept { return _error; }
+
+        char* data() const noexcept { return _data; }
+
+        std::size_t size() const noexcept { return _size; }
+
+        /// \brief Resizes the buffer, keeping its contents.
+        /// \param may_move Whether the buffer can be moved if it can't grow in place.
+        ///                 data() changes if it was.
+        /// \returns 0 or -errno, -ENOMEM if it can't grow in place and may not move.
+        int resize(std::size_t size, bool may_move = true) noexcept
+        {
+            size = detail::round_up(size, detail::mapping_alignment(_options));
+            if(size == _size)
+                return 0;
+
+            if(!_data) {
+                const auto result = detail::map_pages(nullptr, size, _options);
+                if(const auto error = detail::map_error(result))
+                    return error;
+                _data = static_cast<char*>(result);
+                _size = size;
+                return 0;
+            }
+
+            if(size == 0) {
+                INLINE_SYSCALL(munmap)(_data, _size);
+                _data = nullptr;
+                _size = 0;
+                return 0;
+            }
+
+            const auto result = detail::remap_pages(_data, _size, size, may_move);
+            if(const auto error = detail::map_error(result))
+                return error;
+
+            // mremap doesn't populate the pages it adds
+            const auto data = static_cast<char*>(result);
+            if(_options.populate && size > _size)
+                detail::populate_pages(data + _size, size - _size);
+
+            _data = data;
+            _size = size;
+            return 0;
+        }
+
+        /// \brief Gives the memory from the given offset to the end back to the kernel
+        ///        without unmapping it.
+        /// \returns 0 or -errno.
+        int release(std::size_t offset = 0) noexcept
+        {
+            offset = detail::round_up(offset, detail::mapping_alignment(_options));
+            if(offset >= _size)
+                return 0;
+
+            return detail::release_pages(_data + offset, _size - offset, _options);
+        }
+    };
+
+    /// \brief Hands out blocks of a fixed size that is a multiple of the page size, carved
+    ///        out of a page_arena. Freed blocks are reused most recently freed first, while
+    ///        they are still warm, and their memory is given back to the kernel in batches
+    ///        by release.
+    /// \note Not thread safe. Talks to the kernel through inlined syscalls only.
+    class page_pool {
+        page_arena  _arena;
+        std::size_t _block_size;
+        // indices of free blocks. The ones below _released were given back to the kernel,
+        // the ones above are dirty. The blocks themselves can't hold the list, because
+        // releasing them drops their contents.
+        page_buffer   _free;
+        std::uint32_t _count    = 0;
+        std::uint32_t _released = 0;
+        std::uint32_t _blocks   = 0;
+
+        std::uint32_t* free_list() const noexcept
+        {
+            return reinterpret_cast<std::uint32_t*>(_free.data());
+        }
+
+        char* block(std::uint32_t index) const noexcept
+        {
+            return _arena.data() + static_cast<std::size_t>(index) * _block_size;
+        }
+
+    public:
+        /// \param block_size The size of blocks, rounded up to the page or the huge page
+        ///                   size.
+        /// \param max_blocks The number of blocks the address space is reserved for.
+        /// \param commit_size The size of chunks in which the arena commits memory.
+        /// \note Check error() to see whether the reservation succeeded.
+        page_pool(std::size_t  block_size,
+                  std::size_t  max_blocks,
+                  page_options options     = {},
+                  std::size_t  commit_size = 0x10000) noexcept
+            : _arena(detail::round_up(block_size, detail::mapping_alignment(options)) *
+                         std::min<std::size_t>(max_blocks, UINT32_MAX),
+                     options,
+                     commit_size)
+            , _block_size(detail::round_up(block_size, detail::mapping_alignment(options)))
+            , _free(0)
+        {}
+
+        /// \brief Returns 0 if the address space was reserved successfully or -errno.
+        int error() const noexcept { return _arena.error(); }
+
+        std::size_t block_size() const noexcept { return _block_size; }
+
+        /// \brief The number of free blocks that weren't given back to the kernel yet.
+        std::size_t dirty() const noexcept { return _count - _released; }
+
+        /// \returns nullptr if every block is in use or committing memory failed.
+        void* allocate() noexcept
+        {
+            if(_count != 0) {
+                const auto index = free_list()[--_count];
+                _released        = std::min(_released, _count);
+                return block(index);
+            }
+
+            // the free list is made big enough for every block up front, so that free
+            // never fails.
+            const auto needed = (std::size_t{ _blocks } + 1) * sizeof(std::uint32_t);
+            if(needed > _free.size() && _free.resize(std::max(needed, _free.size() * 2)))
+                return nullptr;
+
+            const auto result = _arena.allocate(_block_size, 1);
+            if(result)
+                ++_blocks;
+            return result;
+        }
+
+        /// \brief Returns a block given out by allocate to the pool. Its memory stays
+        ///        committed until release.
+        void free(void* pointer) noexcept
+        {
+            const auto offset = static_cast<char*>(pointer) - _arena.data();
+            free_list()[_count++] =
+                static_cast<std::uint32_t>(static_cast<std::size_t>(offset) / _block_size);
+        }
+
+        /// \brief Gives the memory of every free block back to the kernel, with a single
+        ///        madvise for every run of adjacent blocks.
+        /// \returns 0 or the first -errno.
+        int release() noexcept
+        {
+            const auto first = free_list() + _released;
+            const auto last  = free_list() + _count;
+            std::sort(first, last);
+
+            int result = 0;
+            for(auto run = first; run != last;) {
+                auto end = run + 1;
+                while(end != last && *end == *(end - 1) + 1)
+                    ++end;
+
+                const auto size  = static_cast<std::size_t>(end - run) * _block_size;
+                const auto error =
+                    detail::release_pages(block(*run), size, _arena.options());
+                if(result == 0)
+                    result = error;
+                run = end;
+            }
+
+            _released = _count;
+            return result;
+        }
+    };
+
+} // namespace jm
+
+#endif // JM_INLINE_SYSCALL_PAGE_ARENA_HPP
@@ -0,0 +1,235 @@
+/*
+ * Copyright 2018-2020 Justas Masiulis
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef JM_INLINE_SYSCALL_PATCH_INIT_HPP
+#define JM_INLINE_SYSCALL_PATCH_INIT_HPP
+
+#include "in_memory_init.hpp"
+#include <cstddef>
+
+#if !defined(JM_INLINE_SYSCALL_PATCHED_IDS)
+#error "patch_init.hpp needs JM_INLINE_SYSCALL_PATCHED_IDS to be defined"
+#endif
+
+namespace jm {
+
+#if defined(_WIN32) || defined(__linux__)
+    /// \brief Patches every call site with ids from ntdll.dll loaded in current process
+    ///        on windows or with the syscall numbers of the kernel on linux.
+    inline bool patch_syscall_sites() noexcept;
+
+    /// \brief Checks that every call site holds the id patch_syscall_sites() would write.
+    inline bool verify_syscall_sites() noexcept;
+#endif
+
+    /// \brief Patches every call site with ids from the given ntdll image.
+    inline bool patch_syscall_sites(const void* image, std::size_t size, image_layout layout);
+
+    namespace detail {
+
+#if !defined(__ELF__)
+        // the linker orders grouped sections by the part after $, so these surround the
+        // records in _syspt$m. Any padding between them is skipped as it has no hash.
+        [[gnu::section("_syspt$a")]] inline const patch_site patch_sites_begin{};
+        [[gnu::section("_syspt$z")]] inline const patch_site patch_sites_end{};
+
+        inline const patch_site* first_patch_site() noexcept { return &patch_sites_begin + 1; }
+        inline const patch_site* last_patch_site() noexcept { return &patch_sites_end; }
+#else
+        // defined by the linker around the _syspt section of the binary. Weak because the
+        // section doesn't exist if there are no call sites.
+        extern "C" [[gnu::weak, gnu::visibility("hidden")]] const patch_site __start__syspt[];
+        extern "C" [[gnu::weak, gnu::visibility("hidden")]] const patch_site __stop__syspt[];
+
+        inline const patch_site* first_patch_site() noexcept { return __start__syspt; }
+        inline const patch_site* last_patch_site() noexcept { return __stop__syspt; }
+#endif
+
+        constexpr std::uintptr_t patch_page_size = 0x1000;
+
+#if defined(__linux__)
+        inline bool linux_syscall_id(std::uint32_t hash, std::uint32_t& id) noexcept
+        {
+            if(!is_linux_syscall(hash))
+                return false;
+
+            id = linux_syscall_number(hash);
+            return true;
+        }
+
+        // makes the text pages writable, or executable again once restore is set.
+        template<class Resolver>
+        inline bool protect_patch_pages(void*          address,
+                                        std::size_t    size,
+                                        bool           restore,
+                                        std::uint32_t& /* old_protection */,
+                                        Resolver& /* resolve */) noexcept
+        {
+            constexpr int prot_read = 1, prot_write = 2, prot_exec = 4;
+
+            const int protection = prot_read | prot_exec | (restore ? 0 : prot_write);
+            return syscall_function<long(void*, std::size_t, int)>{ __NR_mprotect }(
+                       address, size, protection) == 0;
+        }
+#else
+        // makes the text pages writable, or restores their old protection.
+        // The id of NtProtectVirtualMemory comes from the same place as the patched ones.
+        template<class Resolver>
+        inline bool protect_patch_pages(void*          address,
+                                        std::size_t    size,
+                                        bool           restore,
+                                        std::uint32_t& old_protection,
+                                        Resolver&      resolve) noexcept
+        {
+            constexpr std::uint32_t page_execute_readwrite = 0x40;
+
+            std::uint32_t id;
+            if(!resolve(jm::hash("NtProtectVirtualMemory"), id))
+                return false;
+
+            std::uint32_t previous;
+            const auto    status =
+                syscall_function<std::int32_t(void*, void**, std::size_t*, std::uint32_t,
+                                              std::uint32_t*)>{ id }(
+                    reinterpret_cast<void*>(-1),
+                    &address,
+                    &size,
+                    restore ? old_protection : page_execute_readwrite,
+                    &previous);
+            if(status < 0)
+                return false;
+
+            if(!restore)
+                old_protection = previous;
+            return true;
+        }
+#endif
+
+    } // namespace detail
+
+    /// \brief Writes the resolved id into the immediate of every call site. The text is
+    ///        made writable once for all of them and then restored.
+    /// \param resolve Called as resolve(hash, id) for every call site. Returns false if
+    ///                the id of syscall with the given name hash is unknown.
+    /// \returns false if any call site was left unpatched.
+    /// \warning Has to be called before other threads can reach any of the call sites.
+    template<class Resolver>
+    inline bool patch_syscall_sites(Resolver resolve) noexcept
+    {
+        const auto first = detail::first_patch_site();
+        const auto last  = detail::last_patch_site();
+
+        auto begin = ~std::uintptr_t{ 0 };
+        auto end   = std::uintptr_t{ 0 };
+        for(auto site = first; site < last; ++site) {
+            if(site->hash == 0)
+                continue;
+
+            const auto immediate = reinterpret_cast<std::uintptr_t>(site->immediate());
+            if(immediate < begin)
+                begin = immediate;
+            if(immediate + sizeof(std::uint32_t) > end)
+                end = immediate + sizeof(std::uint32_t);
+        }
+        if(begin >= end)
+            return true;
+
+        begin &= ~(detail::patch_page_size - 1);
+        end = (end + detail::patch_page_size - 1) & ~(detail::patch_page_size - 1);
+
+        const auto    pages = reinterpret_cast<void*>(begin);
+        std::uint32_t old_protection;
+        if(!detail::protect_patch_pages(pages, end - begin, false, old_protection, resolve))
+            return false;
+
+        bool patched = true;
+        for(auto site = first; site < last; ++site) {
+            std::uint32_t id;
+            if(site->hash == 0)
+                continue;
+            else if(resolve(site->hash, id))
+                *site->immediate() = id;
+            else
+                patched = false;
+        }
+
+        // the call sites read their immediates again after this
+        ++detail::patch_generation;
+
+        return detail::protect_patch_pages(pages, end - begin, true, old_protection, resolve) &&
+               patched;
+    }
+
+    /// \brief Checks that every call site holds the id that resolve returns for it.
+    /// \returns false if any call site is unpatched or holds another id.
+    template<class Resolver>
+    inline bool verify_syscall_sites(Resolver resolve) noexcept
+    {
+        for(auto site = detail::first_patch_site(); site < detail::last_patch_site(); ++site) {
+            std::uint32_t id;
+            if(site->hash != 0 && (!resolve(site->hash, id) || *site->immediate() != id))
+                return false;
+        }
+        return true;
+    }
+
+#if defined(_WIN32)
+    inline bool patch_syscall_sites() noexcept
+    {
+        const detail::exports_directory exports(
+            static_cast<const char*>(detail::ntdll_base()));
+        return patch_syscall_sites([&](std::uint32_t hash, std::uint32_t& id) {
+            return detail::find_syscall_id(exports, hash, id);
+        });
+    }
+
+    inline bool verify_syscall_sites() noexcept
+    {
+        const detail::exports_directory exports(
+            static_cast<const char*>(detail::ntdll_base()));
+        return verify_syscall_sites([&](std::uint32_t hash, std::uint32_t& id) {
+            return detail::find_syscall_id(exports, hash, id);
+        });
+    }
+#elif defined(__linux__)
+    inline bool patch_syscall_sites() noexcept
+    {
+        return patch_syscall_sites(detail::linux_syscall_id);
+    }
+
+    inline bool verify_syscall_sites() noexcept
+    {
+        return verify_syscall_sites(detail::linux_syscall_id);
+    }
+#endif
+
+    /// \returns false if the image is not a valid PE32+ image with an export directory or
+    ///          any call site was left unpatched.
+    inline bool patch_syscall_sites(const void* image, std::size_t size, image_layout layout)
+    {
+        const detail::exports_directory exports(
+            static_cast<const char*>(image), size, layout);
+        if(exports.size() == 0)
+            return false;
+
+        return patch_syscall_sites([&](std::uint32_t hash, std::uint32_t& id) {
+            return detail::find_syscall_id(exports, hash, id);
+        });
+    }
+
+} // namespace jm
+
+#endif // JM_INLINE_SYSCALL_PATCH_INIT_HPP
@@ -0,0 +1,383 @@
+/*
+ * Copyright 2018-2020 Justas Masiulis
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef JM_INLINE_SYSCALL_RSEQ_HPP
+#define JM_INLINE_SYSCALL_RSEQ_HPP
+
+#include "inline_syscall.hpp"
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <linux/rseq.h>
+#include <memory>
+#include <sys/sysinfo.h>
+
+#if !defined(__linux__) || !defined(__x86_64__)
+#error "rseq.hpp is only available on x86-64 linux"
+#endif
+
+// glibc 2.35 and newer register rseq for every thread and tell where the area is
+#if __has_include(<sys/rseq.h>)
+#include <sys/rseq.h>
+#define JM_INLINE_SYSCALL_GLIBC_RSEQ
+#endif
+
+// the signature in front of every abort handler. It is the one glibc registers with, so
+// the critical sections work with either area.
+#define JM_INLINE_SYSCALL_RSEQ_SIG 0x53053053
+
+// the struct rseq_cs that describes a critical section from start up to post_commit
+#define JM_INLINE_SYSCALL_RSEQ_CS(label, start, post_commit, abort) \
+    ".pushsection __rseq_cs, \"aw\"\n"                              \
+    ".balign 32\n" #label ":\n"                                     \
+    ".long 0, 0\n"                                                  \
+    ".quad " #start ", " #post_commit " - " #start ", " #abort "\n" \
+    ".popsection\n"
+
+// points rseq_cs of the area at the descriptor and checks that the thread is still on cpu
+#define JM_INLINE_SYSCALL_RSEQ_ENTER(descriptor, start, abort) \
+    "leaq " #descriptor "(%%rip), %%rax\n"                     \
+    "movq %%rax, 8(%[area])\n" #start ":\n"                    \
+    "cmpl %[cpu], 4(%[area])\n"                                \
+    "jnz " #abort "\n"
+
+// the abort handler, out of line. The kernel checks that the 4 bytes in front of it are
+// JM_INLINE_SYSCALL_RSEQ_SIG, which is encoded as the operand of ud1 so that
+// disassemblers stay in sync.
+#define JM_INLINE_SYSCALL_RSEQ_ABORT(label, c_label) \
+    ".pushsection __rseq_failure, \"ax\"\n"          \
+    ".byte 0x0f, 0xb9, 0x3d\n"                       \
+    ".long 0x53053053\n" #label ":\n"                \
+    "jmp %l[" #c_label "]\n"                         \
+    ".popsection\n"
+
+namespace jm {
+
+    /// \brief Registers the rseq area of the calling thread. If glibc already registered
+    ///        one, it is used instead. Other functions here call it on first use.
+    /// \returns 0 or -errno, -ENOSYS before linux 4.18.
+    inline int rseq_register() noexcept;
+
+    /// \brief Unregisters the area of the calling thread if rseq_register registered it.
+    /// \note The area is a thread_local. If this header is used by a dlopen'ed library
+    ///       that area is freed before the thread is gone, so call this before it exits.
+    inline int rseq_unregister() noexcept;
+
+    /// \brief Returns the cpu the calling thread is running on, read from its rseq area
+    ///        without a syscall, or -1 if rseq is unavailable.
+    inline int current_cpu() noexcept;
+
+    namespace detail {
+
+        using rseq = long(struct ::rseq* area,
+                          std::uint32_t  size,
+                          int            flags,
+                          std::uint32_t  signature);
+
+        // the area of this thread, either our own or the one glibc registered
+        inline thread_local struct ::rseq* rseq_thread_area = nullptr;
+        inline thread_local struct ::rseq  rseq_own_area    = {};
+
+        JM_INLINE_SYSCALL_FORCEINLINE long rseq_syscall(struct ::rseq* area,
+                                                        int            flags) noexcept
+        {
+            // the size of the original struct rseq, which every kernel accepts
+            return INLINE_SYSCALL_T(rseq)(area, 32, flags, JM_INLINE_SYSCALL_RSEQ_SIG);
+        }
+
+        // returns the area of this thread or nullptr if rseq is unavailable
+        JM_INLINE_SYSCALL_FORCEINLINE struct ::rseq* rseq_area() noexcept
+        {
+            if(__builtin_expect(!rseq_thread_area, 0))
+                rseq_register();
+            return rseq_thread_area;
+        }
+
+        JM_INLINE_SYSCALL_FORCEINLINE std::uint32_t rseq_cpu(struct ::rseq* area) noexcept
+        {
+            return __atomic_load_n(&area->cpu_id_start, __ATOMIC_RELAXED);
+        }
+
+        inline unsigned possible_cpus() noexcept
+        {
+            const auto cpus = ::get_nprocs_conf();
+            return cpus > 0 ? static_cast<unsigned>(cpus) : 1;
+        }
+
+        // The critical sections. Each one commits with its last instruction and returns
+        // false if it was aborted, because the thread was preempted, migrated or got a
+        // signal, or because it isn't running on cpu any more. Callers retry.
+
+        // *value += count
+        JM_INLINE_SYSCALL_FORCEINLINE bool rseq_add(struct ::rseq* area,
+                                                    std::intptr_t* value,
+                                                    std::intptr_t  count,
+                                                    std::uint32_t  cpu) noexcept
+        {
+            asm goto(JM_INLINE_SYSCALL_RSEQ_CS(3, 1f, 2f, 4f)
+                     JM_INLINE_SYSCALL_RSEQ_ENTER(3b, 1, 4f)
+                     "addq %[count], %[value]\n"
+                     "2:\n"
+                     JM_INLINE_SYSCALL_RSEQ_ABORT(4, abort)
+                     :
+                     : [area] "r"(area), [cpu] "r"(cpu), [value] "m"(*value),
+                       [count] "er"(count)
+                     : "memory", "cc", "rax"
+                     : abort);
+            return true;
+        abort:
+            return false;
+        }
+
+        // *value = desired if *value == expected. *mismatch is set if it wasn't.
+        JM_INLINE_SYSCALL_FORCEINLINE bool rseq_compare_store(struct ::rseq* area,
+                                                              std::intptr_t* value,
+                                                              std::intptr_t  expected,
+                                                              std::intptr_t  desired,
+                                                              std::uint32_t  cpu,
+                                                              bool* mismatch) noexcept
+        {
+            asm goto(JM_INLINE_SYSCALL_RSEQ_CS(3, 1f, 2f, 4f)
+                     JM_INLINE_SYSCALL_RSEQ_ENTER(3b, 1, 4f)
+                     "cmpq %[value], %[expected]\n"
+                     "jnz %l[differs]\n"
+                     "movq %[desired], %[value]\n"
+                     "2:\n"
+                     JM_INLINE_SYSCALL_RSEQ_ABORT(4, abort)
+                     :
+                     : [area] "r"(area), [cpu] "r"(cpu), [value] "m"(*value),
+                       [expected] "r"(expected), [desired] "r"(desired)
+                     : "memory", "cc", "rax"
+                     : abort, differs);
+            *mismatch = false;
+            return true;
+        differs:
+            *mismatch = true;
+            return true;
+        abort:
+            return false;
+        }
+
+        // *popped = *head and *head = **head if *head isn't null. The next pointer is the
+        // first member of the node.
+        JM_INLINE_SYSCALL_FORCEINLINE bool rseq_pop(struct ::rseq* area,
+                                                    std::intptr_t* head,
+                                                    std::intptr_t* popped,
+                                                    std::uint32_t  cpu) noexcept
+        {
+            asm goto(JM_INLINE_SYSCALL_RSEQ_CS(3, 1f, 2f, 4f)
+                     JM_INLINE_SYSCALL_RSEQ_ENTER(3b, 1, 4f)
+                     "movq %[head], %%rax\n"
+                     "movq %%rax, %[popped]\n"
+                     "testq %%rax, %%rax\n"
+                     "jz 2f\n"
+                     "movq (%%rax), %%rax\n"
+                     "movq %%rax, %[head]\n"
+                     "2:\n"
+                     JM_INLINE_SYSCALL_RSEQ_ABORT(4, abort)
+                     :
+                     : [area] "r"(area), [cpu] "r"(cpu), [head] "m"(*head),
+                       [popped] "m"(*popped)
+                     : "memory", "cc", "rax"
+                     : abort);
+            return true;
+        abort:
+            return false;
+        }
+
+    } // namespace detail
+
+    /// \brief A counter with a cache line per cpu. Adding to it is a single rseq critical
+    ///        section on the slot of the current cpu, so no cache line is shared between
+    ///        cpus and no lock prefix is needed. Reading it sums all the slots.
+    class percpu_counter {
+        struct alignas(64) slot {
+            std::intptr_t value = 0;
+        };
+
+        std::unique_ptr<slot[]> _slots;
+        unsigned                _cpus;
+        // for threads without rseq or on cpus that came online later
+        slot _overflow;
+
+    public:
+        /// \param cpus The number of slots, by default all the cpus that may come online.
+        explicit percpu_counter(unsigned cpus = detail::possible_cpus())
+            : _slots(new slot[cpus ? cpus : 1]), _cpus(cpus ? cpus : 1)
+        {}
+
+        void add(std::intptr_t count) noexcept
+        {
+            if(const auto area = detail::rseq_area()) {
+                for(;;) {
+                    const auto cpu = detail::rseq_cpu(area);
+                    if(cpu >= _cpus)
+                        break;
+                    if(detail::rseq_add(area, &_slots[cpu].value, count, cpu))
+                        return;
+                }
+            }
+            __atomic_fetch_add(&_overflow.value, count, __ATOMIC_RELAXED);
+        }
+
+        /// \brief Returns the sum of all slots. Additions that happen at the same time may
+        ///        or may not be included.
+        std::intptr_t load() const noexcept
+        {
+            auto sum = __atomic_load_n(&_overflow.value, __ATOMIC_RELAXED);
+            for(unsigned cpu = 0; cpu < _cpus; ++cpu)
+                sum += __atomic_load_n(&_slots[cpu].value, __ATOMIC_RELAXED);
+            return sum;
+        }
+    };
+
+    /// \brief The intrusive node of percpu_freelist. Derive from it or put it first.
+    struct percpu_node {
+        percpu_node* next;
+    };
+
+    /// \brief A list of free nodes per cpu, meant as the cache in front of an object pool.
+    ///        A node is pushed to and popped from the list of the current cpu, so there is
+    ///        no ABA problem and no lock prefix.
+    /// \note Does nothing without rseq: push returns false and pop nullptr, and the
+    ///       caller goes to the pool behind it instead.
+    class percpu_freelist {
+        struct alignas(64) slot {
+            percpu_node* head = nullptr;
+        };
+
+        std::unique_ptr<slot[]> _slots;
+        unsigned                _cpus;
+
+        std::intptr_t* head_of(std::uint32_t cpu) noexcept
+        {
+            return reinterpret_cast<std::intptr_t*>(&_slots[cpu].head);
+        }
+
+    public:
+        /// \param cpus The number of lists, by default all the cpus that may come online.
+        explicit percpu_freelist(unsigned cpus = detail::possible_cpus())
+            : _slots(new slot[cpus ? cpus : 1]), _cpus(cpus ? cpus : 1)
+        {}
+
+        /// \brief Pushes node to the list of the current cpu.
+        /// \returns false if it wasn't pushed because rseq is unavailable.
+        bool push(percpu_node* node) noexcept
+        {
+            const auto area = detail::rseq_area();
+            if(!area)
+                return false;
+
+            for(;;) {
+                const auto cpu = detail::rseq_cpu(area);
+                if(cpu >= _cpus)
+                    return false;
+
+                const auto head = __atomic_load_n(&_slots[cpu].head, __ATOMIC_RELAXED);
+                node->next      = head;
+                bool mismatch;
+                if(detail::rseq_compare_store(area,
+                                              head_of(cpu),
+                                              reinterpret_cast<std::intptr_t>(head),
+                                              reinterpret_cast<std::intptr_t>(node),
+                                              cpu,
+                                              &mismatch) &&
+                   !mismatch)
+                    return true;
+            }
+        }
+
+        /// \brief Pops a node from the list of the current cpu.
+        /// \returns nullptr if that list is empty or rseq is unavailable.
+        percpu_node* pop() noexcept
+        {
+            const auto area = detail::rseq_area();
+            if(!area)
+                return nullptr;
+
+            for(;;) {
+                const auto cpu = detail::rseq_cpu(area);
+                if(cpu >= _cpus)
+                    return nullptr;
+
+                std::intptr_t node;
+                if(detail::rseq_pop(area, head_of(cpu), &node, cpu))
+                    return reinterpret_cast<percpu_node*>(node);
+            }
+        }
+
+        /// \brief Takes the whole list of the given cpu, e.g. to give the nodes back to
+        ///        the pool. Only safe once no thread uses the freelist any more.
+        percpu_node* drain(unsigned cpu) noexcept
+        {
+            if(cpu >= _cpus)
+                return nullptr;
+            return __atomic_exchange_n(&_slots[cpu].head, nullptr, __ATOMIC_RELAXED);
+        }
+
+        unsigned cpus() const noexcept { return _cpus; }
+    };
+
+    inline int rseq_register() noexcept
+    {
+        if(detail::rseq_thread_area)
+            return 0;
+
+#if defined(JM_INLINE_SYSCALL_GLIBC_RSEQ)
+        if(__rseq_size != 0) {
+            detail::rseq_thread_area = reinterpret_cast<struct ::rseq*>(
+                static_cast<char*>(__builtin_thread_pointer()) + __rseq_offset);
+            return 0;
+        }
+#endif
+
+        auto& area  = detail::rseq_own_area;
+        area.cpu_id = static_cast<std::uint32_t>(RSEQ_CPU_ID_UNINITIALIZED);
+        if(const auto result = detail::rseq_syscall(&area, 0))
+            return static_cast<int>(result);
+
+        detail::rseq_thread_area = &area;
+        return 0;
+    }
+
+    inline int rseq_unregister() noexcept
+    {
+        if(detail::rseq_thread_area != &detail::rseq_own_area)
+            return 0;
+
+        if(const auto result = detail::rseq_syscall(&detail::rseq_own_area,
+                                                    RSEQ_FLAG_UNREGISTER))
+            return static_cast<int>(result);
+
+        detail::rseq_thread_area = nullptr;
+        return 0;
+    }
+
+    inline int current_cpu() noexcept
+    {
+        const auto area = detail::rseq_area();
+        if(!area)
+            return -1;
+        return static_cast<int>(__atomic_load_n(&area->cpu_id, __ATOMIC_RELAXED));
+    }
+
+} // namespace jm
+
+#undef JM_INLINE_SYSCALL_RSEQ_CS
+#undef JM_INLINE_SYSCALL_RSEQ_ENTER
+#undef JM_INLINE_SYSCALL_RSEQ_ABORT
+
+#endif // include guard
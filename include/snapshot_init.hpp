@@ -0,0 +1,198 @@
+/*
+ * Copyright 2018-2020 Justas Masiulis
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef JM_INLINE_SYSCALL_SNAPSHOT_INIT_HPP
+#define JM_INLINE_SYSCALL_SNAPSHOT_INIT_HPP
+
+#include "file_init.hpp"
+#include <cassert>
+#include <cstdio>
+
+namespace jm {
+
+#if defined(_WIN32)
+    /// \brief Initializes syscalls list from a snapshot or ntdll.dll loaded in current
+    ///        process.
+    inline void init_syscalls_list_cached(const char* snapshot_path);
+#endif
+
+    /// \brief Initializes syscalls list from a snapshot or the given ntdll image.
+    inline bool init_syscalls_list_cached(const char*  snapshot_path,
+                                          const void*  image,
+                                          std::size_t  size,
+                                          image_layout layout);
+
+    namespace detail {
+
+        /* snapshot file layout:
+         *
+         * snapshot_header
+         * std::uint32_t ids[header.count] - of every slot in syscall_entries(), padding included
+         */
+        struct snapshot_header {
+            std::uint32_t magic;
+            std::uint32_t version;
+
+            // identity of the ntdll image the ids were taken from
+            std::uint32_t time_date_stamp;
+            std::uint32_t check_sum;
+            std::uint32_t size_of_image;
+
+            // identity of the syscall entry table of the binary that wrote the snapshot
+            std::uint32_t entries_hash;
+            std::uint32_t count; // including the padding
+        };
+
+        constexpr std::uint32_t snapshot_magic   = 0x4353594A; // "JYSC"
+        constexpr std::uint32_t snapshot_version = 2;
+
+        // fills in the parts of the header that identify ntdll and syscall entry table.
+        // Needs to be called before the entries are resolved as small entries lose their
+        // hashes afterwards.
+        inline snapshot_header make_snapshot_header(const IMAGE_NT_HEADERS& nt) noexcept
+        {
+            snapshot_header header{};
+            header.magic           = snapshot_magic;
+            header.version         = snapshot_version;
+            header.time_date_stamp = nt.FileHeader.TimeDateStamp;
+            header.check_sum       = nt.OptionalHeader.CheckSum;
+            header.size_of_image   = nt.OptionalHeader.SizeOfImage;
+            header.entries_hash    = 2166136261;
+            header.count           = static_cast<std::uint32_t>(
+                jm::syscall_entries_end() - jm::syscall_entries());
+            for(auto entry = jm::syscall_entries(); entry != jm::syscall_entries_end(); ++entry)
+                if(entry_hash(entry) != 0)
+                    header.entries_hash = static_cast<std::uint32_t>(
+                        (header.entries_hash ^ entry_hash(entry)) * 16777619ull);
+
+            return header;
+        }
+
+        // applies the snapshot if it matches the header. Returns false otherwise.
+        inline bool apply_snapshot(const char* path, const snapshot_header& header) noexcept
+        {
+            const mapped_file file(path);
+            if(!file.data() ||
+               file.size() != sizeof(snapshot_header) + header.count * sizeof(std::uint32_t))
+                return false;
+
+            const auto* const stored = reinterpret_cast<const unsigned char*>(file.data());
+            const auto* const expected = reinterpret_cast<const unsigned char*>(&header);
+            for(std::size_t i = 0; i < sizeof(snapshot_header); ++i)
+                if(stored[i] != expected[i])
+                    return false;
+
+            const auto* ids =
+                reinterpret_cast<const std::uint32_t*>(file.data() + sizeof(snapshot_header));
+            for(auto entry = jm::syscall_entries(); entry != jm::syscall_entries_end(); ++entry)
+                entry->id = *ids++;
+
+            return true;
+        }
+
+        // writes the resolved entries next to the snapshot and then moves it into place so
+        // that concurrently starting processes never observe a partially written snapshot.
+        inline void write_snapshot(const char* path, const snapshot_header& header) noexcept
+        {
+            char temp_path[4096];
+#if defined(_WIN32)
+            const auto pid = static_cast<unsigned long>(GetCurrentProcessId());
+#else
+            const auto pid = static_cast<unsigned long>(::getpid());
+#endif
+            const auto length =
+                std::snprintf(temp_path, sizeof(temp_path), "%s.%lu.tmp", path, pid);
+            if(length < 0 || static_cast<std::size_t>(length) >= sizeof(temp_path))
+                return;
+
+            const auto file = std::fopen(temp_path, "wb");
+            if(!file)
+                return;
+
+            bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1;
+            for(auto entry = jm::syscall_entries(); ok && entry != jm::syscall_entries_end();
+                ++entry) {
+                const std::uint32_t id = entry->id;
+                ok = std::fwrite(&id, sizeof(id), 1, file) == 1;
+            }
+
+            if(std::fclose(file) != 0 || !ok) {
+                std::remove(temp_path);
+                return;
+            }
+
+#if defined(_WIN32)
+            if(!MoveFileExA(temp_path, path, MOVEFILE_REPLACE_EXISTING))
+                std::remove(temp_path);
+#else
+            if(std::rename(temp_path, path) != 0)
+                std::remove(temp_path);
+#endif
+        }
+
+        inline void init_syscalls_list_cached(const char*              snapshot_path,
+                                              const exports_directory& exports) noexcept
+        {
+            const auto header = make_snapshot_header(*exports.headers());
+            if(apply_snapshot(snapshot_path, header))
+                return;
+
+            resolve_syscall_entries(exports);
+            write_snapshot(snapshot_path, header);
+        }
+
+    } // namespace detail
+
+#if defined(_WIN32)
+    /// \brief Initializes syscall ids from a snapshot file that is keyed by the identity
+    ///        of ntdll.dll loaded in current process. If the snapshot is missing or stale
+    ///        the ids are resolved from the exports of ntdll and a new snapshot is saved.
+    /// \warning THIS DOES NOT INITIALIZE SYSCALLS FROM USER32.DLL / NtUser*
+    inline void init_syscalls_list_cached(const char* snapshot_path)
+    {
+        assert(detail::syscall_entries_in_section() &&
+               "the compiler didn't place the syscall entries in their section");
+        detail::init_syscalls_list_cached(
+            snapshot_path,
+            detail::exports_directory(static_cast<const char*>(detail::ntdll_base())));
+    }
+#endif
+
+    /// \brief Initializes syscall ids from a snapshot file that is keyed by the identity
+    ///        of the given ntdll image. If the snapshot is missing or stale the ids are
+    ///        resolved from the exports of the image and a new snapshot is saved.
+    /// \returns false if the image is not a valid PE32+ image with an export directory or
+    ///          the compiler didn't place the syscall entries in their section.
+    inline bool init_syscalls_list_cached(const char*  snapshot_path,
+                                          const void*  image,
+                                          std::size_t  size,
+                                          image_layout layout)
+    {
+        if(!detail::syscall_entries_in_section())
+            return false;
+
+        const detail::exports_directory exports(
+            static_cast<const char*>(image), size, layout);
+        if(exports.size() == 0)
+            return false;
+
+        detail::init_syscalls_list_cached(snapshot_path, exports);
+        return true;
+    }
+
+} // namespace jm
+
+#endif // JM_INLINE_SYSCALL_SNAPSHOT_INIT_HPP
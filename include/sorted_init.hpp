@@ -0,0 +1,195 @@
+/*
+ * Copyright 2018-2020 Justas Masiulis
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef JM_INLINE_SYSCALL_SORTED_INIT_HPP
+#define JM_INLINE_SYSCALL_SORTED_INIT_HPP
+
+#include "in_memory_init.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+
+namespace jm {
+
+#if defined(_WIN32)
+    /// \brief Initializes syscalls list from the order of the Zw* stubs of ntdll.dll
+    ///        loaded in current process.
+    inline bool init_syscalls_list_sorted();
+#endif
+
+    /// \brief Initializes syscalls list from the order of the Zw* stubs of the given
+    ///        ntdll image.
+    inline bool init_syscalls_list_sorted(const void*  image,
+                                          std::size_t  size,
+                                          image_layout layout);
+
+    namespace detail {
+
+        // a Zw* export or a syscall entry, keyed by the hash of syscall name
+        struct sorted_syscall {
+            std::uint32_t hash;
+            std::uint32_t value; // the id of export or the index of entry
+        };
+
+        struct zw_stub {
+            const char*   address;
+            std::uint32_t hash;
+        };
+
+        // resolves the syscall entries in [first, last) by the rank of the addresses of
+        // the Zw* stubs of the given module, without reading the stubs themselves.
+        // Calls unresolved(hash) for every entry that has no Zw* export.
+        // Returns false if any entry was left unresolved.
+        template<class Entry, class Unresolved>
+        inline bool resolve_syscall_entries_sorted(const exports_directory& exports,
+                                                   Entry*                   first,
+                                                   Entry*                   last,
+                                                   Unresolved&              unresolved)
+        {
+            const auto export_first = lower_bound(exports, "Zw");
+            const auto export_last  = std::max(lower_bound(exports, "Zx"), export_first);
+            const auto count        = static_cast<std::size_t>(last - first);
+
+            const std::unique_ptr<zw_stub[]> stubs(
+                new(std::nothrow) zw_stub[export_last - export_first]);
+            const std::unique_ptr<sorted_syscall[]> exported(
+                new(std::nothrow) sorted_syscall[export_last - export_first]);
+            const std::unique_ptr<sorted_syscall[]> entries(
+                new(std::nothrow) sorted_syscall[count]);
+            if(!stubs || !exported || !entries)
+                return false;
+
+            std::size_t stub_count = 0;
+            for(auto i = export_first; i < export_last; ++i) {
+                const auto name    = exports.name(i);
+                const auto address = exports.address(i);
+                if(name && address)
+                    stubs[stub_count++] = { address, jm::hash(name) };
+            }
+
+            // the stubs are laid out in the order of their ids. Aliases share a stub and
+            // its id.
+            std::sort(stubs.get(),
+                      stubs.get() + stub_count,
+                      [](const zw_stub& lhs, const zw_stub& rhs) {
+                          return lhs.address < rhs.address;
+                      });
+            std::uint32_t id = 0;
+            for(std::size_t i = 0; i < stub_count; ++i) {
+                if(i != 0 && stubs[i].address != stubs[i - 1].address)
+                    ++id;
+                exported[i] = { stubs[i].hash, id };
+            }
+
+            // the hashes are copied as small entries lose them once resolved
+            std::size_t entry_count = 0;
+            for(std::size_t i = 0; i < count; ++i)
+                if(const auto hash = entry_hash(first + i))
+                    entries[entry_count++] = { hash, static_cast<std::uint32_t>(i) };
+
+            const auto by_hash = [](const sorted_syscall& lhs, const sorted_syscall& rhs) {
+                return lhs.hash < rhs.hash;
+            };
+            std::sort(exported.get(), exported.get() + stub_count, by_hash);
+            std::sort(entries.get(), entries.get() + entry_count, by_hash);
+
+            bool        resolved = true;
+            std::size_t e        = 0;
+            for(std::size_t i = 0; i < entry_count; ++i) {
+                while(e < stub_count && exported[e].hash < entries[i].hash)
+                    ++e;
+
+                if(e < stub_count && exported[e].hash == entries[i].hash)
+                    first[entries[i].value].id = exported[e].value;
+                else {
+                    unresolved(entries[i].hash);
+                    resolved = false;
+                }
+            }
+            return resolved;
+        }
+
+        struct ignore_unresolved {
+            void operator()(std::uint32_t) const noexcept {}
+        };
+
+    } // namespace detail
+
+    /// \brief Initializes syscall ids by the rank of the address of every Zw* stub of
+    ///        the given ntdll image instead of reading the ids out of the stubs, so stubs
+    ///        that are hooked or otherwise patched don't matter.
+    /// \param unresolved Called as unresolved(hash) for every syscall entry whose
+    ///                   syscall isn't exported by the image.
+    /// \returns false if the image is not a valid PE32+ image with an export directory,
+    ///          the compiler didn't place the syscall entries in their section or any
+    ///          syscall entry was left unresolved.
+    /// \note Relies on the stubs of x64 ntdll being laid out in the order of their ids
+    ///       and every Zw* export being a syscall stub.
+    template<class Unresolved>
+    inline bool init_syscalls_list_sorted(const void*  image,
+                                          std::size_t  size,
+                                          image_layout layout,
+                                          Unresolved   unresolved)
+    {
+        if(!detail::syscall_entries_in_section())
+            return false;
+
+        const detail::exports_directory exports(
+            static_cast<const char*>(image), size, layout);
+        if(exports.size() == 0)
+            return false;
+
+        return detail::resolve_syscall_entries_sorted(
+            exports, jm::syscall_entries(), jm::syscall_entries_end(), unresolved);
+    }
+
+    inline bool init_syscalls_list_sorted(const void*  image,
+                                          std::size_t  size,
+                                          image_layout layout)
+    {
+        return init_syscalls_list_sorted(image, size, layout, detail::ignore_unresolved{});
+    }
+
+#if defined(_WIN32)
+    /// \brief Initializes syscall ids by the rank of the address of every Zw* stub of
+    ///        ntdll.dll loaded in current process, so stubs that are hooked don't matter.
+    /// \param unresolved Called as unresolved(hash) for every syscall entry whose
+    ///                   syscall isn't exported by ntdll.
+    /// \returns false if the compiler didn't place the syscall entries in their section or
+    ///          any syscall entry was left unresolved.
+    /// \warning THIS DOES NOT INITIALIZE SYSCALLS FROM USER32.DLL / NtUser*
+    template<class Unresolved>
+    inline bool init_syscalls_list_sorted(Unresolved unresolved)
+    {
+        if(!detail::syscall_entries_in_section())
+            return false;
+
+        const detail::exports_directory exports(
+            static_cast<const char*>(detail::ntdll_base()));
+        return detail::resolve_syscall_entries_sorted(
+            exports, jm::syscall_entries(), jm::syscall_entries_end(), unresolved);
+    }
+
+    inline bool init_syscalls_list_sorted()
+    {
+        return init_syscalls_list_sorted(detail::ignore_unresolved{});
+    }
+#endif
+
+} // namespace jm
+
+#endif // JM_INLINE_SYSCALL_SORTED_INIT_HPP
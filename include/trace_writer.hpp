@@ -0,0 +1,171 @@
+/*
+ * Copyright 2018-2020 Justas Masiulis
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef JM_INLINE_SYSCALL_TRACE_WRITER_HPP
+#define JM_INLINE_SYSCALL_TRACE_WRITER_HPP
+
+#include "inline_syscall.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+
+#if !defined(JM_INLINE_SYSCALL_TRACE)
+#error "trace_writer.hpp needs JM_INLINE_SYSCALL_TRACE to be defined"
+#endif
+
+namespace jm {
+
+    namespace detail {
+
+        /* trace file layout:
+         *
+         * trace_file_header
+         * any number of blocks of:
+         *     trace_block_header
+         *     syscall_trace_record records[block.count]
+         */
+        struct trace_file_header {
+            std::uint32_t magic;
+            std::uint32_t version;
+            std::uint32_t record_size;
+            std::uint32_t args;
+        };
+
+        struct trace_block_header {
+            // syscall_trace_ring::thread of the ring the records were taken from
+            std::uint32_t thread;
+            std::uint32_t count;
+
+            // the number of records of the thread that were overwritten before this block
+            std::uint64_t lost;
+        };
+
+        constexpr std::uint32_t trace_file_magic   = 0x5254594A; // "JYTR"
+        constexpr std::uint32_t trace_file_version = 1;
+
+    } // namespace detail
+
+    /// \brief Periodically moves the records from the trace rings of all threads into a
+    ///        binary file that can be turned into a timeline by tools/trace_timeline.py.
+    ///        The traced threads never wait for it. If it can't keep up the oldest records
+    ///        are overwritten and counted as lost.
+    class syscall_trace_writer {
+        std::FILE*                _file = nullptr;
+        std::chrono::milliseconds _interval;
+        std::mutex                _mutex;
+        std::condition_variable   _wake;
+        bool                      _stop = false;
+        std::thread               _thread;
+
+        // serializes drains of the background thread and explicit drain() calls, as only
+        // one thread can read a ring at a time.
+        std::mutex _drain_mutex;
+
+        void run()
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            while(!_stop) {
+                _wake.wait_for(lock, _interval);
+                lock.unlock();
+                drain();
+                lock.lock();
+            }
+        }
+
+    public:
+        /// \brief Creates the file and starts the background thread.
+        /// \param interval How often the rings are drained.
+        explicit syscall_trace_writer(
+            const char*               path,
+            std::chrono::milliseconds interval = std::chrono::milliseconds(100))
+            : _file(std::fopen(path, "wb")), _interval(interval)
+        {
+            if(!_file)
+                return;
+
+            const detail::trace_file_header header{ detail::trace_file_magic,
+                                                    detail::trace_file_version,
+                                                    sizeof(syscall_trace_record),
+                                                    JM_INLINE_SYSCALL_TRACE_ARGS };
+            if(std::fwrite(&header, sizeof(header), 1, _file) != 1) {
+                std::fclose(_file);
+                _file = nullptr;
+                return;
+            }
+
+            _thread = std::thread([this] { run(); });
+        }
+
+        syscall_trace_writer(const syscall_trace_writer&) = delete;
+        syscall_trace_writer& operator=(const syscall_trace_writer&) = delete;
+
+        /// \brief Stops the background thread, drains the rings one last time and closes
+        ///        the file.
+        ~syscall_trace_writer()
+        {
+            if(!_file)
+                return;
+
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _stop = true;
+            }
+            _wake.notify_one();
+            _thread.join();
+
+            drain();
+            std::fclose(_file);
+        }
+
+        /// \brief Returns false if the file could not be created.
+        bool is_open() const noexcept { return _file != nullptr; }
+
+        /// \brief Writes every record that is currently in the rings to the file.
+        void drain()
+        {
+            if(!_file)
+                return;
+
+            std::lock_guard<std::mutex> lock(_drain_mutex);
+
+            constexpr std::size_t capacity = 256;
+            syscall_trace_record  records[capacity];
+            for(auto ring = syscall_trace_rings(); ring; ring = ring->next) {
+                // reads at most one ring worth of records so that a thread that keeps
+                // producing them can't hold up the drain.
+                for(auto blocks = JM_INLINE_SYSCALL_TRACE_RING_SIZE / capacity + 1; blocks--;) {
+                    detail::trace_block_header block{};
+                    block.thread = __atomic_load_n(&ring->thread, __ATOMIC_RELAXED);
+                    block.count =
+                        static_cast<std::uint32_t>(ring->pop(records, capacity, block.lost));
+                    if(block.count == 0 && block.lost == 0)
+                        break;
+
+                    std::fwrite(&block, sizeof(block), 1, _file);
+                    std::fwrite(records, sizeof(records[0]), block.count, _file);
+                    if(block.count < capacity)
+                        break;
+                }
+            }
+            std::fflush(_file);
+        }
+    };
+
+} // namespace jm
+
+#endif // JM_INLINE_SYSCALL_TRACE_WRITER_HPP
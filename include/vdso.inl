@@ -0,0 +1,389 @@
+/*
+ * Copyright 2018-2020 Justas Masiulis
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef JM_INLINE_SYSCALL_VDSO_INL
+#define JM_INLINE_SYSCALL_VDSO_INL
+
+#include "inline_syscall.hpp"
+#include <sys/auxv.h>
+
+#if defined(__aarch64__)
+// the syscalls that are implemented by the arm64 vDSO and the signatures of
+// __kernel_<name> functions that implement them.
+#define JM_INLINE_SYSCALL_VDSO_SYMBOLS(X)          \
+    X(clock_gettime, int(int, void*))              \
+    X(gettimeofday, int(void*, void*))             \
+    X(clock_getres, int(int, void*))
+
+#define JM_INLINE_SYSCALL_VDSO_PREFIX "__kernel_"
+#define JM_INLINE_SYSCALL_VDSO_VERSION "LINUX_2.6.39"
+#else
+// the syscalls that are implemented by the x86-64 vDSO and the signatures of
+// __vdso_<name> functions that implement them.
+#define JM_INLINE_SYSCALL_VDSO_SYMBOLS(X)          \
+    X(clock_gettime, int(int, void*))              \
+    X(gettimeofday, int(void*, void*))             \
+    X(time, long(void*))                           \
+    X(getcpu, long(unsigned*, unsigned*, void*))
+
+#define JM_INLINE_SYSCALL_VDSO_PREFIX "__vdso_"
+#define JM_INLINE_SYSCALL_VDSO_VERSION "LINUX_2.6"
+#endif
+
+namespace jm {
+
+    namespace detail {
+
+        struct Elf64_Ehdr {
+            std::uint8_t  e_ident[16]; // Magic number and other info
+            std::uint16_t e_type; // Object file type
+            std::uint16_t e_machine; // Architecture
+            std::uint32_t e_version; // Object file version
+            std::uint64_t e_entry; // Entry point virtual address
+            std::uint64_t e_phoff; // Program header table file offset
+            std::uint64_t e_shoff; // Section header table file offset
+            std::uint32_t e_flags; // Processor-specific flags
+            std::uint16_t e_ehsize; // ELF header size in bytes
+            std::uint16_t e_phentsize; // Program header table entry size
+            std::uint16_t e_phnum; // Program header table entry count
+            std::uint16_t e_shentsize; // Section header table entry size
+            std::uint16_t e_shnum; // Section header table entry count
+            std::uint16_t e_shstrndx; // Section header string table index
+        };
+
+        struct Elf64_Phdr {
+            std::uint32_t p_type;
+            std::uint32_t p_flags;
+            std::uint64_t p_offset;
+            std::uint64_t p_vaddr;
+            std::uint64_t p_paddr;
+            std::uint64_t p_filesz;
+            std::uint64_t p_memsz;
+            std::uint64_t p_align;
+        };
+
+        struct Elf64_Dyn {
+            std::int64_t  d_tag;
+            std::uint64_t d_val;
+        };
+
+        struct Elf64_Sym {
+            std::uint32_t st_name;
+            std::uint8_t  st_info;
+            std::uint8_t  st_other;
+            std::uint16_t st_shndx;
+            std::uint64_t st_value;
+            std::uint64_t st_size;
+        };
+
+        struct Elf64_Verdef {
+            std::uint16_t vd_version;
+            std::uint16_t vd_flags;
+            std::uint16_t vd_ndx;
+            std::uint16_t vd_cnt;
+            std::uint32_t vd_hash;
+            std::uint32_t vd_aux; // offset of the first Elf64_Verdaux
+            std::uint32_t vd_next; // offset of the next Elf64_Verdef or 0
+        };
+
+        struct Elf64_Verdaux {
+            std::uint32_t vda_name;
+            std::uint32_t vda_next;
+        };
+
+        /// \brief The dynamic symbol table of an ELF image that is mapped by the loader
+        ///        or the kernel, like the vDSO.
+        class elf_symbols {
+            // the difference between virtual addresses in the image and where it is loaded
+            const char*          _base     = nullptr;
+            const Elf64_Sym*     _symbols  = nullptr;
+            const char*          _strings  = nullptr;
+            const std::uint16_t* _versions = nullptr;
+            const Elf64_Verdef*  _verdefs  = nullptr;
+            std::uint32_t        _count    = 0;
+
+            // the symbol table has no size of its own, so it is taken from the hash table.
+            // Every symbol is in the chain array of DT_HASH. DT_GNU_HASH only contains the
+            // symbols after symoffset, the last of which ends the longest chain.
+            static std::uint32_t gnu_hash_count(const std::uint32_t* table) noexcept
+            {
+                const auto buckets     = table[0];
+                const auto symoffset   = table[1];
+                const auto bloom_words = table[2];
+                const auto bucket      = table + 4 + bloom_words * 2;
+                const auto chain       = bucket + buckets;
+
+                std::uint32_t last = 0;
+                for(std::uint32_t i = 0; i < buckets; ++i)
+                    if(bucket[i] > last)
+                        last = bucket[i];
+
+                if(last < symoffset)
+                    return symoffset;
+
+                while(!(chain[last - symoffset] & 1))
+                    ++last;
+
+                return last + 1;
+            }
+
+        public:
+            using size_type = std::uint32_t;
+
+            /// \brief Parses the dynamic section of a mapped image.
+            /// \note If the image is malformed the symbol table is treated as empty.
+            explicit elf_symbols(const char* image) noexcept
+            {
+                const auto ehdr = reinterpret_cast<const Elf64_Ehdr*>(image);
+                if(ehdr->e_ident[0] != 0x7F || ehdr->e_ident[1] != 'E' ||
+                   ehdr->e_ident[2] != 'L' || ehdr->e_ident[3] != 'F' ||
+                   ehdr->e_ident[4] != 2 /* ELFCLASS64 */)
+                    return;
+
+                const auto       phdrs   = reinterpret_cast<const Elf64_Phdr*>(image + ehdr->e_phoff);
+                const Elf64_Dyn* dynamic = nullptr;
+                for(std::uint16_t i = 0; i < ehdr->e_phnum; ++i) {
+                    if(phdrs[i].p_type == 1 /* PT_LOAD */ && !_base)
+                        _base = image + phdrs[i].p_offset - phdrs[i].p_vaddr;
+                    else if(phdrs[i].p_type == 2 /* PT_DYNAMIC */)
+                        dynamic = reinterpret_cast<const Elf64_Dyn*>(image + phdrs[i].p_offset);
+                }
+                if(!_base || !dynamic)
+                    return;
+
+                const std::uint32_t* hash     = nullptr;
+                const std::uint32_t* gnu_hash = nullptr;
+                for(auto entry = dynamic; entry->d_tag != 0 /* DT_NULL */; ++entry) {
+                    const auto address = _base + entry->d_val;
+                    switch(entry->d_tag) {
+                    case 4: // DT_HASH
+                        hash = reinterpret_cast<const std::uint32_t*>(address);
+                        break;
+                    case 0x6FFFFEF5: // DT_GNU_HASH
+                        gnu_hash = reinterpret_cast<const std::uint32_t*>(address);
+                        break;
+                    case 5: // DT_STRTAB
+                        _strings = address;
+                        break;
+                    case 6: // DT_SYMTAB
+                        _symbols = reinterpret_cast<const Elf64_Sym*>(address);
+                        break;
+                    case 0x6FFFFFF0: // DT_VERSYM
+                        _versions = reinterpret_cast<const std::uint16_t*>(address);
+                        break;
+                    case 0x6FFFFFFC: // DT_VERDEF
+                        _verdefs = reinterpret_cast<const Elf64_Verdef*>(address);
+                        break;
+                    }
+                }
+                if(!_symbols || !_strings)
+                    return;
+
+                if(hash)
+                    _count = hash[1];
+                else if(gnu_hash)
+                    _count = gnu_hash_count(gnu_hash);
+            }
+
+            JM_INLINE_SYSCALL_FORCEINLINE size_type size() const noexcept { return _count; }
+
+            JM_INLINE_SYSCALL_FORCEINLINE const char* name(size_type index) const noexcept
+            {
+                return _strings + _symbols[index].st_name;
+            }
+
+            /// \brief Returns the address of symbol or nullptr if it is not a defined
+            ///        global function.
+            JM_INLINE_SYSCALL_FORCEINLINE const char* address(size_type index) const noexcept
+            {
+                const auto& symbol  = _symbols[index];
+                const auto  type    = symbol.st_info & 0xF;
+                const auto  binding = symbol.st_info >> 4;
+                if(symbol.st_shndx == 0 /* SHN_UNDEF */ || type != 2 /* STT_FUNC */ ||
+                   (binding != 1 /* STB_GLOBAL */ && binding != 2 /* STB_WEAK */))
+                    return nullptr;
+
+                return _base + symbol.st_value;
+            }
+
+            /// \brief Checks whether the symbol is defined with the given version. Symbols
+            ///        of images without version information match any version.
+            bool has_version(size_type index, const char* version) const noexcept
+            {
+                if(!_versions || !_verdefs)
+                    return true;
+
+                const auto wanted = _versions[index] & 0x7FFF;
+                for(auto def = _verdefs;;
+                    def = reinterpret_cast<const Elf64_Verdef*>(
+                        reinterpret_cast<const char*>(def) + def->vd_next)) {
+                    if(!(def->vd_flags & 1 /* VER_FLG_BASE */) && (def->vd_ndx & 0x7FFF) == wanted) {
+                        const auto aux = reinterpret_cast<const Elf64_Verdaux*>(
+                            reinterpret_cast<const char*>(def) + def->vd_aux);
+                        auto name = _strings + aux->vda_name;
+                        for(; *name && *name == *version; ++name, ++version) {}
+                        return *name == *version;
+                    }
+
+                    if(!def->vd_next)
+                        return false;
+                }
+            }
+        };
+
+        // converts an argument of INLINE_SYSCALL to the type of vDSO function parameter.
+        // Missing arguments are zero.
+        template<class P, std::size_t I, class... Ts>
+        JM_INLINE_SYSCALL_FORCEINLINE P vdso_arg(Ts... args) noexcept
+        {
+            if constexpr(I >= sizeof...(Ts))
+                return P{};
+            else {
+                const auto value = nth_arg<I>(args...);
+                if constexpr(std::is_pointer_v<P> == std::is_pointer_v<decltype(value)>)
+                    return (P)value;
+                else if constexpr(std::is_pointer_v<P>)
+                    return reinterpret_cast<P>(static_cast<std::uintptr_t>(value));
+                else
+                    return static_cast<P>(reinterpret_cast<std::uintptr_t>(value));
+            }
+        }
+
+        // the functions that vdso_symbol::address points to before the vDSO is resolved
+        // and when it doesn't contain the symbol.
+        template<std::uint32_t Hash, class Fn>
+        struct vdso_thunks;
+
+        template<std::uint32_t Hash, class R, class... Ps>
+        struct vdso_thunks<Hash, R(Ps...)> {
+            static constexpr std::size_t arity = sizeof...(Ps);
+
+            static R resolve(Ps... args) noexcept;
+
+            static R fallback(Ps... args) noexcept
+            {
+                return static_cast<R>(syscall<void>(vdso_symbol<Hash>::number, args...));
+            }
+
+            template<std::size_t... Is, class... Args>
+            JM_INLINE_SYSCALL_FORCEINLINE static syscall_status
+            call(std::index_sequence<Is...>, Args... args) noexcept
+            {
+                const auto function =
+                    __atomic_load_n(&vdso_symbol<Hash>::address, __ATOMIC_RELAXED);
+                return function(vdso_arg<Ps, Is>(args...)...);
+            }
+        };
+
+#define JM_INLINE_SYSCALL_VDSO_SYMBOL(name, signature)                      \
+    template<>                                                               \
+    struct vdso_symbol<::jm::hash(#name)> {                                  \
+        using type = signature;                                              \
+                                                                             \
+        static constexpr bool          available = true;                     \
+        static constexpr std::uint32_t number    = __NR_##name;              \
+                                                                             \
+        inline static type* address = &vdso_thunks<::jm::hash(#name), type>::resolve; \
+    };
+        JM_INLINE_SYSCALL_VDSO_SYMBOLS(JM_INLINE_SYSCALL_VDSO_SYMBOL)
+#undef JM_INLINE_SYSCALL_VDSO_SYMBOL
+
+        template<std::uint32_t Hash>
+        JM_INLINE_SYSCALL_FORCEINLINE void set_vdso_address(std::uint32_t name_hash,
+                                                            const char*   address) noexcept
+        {
+            using type = typename vdso_symbol<Hash>::type;
+            if(name_hash == Hash)
+                __atomic_store_n(&vdso_symbol<Hash>::address,
+                                 reinterpret_cast<type*>(const_cast<char*>(address)),
+                                 __ATOMIC_RELAXED);
+        }
+
+        // points the symbol that is still unresolved at the function that makes the syscall
+        template<std::uint32_t Hash>
+        JM_INLINE_SYSCALL_FORCEINLINE void set_vdso_fallback() noexcept
+        {
+            using thunks = vdso_thunks<Hash, typename vdso_symbol<Hash>::type>;
+            if(__atomic_load_n(&vdso_symbol<Hash>::address, __ATOMIC_RELAXED) == &thunks::resolve)
+                __atomic_store_n(&vdso_symbol<Hash>::address, &thunks::fallback, __ATOMIC_RELAXED);
+        }
+
+        // returns the name without the prefix of vDSO functions or nullptr if it has none
+        inline const char* strip_vdso_prefix(const char* name) noexcept
+        {
+            for(auto prefix = JM_INLINE_SYSCALL_VDSO_PREFIX; *prefix; ++prefix, ++name)
+                if(*name != *prefix)
+                    return nullptr;
+            return name;
+        }
+
+        // points every vdso_symbol at the matching vDSO function or at the fallback that
+        // makes the syscall if there is none.
+        [[gnu::cold, gnu::noinline]] inline void resolve_vdso() noexcept
+        {
+            const auto image = reinterpret_cast<const char*>(getauxval(AT_SYSINFO_EHDR));
+            if(image) {
+                const elf_symbols symbols(image);
+                for(elf_symbols::size_type i = 0; i < symbols.size(); ++i) {
+                    const auto name    = strip_vdso_prefix(symbols.name(i));
+                    const auto address = symbols.address(i);
+                    if(!address || !name ||
+                       !symbols.has_version(i, JM_INLINE_SYSCALL_VDSO_VERSION))
+                        continue;
+
+                    const auto name_hash = jm::hash(name);
+#define JM_INLINE_SYSCALL_VDSO_SYMBOL(name, signature) \
+    set_vdso_address<::jm::hash(#name)>(name_hash, address);
+                    JM_INLINE_SYSCALL_VDSO_SYMBOLS(JM_INLINE_SYSCALL_VDSO_SYMBOL)
+#undef JM_INLINE_SYSCALL_VDSO_SYMBOL
+                }
+            }
+
+#define JM_INLINE_SYSCALL_VDSO_SYMBOL(name, signature) set_vdso_fallback<::jm::hash(#name)>();
+            JM_INLINE_SYSCALL_VDSO_SYMBOLS(JM_INLINE_SYSCALL_VDSO_SYMBOL)
+#undef JM_INLINE_SYSCALL_VDSO_SYMBOL
+        }
+
+        template<std::uint32_t Hash, class R, class... Ps>
+        R vdso_thunks<Hash, R(Ps...)>::resolve(Ps... args) noexcept
+        {
+            resolve_vdso();
+            return __atomic_load_n(&vdso_symbol<Hash>::address, __ATOMIC_RELAXED)(args...);
+        }
+
+        template<std::uint32_t Hash, class R, class... Args>
+        class vdso_syscall_function<Hash, R(Args...)> : public syscall_function<R(Args...)> {
+            using thunks = vdso_thunks<Hash, typename vdso_symbol<Hash>::type>;
+
+        public:
+            constexpr vdso_syscall_function(syscall_function<R(Args...)> function) noexcept
+                : syscall_function<R(Args...)>(function)
+            {}
+
+            /// \brief Calls the vDSO function, or makes the syscall if the vDSO doesn't
+            ///        implement it.
+            JM_INLINE_SYSCALL_FORCEINLINE R operator()(Args... args) const noexcept
+            {
+                return syscall_result<R>(
+                    thunks::call(std::make_index_sequence<thunks::arity>{}, args...));
+            }
+        };
+
+    } // namespace detail
+
+} // namespace jm
+
+#endif // JM_INLINE_SYSCALL_VDSO_INL
@@ -0,0 +1,49 @@
+/*
+ * Copyright 2018-2020 Justas Masiulis
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef JM_INLINE_SYSCALL_TESTS_CHECK_HPP
+#define JM_INLINE_SYSCALL_TESTS_CHECK_HPP
+
+#include <cstdio>
+
+namespace test {
+
+    inline int failures = 0;
+
+    inline void fail(const char* file, int line, const char* condition)
+    {
+        std::fprintf(stderr, "%s:%d: %s failed\n", file, line, condition);
+        ++failures;
+    }
+
+    // the exit code of the test
+    inline int result()
+    {
+        if(failures)
+            std::fprintf(stderr, "%d checks failed\n", failures);
+        return failures ? 1 : 0;
+    }
+
+} // namespace test
+
+// records a failure and carries on, so that one run reports every failing check
+#define CHECK(condition)                                  \
+    do {                                                  \
+        if(!(condition))                                  \
+            ::test::fail(__FILE__, __LINE__, #condition); \
+    } while(false)
+
+#endif // include guard
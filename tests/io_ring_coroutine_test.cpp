@@ -0,0 +1,165 @@
+/*
+ * Copyright 2018-2020 Justas Masiulis
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* co_awaits io_ring operations from coroutines that are resumed by run_once. Built as
+ * C++20. Exits with 77, which CTest reports as skipped, if io_uring is unavailable.
+ */
+
+#include "check.hpp"
+#include "io_ring.hpp"
+#include <cstdlib>
+#include <fcntl.h>
+#include <unistd.h>
+
+#if !defined(JM_INLINE_SYSCALL_IO_RING_COROUTINES)
+#error "the coroutines of io_ring.hpp need C++20 and <coroutine>"
+#endif
+
+namespace {
+
+    // a coroutine that starts right away and frees itself when it is done
+    struct task {
+        struct promise_type {
+            task               get_return_object() noexcept { return {}; }
+            std::suspend_never initial_suspend() noexcept { return {}; }
+            std::suspend_never final_suspend() noexcept { return {}; }
+            void               return_void() noexcept {}
+            void               unhandled_exception() noexcept { std::abort(); }
+        };
+    };
+
+    struct pipe_results {
+        std::int32_t written = 0;
+        std::int32_t read    = 0;
+        bool         done    = false;
+    };
+
+    // writes the message to the pipe and reads it back from the other end
+    task echo(jm::io_ring&  ring,
+              const int*    fds,
+              const char*   message,
+              std::uint32_t size,
+              char*         buffer,
+              pipe_results& results)
+    {
+        results.written = co_await jm::async_write(ring, fds[1], message, size, 0);
+        results.read    = co_await jm::async_read(ring, fds[0], buffer, size, 0);
+        results.done    = true;
+    }
+
+    task open_and_read(
+        jm::io_ring& ring, char* buffer, std::int32_t& fd, std::int32_t& read, bool& done)
+    {
+        fd = co_await jm::async_openat(ring, AT_FDCWD, "/dev/zero", O_RDONLY | O_CLOEXEC);
+        if(fd >= 0)
+            read = co_await jm::async_read(ring, fd, buffer, 8, 0);
+        done = true;
+    }
+
+    // runs the ring until the flag is set
+    void run_until(jm::io_ring& ring, const bool& done)
+    {
+        for(int rounds = 0; !done && rounds < 1000; ++rounds)
+            CHECK(ring.run_once(1) >= 0);
+    }
+
+    void test_pipe()
+    {
+        jm::io_ring ring(8);
+        CHECK(ring.error() == 0);
+
+        int fds[2];
+        CHECK(::pipe(fds) == 0);
+
+        const char   message[]  = "coroutine";
+        char         buffer[16] = {};
+        pipe_results results;
+        echo(ring, fds, message, sizeof(message), buffer, results);
+
+        // the coroutine is suspended in the write until the ring runs
+        CHECK(!results.done);
+        run_until(ring, results.done);
+        CHECK(results.done);
+        CHECK(results.written == sizeof(message));
+        CHECK(results.read == sizeof(message));
+        CHECK(std::memcmp(buffer, message, sizeof(message)) == 0);
+
+        ::close(fds[0]);
+        ::close(fds[1]);
+    }
+
+    void test_many()
+    {
+        // more coroutines than the submission queue holds, every one with its own pipe
+        jm::io_ring ring(2);
+        CHECK(ring.error() == 0);
+
+        constexpr int count = 8;
+        int           fds[count][2];
+        char          buffers[count][4] = {};
+        pipe_results  results[count];
+        for(int i = 0; i < count; ++i) {
+            CHECK(::pipe(fds[i]) == 0);
+            echo(ring, fds[i], "abc", 4, buffers[i], results[i]);
+        }
+
+        for(int i = 0; i < count; ++i) {
+            run_until(ring, results[i].done);
+            CHECK(results[i].written == 4 && results[i].read == 4);
+            CHECK(std::memcmp(buffers[i], "abc", 4) == 0);
+            ::close(fds[i][0]);
+            ::close(fds[i][1]);
+        }
+    }
+
+    void test_openat()
+    {
+        jm::io_ring ring(4);
+        CHECK(ring.error() == 0);
+
+        char         buffer[8];
+        std::int32_t fd = -1, read = 0;
+        bool         done = false;
+        std::memset(buffer, 0xFF, sizeof(buffer));
+        open_and_read(ring, buffer, fd, read, done);
+
+        run_until(ring, done);
+        CHECK(fd >= 0);
+        CHECK(read == 8);
+        for(const auto byte : buffer)
+            CHECK(byte == 0);
+
+        if(fd >= 0)
+            ::close(fd);
+    }
+
+} // namespace
+
+int main()
+{
+    {
+        jm::io_ring ring(1);
+        if(ring.error() == -ENOSYS || ring.error() == -EPERM) {
+            std::fprintf(stderr, "io_uring is unavailable: %d\n", ring.error());
+            return 77;
+        }
+    }
+
+    test_pipe();
+    test_many();
+    test_openat();
+    return test::result();
+}
@@ -0,0 +1,180 @@
+/*
+ * Copyright 2018-2020 Justas Masiulis
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* Drives io_ring through a pipe, an overflowing completion queue and completion handlers
+ * that reenter the ring. Exits with 77, which CTest reports as skipped, if io_uring is
+ * unavailable.
+ */
+
+#include "check.hpp"
+#include "io_ring.hpp"
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+    // counts how many times every operation was dispatched
+    struct counted : jm::io_ring_completion {
+        int          dispatched = 0;
+        std::int32_t result     = 0;
+
+        counted()
+            : jm::io_ring_completion{ [](jm::io_ring_completion* self,
+                                         std::int32_t            result,
+                                         std::uint32_t) {
+                const auto operation = static_cast<counted*>(self);
+                ++operation->dispatched;
+                operation->result = result;
+            } }
+        {}
+    };
+
+    bool queue_nop(jm::io_ring& ring, jm::io_ring_completion* completion)
+    {
+        const auto sqe = ring.get_sqe();
+        if(!sqe)
+            return false;
+
+        std::memset(sqe, 0, sizeof(*sqe));
+        sqe->opcode    = IORING_OP_NOP;
+        sqe->user_data = reinterpret_cast<std::uint64_t>(completion);
+        return true;
+    }
+
+    // runs the ring until nothing is left in flight
+    int drain(jm::io_ring& ring, int expected)
+    {
+        int count = 0;
+        for(int rounds = 0; count < expected && rounds < 1000; ++rounds) {
+            const auto result = ring.run_once(0);
+            CHECK(result >= 0);
+            if(result < 0)
+                break;
+            count += result;
+        }
+        return count;
+    }
+
+    void test_pipe()
+    {
+        jm::io_ring ring(8);
+        CHECK(ring.error() == 0);
+
+        int fds[2];
+        CHECK(::pipe(fds) == 0);
+
+        const char message[] = "io_ring";
+        char       buffer[16] = {};
+        counted    write, read;
+
+        auto sqe = ring.get_sqe();
+        jm::prepare_write(*sqe, fds[1], message, sizeof(message), 0);
+        sqe->user_data = reinterpret_cast<std::uint64_t>(&write);
+        CHECK(ring.run_once(1) == 1);
+        CHECK(write.dispatched == 1 && write.result == sizeof(message));
+
+        sqe = ring.get_sqe();
+        jm::prepare_read(*sqe, fds[0], buffer, sizeof(buffer), 0);
+        sqe->user_data = reinterpret_cast<std::uint64_t>(&read);
+        CHECK(ring.run_once(1) == 1);
+        CHECK(read.dispatched == 1 && read.result == sizeof(message));
+        CHECK(std::memcmp(buffer, message, sizeof(message)) == 0);
+
+        ::close(fds[0]);
+        ::close(fds[1]);
+    }
+
+    void test_overflow()
+    {
+        // 4 submission and 8 completion queue entries
+        jm::io_ring ring(4);
+        CHECK(ring.error() == 0);
+
+        // submits 4 times more operations than the completion queue holds without reaping
+        constexpr int        count = 32;
+        std::vector<counted> operations(count);
+        for(int i = 0; i < count; i += 4) {
+            for(int j = 0; j < 4; ++j)
+                CHECK(queue_nop(ring, &operations[i + j]));
+
+            // fails with -EBUSY once the kernel has completions that didn't fit
+            const auto submitted = ring.submit();
+            if(submitted < 0) {
+                CHECK(submitted == -EBUSY || submitted == -EAGAIN);
+                // the dispatch makes room and submits what is still in the queue
+                CHECK(ring.run_once(0) >= 0);
+            }
+        }
+
+        CHECK(drain(ring, count) == count);
+        for(const auto& operation : operations)
+            CHECK(operation.dispatched == 1 && operation.result == 0);
+    }
+
+    void test_reentrant()
+    {
+        jm::io_ring ring(8);
+        CHECK(ring.error() == 0);
+
+        // every handler queues the next operation and runs the ring again from within
+        struct chained : jm::io_ring_completion {
+            jm::io_ring* ring;
+            chained*     next       = nullptr;
+            int          dispatched = 0;
+
+            chained()
+                : jm::io_ring_completion{
+                      [](jm::io_ring_completion* self, std::int32_t, std::uint32_t) {
+                          const auto operation = static_cast<chained*>(self);
+                          ++operation->dispatched;
+                          if(operation->next) {
+                              CHECK(queue_nop(*operation->ring, operation->next));
+                              operation->ring->run_once(1);
+                          }
+                      } }
+            {}
+        };
+
+        chained operations[6];
+        for(std::size_t i = 0; i < 6; ++i) {
+            operations[i].ring = &ring;
+            if(i + 1 < 6)
+                operations[i].next = &operations[i + 1];
+        }
+
+        CHECK(queue_nop(ring, &operations[0]));
+        ring.run_once(1);
+        for(const auto& operation : operations)
+            CHECK(operation.dispatched == 1);
+    }
+
+} // namespace
+
+int main()
+{
+    {
+        jm::io_ring ring(1);
+        if(ring.error() == -ENOSYS || ring.error() == -EPERM) {
+            std::fprintf(stderr, "io_uring is unavailable: %d\n", ring.error());
+            return 77;
+        }
+    }
+
+    test_pipe();
+    test_overflow();
+    test_reentrant();
+    return test::result();
+}
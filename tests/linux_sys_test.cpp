@@ -0,0 +1,110 @@
+/*
+ * Copyright 2018-2020 Justas Masiulis
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* Checks the numbers of the generated syscall catalog against <asm/unistd.h> and makes
+ * syscalls through it, including ones whose prototypes have unnamed parameters in the
+ * kernel headers.
+ */
+
+#include "check.hpp"
+#include "linux_sys.hpp"
+#include <asm/unistd.h>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/utsname.h>
+#include <unistd.h>
+
+// the struct sigaction of the kernel, which the catalog leaves to the caller
+struct kernel_sigaction {
+    void*         handler;
+    unsigned long flags;
+    void*         restorer;
+    unsigned long mask;
+};
+
+namespace {
+
+    namespace nr = jm::sys::nr;
+
+    static_assert(nr::read == __NR_read && nr::write == __NR_write);
+    static_assert(nr::stat == __NR_stat && nr::rt_sigaction == __NR_rt_sigaction);
+    static_assert(nr::socketpair == __NR_socketpair && nr::clone == __NR_clone);
+    static_assert(nr::uname == __NR_uname && nr::pipe2 == __NR_pipe2);
+    static_assert(nr::clock_gettime == __NR_clock_gettime && nr::openat == __NR_openat);
+    static_assert(nr::io_uring_setup == __NR_io_uring_setup && nr::rseq == __NR_rseq);
+    static_assert(nr::clone3 == __NR_clone3 && nr::futex_waitv == __NR_futex_waitv);
+
+    void test_pipe()
+    {
+        int fds[2] = { -1, -1 };
+        CHECK(jm::sys::pipe2(fds, O_CLOEXEC) == 0);
+
+        const char message[] = "linux_sys";
+        CHECK(jm::sys::write(fds[1], message, sizeof(message)) ==
+              static_cast<long>(sizeof(message)));
+
+        char buffer[16] = {};
+        CHECK(jm::sys::read(fds[0], buffer, sizeof(buffer)) ==
+              static_cast<long>(sizeof(message)));
+        CHECK(std::memcmp(buffer, message, sizeof(message)) == 0);
+
+        CHECK(jm::sys::close(fds[0]) == 0);
+        CHECK(jm::sys::close(fds[1]) == 0);
+        CHECK(jm::sys::close(fds[1]) == -EBADF);
+    }
+
+    void test_process()
+    {
+        CHECK(jm::sys::getpid() == ::getpid());
+
+        struct ::utsname name;
+        CHECK(jm::sys::uname(&name) == 0);
+        CHECK(std::strcmp(name.sysname, "Linux") == 0);
+    }
+
+    void test_unnamed_parameters()
+    {
+        // reads the current disposition of SIGUSR1 without changing it
+        kernel_sigaction old;
+        std::memset(&old, 0xFF, sizeof(old));
+        CHECK(jm::sys::rt_sigaction(SIGUSR1, nullptr, &old, sizeof(old.mask)) == 0);
+        CHECK(old.handler == reinterpret_cast<void*>(SIG_DFL));
+
+        int fds[2] = { -1, -1 };
+        CHECK(jm::sys::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+
+        sockaddr_storage address;
+        int              length = sizeof(address);
+        CHECK(jm::sys::getsockname(fds[0], reinterpret_cast<sockaddr*>(&address), &length) ==
+              0);
+        CHECK(address.ss_family == AF_UNIX);
+
+        ::close(fds[0]);
+        ::close(fds[1]);
+    }
+
+} // namespace
+
+int main()
+{
+    test_pipe();
+    test_process();
+    test_unnamed_parameters();
+    return test::result();
+}
@@ -0,0 +1,123 @@
+/*
+ * Copyright 2018-2020 Justas Masiulis
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* Makes real syscalls through INLINE_SYSCALL and INLINE_SYSCALL_T and compares them with
+ * the glibc wrappers. Exits with 1 if any check fails.
+ */
+
+#include "check.hpp"
+#include "inline_syscall.hpp"
+#include <cerrno>
+#include <cstring>
+#include <sys/mman.h>
+#include <type_traits>
+#include <unistd.h>
+
+namespace {
+
+    // the kernel prototypes, named like the syscalls
+    namespace kernel {
+        using getpid      = int();
+        using pipe2       = int(int*, int);
+        using read        = long(int, void*, std::size_t);
+        using write       = long(int, const void*, std::size_t);
+        using close       = int(int);
+        using mmap        = void*(void*, std::size_t, int, int, int, long);
+        using munmap      = int(void*, std::size_t);
+        using sched_yield = void();
+    } // namespace kernel
+
+    using namespace kernel;
+
+    void test_getpid()
+    {
+        CHECK(INLINE_SYSCALL_T(getpid)() == ::getpid());
+        // the function pointer form with the glibc declaration
+        CHECK(INLINE_SYSCALL(getppid)() == ::getppid());
+    }
+
+    void test_pipe()
+    {
+        int fds[2] = { -1, -1 };
+        CHECK(INLINE_SYSCALL_T(pipe2)(fds, 0) == 0);
+
+        const char message[] = "inline_syscall";
+        CHECK(INLINE_SYSCALL_T(write)(fds[1], message, sizeof(message)) ==
+              static_cast<long>(sizeof(message)));
+
+        char buffer[64] = {};
+        CHECK(INLINE_SYSCALL_T(read)(fds[0], buffer, sizeof(buffer)) ==
+              static_cast<long>(sizeof(message)));
+        CHECK(std::memcmp(buffer, message, sizeof(message)) == 0);
+
+        CHECK(INLINE_SYSCALL_T(close)(fds[1]) == 0);
+        // end of file once the write end is closed
+        CHECK(INLINE_SYSCALL_T(read)(fds[0], buffer, sizeof(buffer)) == 0);
+        CHECK(INLINE_SYSCALL_T(close)(fds[0]) == 0);
+    }
+
+    void test_errors()
+    {
+        // errors are returned as -errno and errno is left alone
+        errno = 0;
+        char buffer[1];
+        CHECK(INLINE_SYSCALL_T(read)(-1, buffer, sizeof(buffer)) == -EBADF);
+        CHECK(INLINE_SYSCALL_T(write)(-1, buffer, sizeof(buffer)) == -EBADF);
+        CHECK(INLINE_SYSCALL_T(close)(-1) == -EBADF);
+        CHECK(errno == 0);
+    }
+
+    void test_mmap()
+    {
+        // 6 arguments and a pointer return type
+        const std::size_t size = 2 * 4096;
+        const auto memory      = INLINE_SYSCALL_T(mmap)(
+            nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        // the last 4095 addresses are -errno
+        const auto address = reinterpret_cast<std::uintptr_t>(memory);
+        const auto mapped  = address < -std::uintptr_t{ 4095 };
+        CHECK(mapped);
+        if(mapped) {
+            std::memset(memory, 0x5A, size);
+            CHECK(static_cast<unsigned char*>(memory)[size - 1] == 0x5A);
+            CHECK(INLINE_SYSCALL_T(munmap)(memory, size) == 0);
+        }
+
+        // a failing mmap returns -errno as the pointer
+        const auto failed =
+            INLINE_SYSCALL_T(mmap)(nullptr, size, PROT_READ, MAP_PRIVATE, -1, 0);
+        CHECK(reinterpret_cast<long>(failed) == -EBADF);
+        CHECK(INLINE_SYSCALL_T(munmap)(reinterpret_cast<void*>(1), 1) == -EINVAL);
+    }
+
+    void test_void()
+    {
+        INLINE_SYSCALL_T(sched_yield)();
+        static_assert(std::is_void_v<decltype(INLINE_SYSCALL_T(sched_yield)())>);
+    }
+
+} // namespace
+
+int main()
+{
+    test_getpid();
+    test_pipe();
+    test_errors();
+    test_mmap();
+    test_void();
+
+    return test::result();
+}
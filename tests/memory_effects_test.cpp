@@ -0,0 +1,146 @@
+/*
+ * Copyright 2018-2020 Justas Masiulis
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* Annotates a syscall of every arity from 0 to 6 with memory effects that name its last
+ * argument, so that the stub of every arity has to bind it. Compiling is the main check,
+ * running it checks that the memory the kernel wrote is read back after the call.
+ */
+
+#include "check.hpp"
+#include "inline_syscall.hpp"
+#include <cerrno>
+#include <cstring>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/utsname.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+JM_INLINE_SYSCALL_EFFECTS(getpid, jm::no_memory_effects);
+JM_INLINE_SYSCALL_EFFECTS(uname, jm::writes_memory<0>);
+JM_INLINE_SYSCALL_EFFECTS(fstat, jm::writes_memory<1>);
+JM_INLINE_SYSCALL_EFFECTS(getresuid, jm::writes_memory<0, 1, 2>);
+JM_INLINE_SYSCALL_EFFECTS(wait4, jm::writes_memory<1, 3>);
+JM_INLINE_SYSCALL_EFFECTS(prlimit64,
+                          jm::syscall_effects<std::index_sequence<2>, std::index_sequence<3>>);
+JM_INLINE_SYSCALL_EFFECTS(getsockopt, jm::writes_memory<3, 4>);
+JM_INLINE_SYSCALL_EFFECTS(recvfrom, jm::writes_memory<1, 4, 5>);
+
+namespace {
+
+    // the kernel prototypes, named like the syscalls
+    namespace kernel {
+        using getpid     = int();
+        using uname      = int(struct ::utsname*);
+        using fstat      = int(int, struct ::stat*);
+        using getresuid  = int(uid_t*, uid_t*, uid_t*);
+        using wait4      = int(int, int*, int, struct ::rusage*);
+        using prlimit64  = int(int, int, const struct ::rlimit*, struct ::rlimit*);
+        using getsockopt = int(int, int, int, void*, socklen_t*);
+        using recvfrom   = long(int, void*, std::size_t, int, sockaddr*, socklen_t*);
+    } // namespace kernel
+
+    using namespace kernel;
+
+    void test_no_arguments() { CHECK(INLINE_SYSCALL_T(getpid)() == ::getpid()); }
+
+    void test_one_argument()
+    {
+        struct ::utsname name;
+        name.sysname[0] = 0;
+        CHECK(INLINE_SYSCALL_T(uname)(&name) == 0);
+        CHECK(std::strcmp(name.sysname, "Linux") == 0);
+    }
+
+    void test_two_arguments()
+    {
+        int fds[2];
+        CHECK(::pipe(fds) == 0);
+
+        struct ::stat status;
+        status.st_mode = 0;
+        CHECK(INLINE_SYSCALL_T(fstat)(fds[0], &status) == 0);
+        CHECK(S_ISFIFO(status.st_mode));
+
+        ::close(fds[0]);
+        ::close(fds[1]);
+    }
+
+    void test_three_arguments()
+    {
+        uid_t real = -1, effective = -1, saved = -1;
+        CHECK(INLINE_SYSCALL_T(getresuid)(&real, &effective, &saved) == 0);
+        CHECK(real == ::getuid() && effective == ::geteuid());
+    }
+
+    void test_four_arguments()
+    {
+        // there are no children to wait for, so nothing is written
+        int             status = 0;
+        struct ::rusage usage;
+        CHECK(INLINE_SYSCALL_T(wait4)(-1, &status, WNOHANG, &usage) == -ECHILD);
+
+        // sets the limit that is already there and reads the old one back
+        struct ::rlimit current;
+        CHECK(::getrlimit(RLIMIT_NOFILE, &current) == 0);
+        struct ::rlimit old = { 0, 0 };
+        CHECK(INLINE_SYSCALL_T(prlimit64)(0, RLIMIT_NOFILE, &current, &old) == 0);
+        CHECK(old.rlim_cur == current.rlim_cur && old.rlim_max == current.rlim_max);
+    }
+
+    void test_five_and_six_arguments()
+    {
+        int fds[2];
+        CHECK(::socketpair(AF_UNIX, SOCK_DGRAM, 0, fds) == 0);
+
+        int       type   = 0;
+        socklen_t length = sizeof(type);
+        CHECK(INLINE_SYSCALL_T(getsockopt)(fds[0], SOL_SOCKET, SO_TYPE, &type, &length) == 0);
+        CHECK(type == SOCK_DGRAM && length == sizeof(type));
+
+        const char message[] = "effects";
+        CHECK(::send(fds[1], message, sizeof(message), 0) == sizeof(message));
+
+        char             buffer[16] = {};
+        sockaddr_storage address;
+        socklen_t        address_length = sizeof(address);
+        CHECK(INLINE_SYSCALL_T(recvfrom)(fds[0],
+                                         buffer,
+                                         sizeof(buffer),
+                                         0,
+                                         reinterpret_cast<sockaddr*>(&address),
+                                         &address_length) == sizeof(message));
+        CHECK(std::memcmp(buffer, message, sizeof(message)) == 0);
+        // an unnamed socket has no address beyond its family
+        CHECK(address_length < sizeof(address));
+
+        ::close(fds[0]);
+        ::close(fds[1]);
+    }
+
+} // namespace
+
+int main()
+{
+    test_no_arguments();
+    test_one_argument();
+    test_two_arguments();
+    test_three_arguments();
+    test_four_arguments();
+    test_five_and_six_arguments();
+    return test::result();
+}
@@ -0,0 +1,83 @@
+/*
+ * Copyright 2018-2020 Justas Masiulis
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* Makes syscalls through call sites with patched ids, before and after patching them.
+ * Built with JM_INLINE_SYSCALL_PATCHED_IDS and optimizations, which would hoist the
+ * placeholder id of a call site above the patching if nothing kept it there.
+ */
+
+#include "check.hpp"
+#include "patch_init.hpp"
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+
+namespace {
+
+    // the kernel prototypes, named like the syscalls
+    namespace kernel {
+        using getpid = int();
+        using pipe2  = int(int*, int);
+        using write  = long(int, const void*, std::size_t);
+        using read   = long(int, void*, std::size_t);
+        using close  = int(int);
+    } // namespace kernel
+
+    using namespace kernel;
+
+    void test_loop()
+    {
+        // the same call site runs before and after patching
+        int results[4];
+        for(int i = 0; i < 4; ++i) {
+            if(i == 1)
+                CHECK(jm::patch_syscall_sites());
+            results[i] = INLINE_SYSCALL_T(getpid)();
+        }
+
+        CHECK(results[0] == -ENOSYS);
+        for(int i = 1; i < 4; ++i)
+            CHECK(results[i] == ::getpid());
+        CHECK(jm::verify_syscall_sites());
+    }
+
+    void test_pipe()
+    {
+        int fds[2] = { -1, -1 };
+        CHECK(INLINE_SYSCALL_T(pipe2)(fds, 0) == 0);
+
+        const char message[] = "patched";
+        CHECK(INLINE_SYSCALL_T(write)(fds[1], message, sizeof(message)) ==
+              static_cast<long>(sizeof(message)));
+
+        char buffer[16] = {};
+        CHECK(INLINE_SYSCALL_T(read)(fds[0], buffer, sizeof(buffer)) ==
+              static_cast<long>(sizeof(message)));
+        CHECK(std::memcmp(buffer, message, sizeof(message)) == 0);
+
+        CHECK(INLINE_SYSCALL_T(close)(fds[0]) == 0);
+        CHECK(INLINE_SYSCALL_T(close)(fds[1]) == 0);
+        CHECK(INLINE_SYSCALL_T(close)(fds[1]) == -EBADF);
+    }
+
+} // namespace
+
+int main()
+{
+    test_loop();
+    test_pipe();
+    return test::result();
+}
@@ -0,0 +1,205 @@
+/*
+ * Copyright 2018-2020 Justas Masiulis
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* Writes a snapshot of the ids resolved from a synthetic PE32+ image and applies it again,
+ * and checks that snapshots of an image with another TimeDateStamp or CheckSum, or of a
+ * binary with other syscall entries, are rejected.
+ *
+ * The syscall entries are an array placed in the entry section by hand, as GCC ignores
+ * the section attributes of the entries that INLINE_SYSCALL instantiates.
+ */
+
+#include "check.hpp"
+#include "snapshot_init.hpp"
+#include <cstring>
+#include <vector>
+
+namespace {
+
+    using entry = JM_INLINE_SYSCALL_ENTRY_TYPE;
+
+    struct synthetic_export {
+        const char*   name;
+        std::uint32_t id;
+    };
+
+    // the exports, sorted by name, with the ids in their stubs
+    const synthetic_export exports[] = { { "ZwClose", 0xF },
+                                         { "ZwOpenFile", 0x33 },
+                                         { "ZwReadFile", 0x6 },
+                                         { "ZwYieldExecution", 0x46 } };
+    constexpr std::size_t  export_count = sizeof(exports) / sizeof(exports[0]);
+
+    // the syscalls of the binary, in no particular order
+    const char* const names[] = { "NtReadFile", "NtClose", "NtYieldExecution" };
+    const std::uint32_t expected[] = { 0x6, 0xF, 0x46 };
+    constexpr std::size_t entry_count = sizeof(names) / sizeof(names[0]);
+
+    [[gnu::section(JM_INLINE_SYSCALL_ENTRY_SECTION), gnu::used]] entry entries[entry_count];
+
+    template<class T>
+    void write(std::vector<char>& image, std::size_t offset, const T& value) noexcept
+    {
+        std::memcpy(image.data() + offset, &value, sizeof(value));
+    }
+
+    // generates a PE32+ image that exports the syscall stubs with the given identity. It
+    // has a single section that starts at the same offset in the file and in memory.
+    std::vector<char> make_image(std::uint32_t time_date_stamp, std::uint32_t check_sum)
+    {
+        namespace d = jm::detail;
+
+        constexpr std::uint32_t headers_size = 0x1000;
+        constexpr std::uint32_t end          = 0x3000;
+        constexpr std::uint32_t stubs        = 0x2000;
+
+        constexpr auto      count     = static_cast<std::uint32_t>(export_count);
+        const std::uint32_t ied       = headers_size;
+        const std::uint32_t functions = ied + sizeof(d::IMAGE_EXPORT_DIRECTORY);
+        const std::uint32_t name_rvas = functions + count * 4;
+        const std::uint32_t ordinals  = name_rvas + count * 4;
+        const std::uint32_t strings   = ordinals + count * 2;
+
+        std::vector<char> image(end);
+
+        d::IMAGE_DOS_HEADER dos{};
+        dos.e_magic  = 0x5A4D;
+        dos.e_lfanew = sizeof(dos);
+        write(image, 0, dos);
+
+        d::IMAGE_NT_HEADERS nt{};
+        nt.Signature                          = 0x4550;
+        nt.FileHeader.Machine                 = 0x8664;
+        nt.FileHeader.NumberOfSections        = 1;
+        nt.FileHeader.TimeDateStamp           = time_date_stamp;
+        nt.FileHeader.SizeOfOptionalHeader    = sizeof(nt.OptionalHeader);
+        nt.OptionalHeader.Magic               = 0x20B;
+        nt.OptionalHeader.SectionAlignment    = 0x1000;
+        nt.OptionalHeader.FileAlignment       = 0x1000;
+        nt.OptionalHeader.SizeOfImage         = end;
+        nt.OptionalHeader.SizeOfHeaders       = headers_size;
+        nt.OptionalHeader.CheckSum            = check_sum;
+        nt.OptionalHeader.NumberOfRvaAndSizes = 16;
+        nt.OptionalHeader.DataDirectory[0]    = { ied, 0x1000 };
+        write(image, sizeof(dos), nt);
+
+        d::IMAGE_SECTION_HEADER text{};
+        std::memcpy(text.Name, ".text", 5);
+        text.VirtualSize      = end - headers_size;
+        text.VirtualAddress   = headers_size;
+        text.SizeOfRawData    = end - headers_size;
+        text.PointerToRawData = headers_size;
+        text.Characteristics  = 0x60000020;
+        write(image, sizeof(dos) + sizeof(nt), text);
+
+        d::IMAGE_EXPORT_DIRECTORY directory{};
+        directory.Base                  = 1;
+        directory.NumberOfFunctions     = count;
+        directory.NumberOfNames         = count;
+        directory.AddressOfFunctions    = functions;
+        directory.AddressOfNames        = name_rvas;
+        directory.AddressOfNameOrdinals = ordinals;
+        write(image, ied, directory);
+
+        auto string = strings;
+        for(std::uint32_t i = 0; i < count; ++i) {
+            const auto stub = stubs + i * 0x20;
+            write(image, functions + i * 4, stub);
+            write(image, name_rvas + i * 4, string);
+            write(image, ordinals + i * 2, static_cast<std::uint16_t>(i));
+
+            const auto length = std::strlen(exports[i].name) + 1;
+            std::memcpy(image.data() + string, exports[i].name, length);
+            string += static_cast<std::uint32_t>(length);
+
+            // mov r10, rcx; mov eax, id
+            const unsigned char mov[] = { 0x4C, 0x8B, 0xD1, 0xB8 };
+            std::memcpy(image.data() + stub, mov, sizeof(mov));
+            write(image, stub + sizeof(mov), exports[i].id);
+        }
+
+        return image;
+    }
+
+    // gives the entries their hashes back, as if the binary was started again
+    void reset_entries(const char* const* syscalls) noexcept
+    {
+        for(std::size_t i = 0; i < entry_count; ++i)
+            entries[i] = jm::detail::make_syscall_entry<entry>(jm::hash(syscalls[i]));
+    }
+
+    bool entries_resolved() noexcept
+    {
+        bool resolved = true;
+        for(std::size_t i = 0; i < entry_count; ++i)
+            resolved &= entries[i].id == expected[i];
+        return resolved;
+    }
+
+    jm::detail::snapshot_header header_of(const std::vector<char>& image)
+    {
+        const jm::detail::exports_directory directory(
+            image.data(), image.size(), jm::image_layout::mapped);
+        return jm::detail::make_snapshot_header(*directory.headers());
+    }
+
+    void test_snapshot(const char* path)
+    {
+        // the array has to be the syscall entries of the binary
+        CHECK(jm::syscall_entries() <= entries &&
+              entries + entry_count <= jm::syscall_entries_end());
+
+        const auto image = make_image(0x5F5E1000, 0x1E8480);
+        const jm::detail::exports_directory directory(
+            image.data(), image.size(), jm::image_layout::mapped);
+        CHECK(directory.size() == export_count);
+
+        // resolves and snapshots the ids like the first start would
+        std::remove(path);
+        reset_entries(names);
+        const auto header = jm::detail::make_snapshot_header(*directory.headers());
+        CHECK(!jm::detail::apply_snapshot(path, header));
+        jm::detail::resolve_syscall_entries(directory);
+        CHECK(entries_resolved());
+        jm::detail::write_snapshot(path, header);
+
+        // the next start takes the ids from the snapshot
+        reset_entries(names);
+        CHECK(jm::detail::apply_snapshot(path, header_of(image)));
+        CHECK(entries_resolved());
+
+        // an ntdll that was updated in place
+        reset_entries(names);
+        CHECK(!jm::detail::apply_snapshot(path, header_of(make_image(0x5F5E1001, 0x1E8480))));
+        CHECK(!jm::detail::apply_snapshot(path, header_of(make_image(0x5F5E1000, 0x1E8481))));
+        CHECK(!entries_resolved());
+
+        // a binary that uses another syscall
+        const char* const other[] = { "NtReadFile", "NtOpenFile", "NtYieldExecution" };
+        reset_entries(other);
+        CHECK(!jm::detail::apply_snapshot(path, header_of(image)));
+        CHECK(entries[1].id != 0xF);
+
+        std::remove(path);
+    }
+
+} // namespace
+
+int main()
+{
+    test_snapshot("snapshot_init_test.snapshot");
+    return test::result();
+}
@@ -0,0 +1,244 @@
+/*
+ * Copyright 2018-2020 Justas Masiulis
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* Checks the ids that resolve_syscall_entries_sorted assigns.
+ *
+ * Without arguments it resolves entries against a synthetic PE32+ image whose Zw* stubs
+ * are hooked, spread out with gaps and other code between them and partly aliased, and
+ * checks the ids against the rank of the stub addresses.
+ *
+ * With the path of an x64 ntdll.dll it resolves an entry for every Zw* export of that
+ * file both by rank and by reading the ids out of the stubs, like init_syscalls_list
+ * does, and checks that they agree. Exits with 77, which CTest reports as skipped, if
+ * the file can't be read.
+ */
+
+#include "check.hpp"
+#include "sorted_init.hpp"
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+namespace {
+
+    using entry = jm::syscall_entry_full;
+
+    struct synthetic_export {
+        const char*   name;
+        std::uint32_t rva;
+    };
+
+    template<class T>
+    void write(std::vector<char>& image, std::size_t offset, const T& value) noexcept
+    {
+        std::memcpy(image.data() + offset, &value, sizeof(value));
+    }
+
+    // generates a PE32+ image that exports the given names, which have to be sorted, at the
+    // given addresses. Every export has a function of its own, so aliases only share the
+    // address. The stubs start with jmp rel32 like inline hooks do.
+    std::vector<char> make_image(const std::vector<synthetic_export>& exports)
+    {
+        namespace d = jm::detail;
+
+        constexpr std::uint32_t headers_size = 0x1000;
+        constexpr std::uint32_t end          = 0x4000;
+
+        const auto          count     = static_cast<std::uint32_t>(exports.size());
+        const std::uint32_t ied       = headers_size;
+        const std::uint32_t functions = ied + sizeof(d::IMAGE_EXPORT_DIRECTORY);
+        const std::uint32_t name_rvas = functions + count * 4;
+        const std::uint32_t ordinals  = name_rvas + count * 4;
+        const std::uint32_t strings   = ordinals + count * 2;
+
+        std::vector<char> image(end);
+
+        d::IMAGE_DOS_HEADER dos{};
+        dos.e_magic  = 0x5A4D;
+        dos.e_lfanew = sizeof(dos);
+        write(image, 0, dos);
+
+        d::IMAGE_NT_HEADERS nt{};
+        nt.Signature                          = 0x4550;
+        nt.FileHeader.Machine                 = 0x8664;
+        nt.FileHeader.NumberOfSections        = 1;
+        nt.FileHeader.SizeOfOptionalHeader    = sizeof(nt.OptionalHeader);
+        nt.OptionalHeader.Magic               = 0x20B;
+        nt.OptionalHeader.SectionAlignment    = 0x1000;
+        nt.OptionalHeader.FileAlignment       = 0x1000;
+        nt.OptionalHeader.SizeOfImage         = end;
+        nt.OptionalHeader.SizeOfHeaders       = headers_size;
+        nt.OptionalHeader.NumberOfRvaAndSizes = 16;
+        nt.OptionalHeader.DataDirectory[0]    = { ied, 0x1000 };
+        write(image, sizeof(dos), nt);
+
+        d::IMAGE_SECTION_HEADER text{};
+        std::memcpy(text.Name, ".text", 5);
+        text.VirtualSize      = end - headers_size;
+        text.VirtualAddress   = headers_size;
+        text.SizeOfRawData    = end - headers_size;
+        text.PointerToRawData = headers_size;
+        text.Characteristics  = 0x60000020;
+        write(image, sizeof(dos) + sizeof(nt), text);
+
+        d::IMAGE_EXPORT_DIRECTORY directory{};
+        directory.Base                  = 1;
+        directory.NumberOfFunctions     = count;
+        directory.NumberOfNames         = count;
+        directory.AddressOfFunctions    = functions;
+        directory.AddressOfNames        = name_rvas;
+        directory.AddressOfNameOrdinals = ordinals;
+        write(image, ied, directory);
+
+        auto string = strings;
+        for(std::uint32_t i = 0; i < count; ++i) {
+            write(image, functions + i * 4, exports[i].rva);
+            write(image, name_rvas + i * 4, string);
+            write(image, ordinals + i * 2, static_cast<std::uint16_t>(i));
+
+            const auto length = std::strlen(exports[i].name) + 1;
+            std::memcpy(image.data() + string, exports[i].name, length);
+            string += static_cast<std::uint32_t>(length);
+
+            // jmp rel32; int3; int3; int3
+            const unsigned char jmp[] = { 0xE9, 0, 0x10, 0, 0, 0xCC, 0xCC, 0xCC };
+            std::memcpy(image.data() + exports[i].rva, jmp, sizeof(jmp));
+        }
+
+        return image;
+    }
+
+    struct recorded_unresolved {
+        std::vector<std::uint32_t> hashes;
+
+        void operator()(std::uint32_t hash) { hashes.push_back(hash); }
+    };
+
+    void test_synthetic(jm::image_layout layout)
+    {
+        // in the order of their names. The stubs are 0x20 apart with larger gaps in
+        // between and RtlGetVersion sits between two of them. ZwCloseAlias shares the
+        // stub of ZwClose.
+        const auto image = make_image({ { "NtAccessCheck", 0x2000 },
+                                        { "NtAddAtom", 0x2060 },
+                                        { "NtCallbackReturn", 0x2100 },
+                                        { "NtClose", 0x2120 },
+                                        { "NtMapViewOfSection", 0x3800 },
+                                        { "NtWorkerFactoryWorkerReady", 0x2020 },
+                                        { "NtYieldExecution", 0x3000 },
+                                        { "RtlGetVersion", 0x3400 },
+                                        { "ZwAccessCheck", 0x2000 },
+                                        { "ZwAddAtom", 0x2060 },
+                                        { "ZwCallbackReturn", 0x2100 },
+                                        { "ZwClose", 0x2120 },
+                                        { "ZwCloseAlias", 0x2120 },
+                                        { "ZwMapViewOfSection", 0x3800 },
+                                        { "ZwWorkerFactoryWorkerReady", 0x2020 },
+                                        { "ZwYieldExecution", 0x3000 } });
+
+        const jm::detail::exports_directory exports(image.data(), image.size(), layout);
+        CHECK(exports.size() == 16);
+
+        // the entries are in no particular order and one of them is padding
+        const char* const names[] = { "NtYieldExecution", "NtClose",
+                                      "NtAccessCheck",    "NtCloseAlias",
+                                      "NtAddAtom",        "NtMapViewOfSection",
+                                      "NtCallbackReturn", "NtWorkerFactoryWorkerReady" };
+        const std::uint32_t expected[] = { 5, 4, 0, 4, 2, 6, 3, 1 };
+
+        entry entries[9];
+        for(std::size_t i = 0; i < 8; ++i)
+            entries[i] = jm::detail::make_syscall_entry<entry>(jm::hash(names[i]));
+        entries[8].id = 0xFFFF;
+
+        recorded_unresolved unresolved;
+        CHECK(jm::detail::resolve_syscall_entries_sorted(
+            exports, entries, entries + 9, unresolved));
+        CHECK(unresolved.hashes.empty());
+        for(std::size_t i = 0; i < 8; ++i)
+            CHECK(entries[i].id == expected[i]);
+        CHECK(entries[8].id == 0xFFFF);
+
+        // a syscall that isn't exported is reported and the others are still resolved
+        entry partial[2] = { jm::detail::make_syscall_entry<entry>(jm::hash("NtNotExported")),
+                             jm::detail::make_syscall_entry<entry>(jm::hash("NtAddAtom")) };
+        CHECK(!jm::detail::resolve_syscall_entries_sorted(
+            exports, partial, partial + 2, unresolved));
+        CHECK(unresolved.hashes.size() == 1 &&
+              unresolved.hashes[0] == jm::hash("NtNotExported"));
+        CHECK(partial[1].id == 2);
+    }
+
+    // mov r10, rcx; mov eax, id
+    bool is_syscall_stub(const jm::detail::exports_directory& exports,
+                         jm::detail::exports_directory::size_type index)
+    {
+        const auto address = exports.address(index);
+        return address && exports.contains(address, 8) &&
+               std::memcmp(address, "\x4C\x8B\xD1\xB8", 4) == 0;
+    }
+
+    int test_ntdll(const char* path)
+    {
+        std::ifstream     file(path, std::ios::binary);
+        std::vector<char> image((std::istreambuf_iterator<char>(file)),
+                                std::istreambuf_iterator<char>());
+        if(image.empty()) {
+            std::fprintf(stderr, "%s can't be read\n", path);
+            return 77;
+        }
+
+        const jm::detail::exports_directory exports(
+            image.data(), image.size(), jm::image_layout::file);
+        CHECK(exports.size() != 0);
+
+        // an entry for every Zw* export whose stub hasn't been patched
+        std::vector<entry> by_stub;
+        const auto         last = jm::detail::lower_bound(exports, "Zx");
+        for(auto i = jm::detail::lower_bound(exports, "Zw"); i < last; ++i)
+            if(exports.name(i) && is_syscall_stub(exports, i))
+                by_stub.push_back(
+                    jm::detail::make_syscall_entry<entry>(jm::hash(exports.name(i))));
+        CHECK(by_stub.size() > 100);
+
+        auto by_rank = by_stub;
+        jm::detail::resolve_syscall_entries(
+            exports, by_stub.data(), by_stub.data() + by_stub.size());
+        recorded_unresolved unresolved;
+        CHECK(jm::detail::resolve_syscall_entries_sorted(
+            exports, by_rank.data(), by_rank.data() + by_rank.size(), unresolved));
+
+        std::size_t mismatches = 0;
+        for(std::size_t i = 0; i < by_stub.size(); ++i)
+            if(by_stub[i].id != by_rank[i].id)
+                ++mismatches;
+        CHECK(mismatches == 0);
+        std::printf("%zu Zw* stubs of %s, %zu ids differ\n", by_stub.size(), path, mismatches);
+        return test::result();
+    }
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    if(argc > 1)
+        return test_ntdll(argv[1]);
+
+    test_synthetic(jm::image_layout::mapped);
+    test_synthetic(jm::image_layout::file);
+    return test::result();
+}
@@ -0,0 +1,136 @@
+/*
+ * Copyright 2018-2020 Justas Masiulis
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* Delivers user APCs while a syscall with stack arguments is waiting. The APC dispatcher
+ * pushes its CONTEXT below the rsp of the syscall and the APC itself uses the stack below
+ * that, so anything live that the stub left below rsp is overwritten. Checks that the
+ * values around the call site survive and that the kernel read the stack argument.
+ */
+
+#include "check.hpp"
+#include "in_memory_init.hpp"
+#include <windows.h>
+
+namespace {
+
+    // the ntdll prototypes, named like the syscalls
+    namespace nt {
+        using NtWaitForMultipleObjects =
+            LONG(ULONG, const HANDLE*, int, BOOLEAN, const LARGE_INTEGER*);
+    } // namespace nt
+
+    using namespace nt;
+
+    constexpr LONG status_user_apc = 0xC0;
+    constexpr LONG status_timeout  = 0x102;
+
+    volatile LONG apc_calls = 0;
+
+    void NTAPI apc(ULONG_PTR)
+    {
+        // dirties the stack like an APC that does real work would
+        volatile unsigned char scratch[8192];
+        for(auto& byte : scratch)
+            byte = 0xCC;
+        InterlockedIncrement(&apc_calls);
+    }
+
+    DWORD WINAPI queue_apc_later(void* thread)
+    {
+        Sleep(100);
+        QueueUserAPC(apc, static_cast<HANDLE>(thread), 0);
+        return 0;
+    }
+
+    // waits alertably on an event that is never signaled, with values that are live across
+    // the syscall on the stack of the caller.
+    [[gnu::noinline]] LONG wait(HANDLE event, LONGLONG timeout, bool& intact)
+    {
+        volatile std::uintptr_t canaries[32];
+        for(std::size_t i = 0; i < 32; ++i)
+            canaries[i] = 0x5A5A5A5A00000000 | i;
+
+        LARGE_INTEGER relative;
+        relative.QuadPart = timeout;
+        const auto status = INLINE_SYSCALL_T(NtWaitForMultipleObjects)(
+            1, &event, /* WaitAny */ 1, TRUE, &relative);
+
+        intact = relative.QuadPart == timeout;
+        for(std::size_t i = 0; i < 32; ++i)
+            intact &= canaries[i] == (0x5A5A5A5A00000000 | i);
+        return status;
+    }
+
+    void test_queued_before()
+    {
+        const auto event = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+        CHECK(event != nullptr);
+
+        // the pending APC is delivered as soon as the wait starts
+        apc_calls = 0;
+        CHECK(QueueUserAPC(apc, GetCurrentThread(), 0));
+        bool intact = false;
+        CHECK(wait(event, -10 * 1000 * 1000, intact) == status_user_apc);
+        CHECK(intact);
+        CHECK(apc_calls == 1);
+
+        // nothing is pending, so the wait times out after the 1ms of the stack argument
+        CHECK(wait(event, -10 * 1000, intact) == status_timeout);
+        CHECK(intact);
+        CHECK(apc_calls == 1);
+
+        CloseHandle(event);
+    }
+
+    void test_queued_during()
+    {
+        const auto event = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+        CHECK(event != nullptr);
+
+        HANDLE self;
+        CHECK(DuplicateHandle(GetCurrentProcess(),
+                              GetCurrentThread(),
+                              GetCurrentProcess(),
+                              &self,
+                              0,
+                              FALSE,
+                              DUPLICATE_SAME_ACCESS));
+
+        // the APC is queued by another thread while this one is blocked in the kernel
+        apc_calls        = 0;
+        const auto other = CreateThread(nullptr, 0, queue_apc_later, self, 0, nullptr);
+        CHECK(other != nullptr);
+        bool intact = false;
+        CHECK(wait(event, -10 * 10 * 1000 * 1000, intact) == status_user_apc);
+        CHECK(intact);
+        CHECK(apc_calls == 1);
+
+        WaitForSingleObject(other, INFINITE);
+        CloseHandle(other);
+        CloseHandle(self);
+        CloseHandle(event);
+    }
+
+} // namespace
+
+int main()
+{
+    jm::init_syscalls_list();
+
+    test_queued_before();
+    test_queued_during();
+    return test::result();
+}
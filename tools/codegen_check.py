@@ -0,0 +1,263 @@
+#!/usr/bin/env python3
+#
+# Copyright 2018-2020 Justas Masiulis
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""Checks the shape of the code generated for INLINE_SYSCALL call sites.
+
+A matrix of call sites is compiled for every arity that the stubs of the selected ABI
+support, once with arguments coming from registers and once with immediate arguments.
+Every call site is a separate function, whose instruction count and largest stack adjustment
+are taken from the objdump disassembly.
+
+  codegen_check.py                       print the table for every available compiler
+  codegen_check.py --update FILE         record the current numbers as expectations
+  codegen_check.py --expect FILE         fail if any call site grew compared to FILE or
+                                         has no expectation in it
+
+The windows ABI is checked on any host by undefining __linux__, which selects the
+Windows stubs, and compiling for the Microsoft calling convention: clang targets
+x86_64-w64-mingw32 and gcc uses -mabi=ms. The resulting object is never linked, so its
+format doesn't matter.
+The arm64 ABI is cross compiled, with clang's --target or with the aarch64-linux-gnu-
+prefixed gcc, and is only checked when asked for with --abi arm64.
+Expectations are keyed by compiler version. A call site without an expectation fails the
+check, so a compiler upgrade has to be followed by updating the expectations.
+"""
+
+import argparse
+import os
+import re
+import shutil
+import subprocess
+import sys
+import tempfile
+
+INCLUDE_DIR = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "include")
+
+# the maximum arity of the stubs of every ABI
+MAX_ARITY = {"linux": 6, "windows": 16, "arm64": 6}
+
+# the linux stubs need <asm/unistd.h> so they can only be checked on a linux host
+ABI_FLAGS = {"linux": [], "windows": ["-U__linux__", "-D_WIN32"], "arm64": []}
+
+# the flags that select the Microsoft calling convention, by compiler
+WINDOWS_ABI_FLAGS = {"clang": ["--target=x86_64-w64-mingw32"], "gcc": ["-mabi=ms"]}
+
+# the target triple of ABIs that are cross compiled
+CROSS_TARGET = {"arm64": "aarch64-linux-gnu"}
+
+
+def generate_source(abi):
+    # the prototypes aren't named like linux syscalls
+    lines = ["#define JM_INLINE_SYSCALL_UNKNOWN_NAMES",
+             '#include "inline_syscall.hpp"',
+             "#include <cstdint>",
+             ""]
+    for arity in range(MAX_ARITY[abi] + 1):
+        params = ", ".join(["std::uintptr_t"] * arity)
+        lines.append("using codegen_fn_%d = long(%s);" % (arity, params))
+
+    lines.append("")
+    for arity in range(MAX_ARITY[abi] + 1):
+        names = ["a%d" % i for i in range(arity)]
+        params = ", ".join("std::uintptr_t " + name for name in names)
+        lines.append('extern "C" long codegen_reg_%d(%s)' % (arity, params))
+        lines.append("{ return INLINE_SYSCALL_T(codegen_fn_%d)(%s); }" % (arity, ", ".join(names)))
+
+        immediates = ", ".join(str(i + 1) for i in range(arity))
+        lines.append('extern "C" long codegen_imm_%d()' % arity)
+        lines.append("{ return INLINE_SYSCALL_T(codegen_fn_%d)(%s); }" % (arity, immediates))
+
+    return "\n".join(lines) + "\n"
+
+
+def compiler_version(compiler):
+    """Returns the family and version of the compiler, which don't depend on the name it is
+    invoked with, like c++ or a cross prefix."""
+    output = subprocess.run([compiler, "--version"], capture_output=True, text=True).stdout
+    family = "clang" if "clang" in output else "gcc"
+    option = "-dumpversion" if family == "clang" else "-dumpfullversion"
+    version = subprocess.run([compiler, option], capture_output=True, text=True).stdout
+    return "%s %s" % (family, version.strip() or "unknown")
+
+
+def abi_tools(compiler, abi):
+    """Returns the compiler and objdump commands for the ABI or None if there are none."""
+    if abi == "windows":
+        family = "clang" if "clang" in os.path.basename(compiler) else "gcc"
+        return [compiler] + WINDOWS_ABI_FLAGS[family], ["objdump", "-M", "intel"]
+    if abi not in CROSS_TARGET:
+        return [compiler], ["objdump", "-M", "intel"]
+
+    target = CROSS_TARGET[abi]
+    if "clang" in os.path.basename(compiler):
+        command = [compiler, "--target=" + target]
+    elif shutil.which(target + "-" + compiler):
+        command = [target + "-" + compiler]
+    else:
+        return None
+
+    for objdump in (target + "-objdump", "llvm-objdump"):
+        if shutil.which(objdump):
+            return command, [objdump]
+    return None
+
+
+def disassemble(tools, opt, abi, workdir):
+    command, objdump = tools
+    source = os.path.join(workdir, "codegen_%s.cpp" % abi)
+    obj = os.path.join(workdir, "codegen_%s_%s.o" % (abi, opt.lstrip("-")))
+    with open(source, "w") as f:
+        f.write(generate_source(abi))
+
+    subprocess.run(command + ["-std=c++17", opt, "-c", "-I", INCLUDE_DIR, source, "-o", obj]
+                   + ABI_FLAGS[abi], check=True)
+    return subprocess.run(objdump + ["-d", "--no-show-raw-insn", obj],
+                          capture_output=True, text=True, check=True).stdout
+
+
+def measure(disassembly):
+    """Returns {function: (instructions, largest stack adjustment)}."""
+    results = {}
+    function = None
+    for line in disassembly.splitlines():
+        header = re.match(r"^[0-9a-f]+ <(codegen_\w+)>:$", line)
+        if header:
+            function = header.group(1)
+            results[function] = [0, 0]
+            continue
+
+        instruction = re.match(r"^\s+[0-9a-f]+:\s+(\S+)\s*(.*)$", line)
+        if not function or not instruction:
+            if not line.strip():
+                function = None
+            continue
+
+        mnemonic, operands = instruction.groups()
+        # padding between functions is not part of the call site
+        if mnemonic.startswith("nop") or mnemonic == "int3" or operands == "ax,ax":
+            continue
+
+        results[function][0] += 1
+        adjust = re.match(r"^(?:rsp,|sp, sp, #)(0x[0-9a-f]+|\d+)$", operands)
+        if mnemonic == "sub" and adjust:
+            results[function][1] = max(results[function][1], int(adjust.group(1), 0))
+
+    return {name: tuple(value) for name, value in results.items()}
+
+
+def sort_key(name):
+    kind, arity = re.match(r"codegen_(\w+?)_(\d+)$", name).groups()
+    return kind, int(arity)
+
+
+def read_expectations(path):
+    expectations = {}
+    if not os.path.exists(path):
+        return expectations
+
+    with open(path) as f:
+        for line in f:
+            line = line.strip()
+            if not line or line.startswith("#"):
+                continue
+            key, function, instructions, stack = line.rsplit("|", 3)
+            expectations[(key.strip(), function.strip())] = (int(instructions), int(stack))
+    return expectations
+
+
+def write_expectations(path, expectations):
+    with open(path, "w") as f:
+        f.write("# compiler / abi / optimization | call site | instructions | stack adjustment\n")
+        f.write("# generated by tools/codegen_check.py --update\n")
+        for (key, function), (instructions, stack) in sorted(expectations.items()):
+            f.write("%s | %s | %d | %d\n" % (key, function, instructions, stack))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--compiler", action="append",
+                        help="compilers to check (default: every available of clang++ and g++)")
+    parser.add_argument("--opt", action="append",
+                        help="optimization levels, like O2 or --opt=-O3 (default: O2 O3)")
+    parser.add_argument("--abi", action="append", choices=sorted(MAX_ARITY),
+                        help="ABIs to check (default: windows and linux on linux hosts)")
+    group = parser.add_mutually_exclusive_group()
+    group.add_argument("--expect", metavar="FILE",
+                       help="fail if a call site grew, exit with 77 if no compiler has any "
+                            "expectations")
+    group.add_argument("--update", metavar="FILE", help="record the current numbers")
+    args = parser.parse_args()
+
+    compilers = args.compiler or [c for c in ("clang++", "g++") if shutil.which(c)]
+    opts = ["-" + opt.lstrip("-") for opt in args.opt or ["O2", "O3"]]
+    abis = args.abi or (["linux", "windows"] if sys.platform.startswith("linux") else ["windows"])
+
+    expectations = read_expectations(args.expect or args.update or "")
+    recorded = {key.split(" / ")[0] for key, _ in expectations}
+    failures = 0
+    checked = 0
+
+    with tempfile.TemporaryDirectory() as workdir:
+        for compiler in compilers:
+            for abi in abis:
+                tools = abi_tools(compiler, abi)
+                if not tools:
+                    print("%s / %s: no cross compiler or objdump, skipped" % (compiler, abi))
+                    continue
+
+                version = compiler_version(tools[0][0])
+                if args.expect and version not in recorded:
+                    print("%s / %s: no expectations for %s, skipped" % (compiler, abi, version))
+                    continue
+
+                checked += 1
+                for opt in opts:
+                    key = "%s / %s / %s" % (version, abi, opt)
+                    print(key)
+                    results = measure(disassemble(tools, opt, abi, workdir))
+
+                    for function in sorted(results, key=sort_key):
+                        instructions, stack = results[function]
+                        status = ""
+                        expected = expectations.get((key, function))
+                        if args.update:
+                            expectations[(key, function)] = (instructions, stack)
+                        elif args.expect and expected is None:
+                            status = "  MISSING expectation"
+                            failures += 1
+                        elif args.expect and (instructions > expected[0] or stack > expected[1]):
+                            status = "  REGRESSED from %d / %d" % expected
+                            failures += 1
+                        elif args.expect and (instructions, stack) != expected:
+                            status = "  improved from %d / %d" % expected
+
+                        print("  %-16s %4d instructions %5d stack%s"
+                              % (function, instructions, stack, status))
+
+    if args.update:
+        write_expectations(args.update, expectations)
+
+    if failures:
+        print("%d call sites regressed or have no expectation" % failures)
+        return 1
+    # 77 is reported as skipped by CTest
+    if args.expect and not checked:
+        return 77
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,448 @@
+#!/usr/bin/env python3
+#
+# Copyright 2018-2020 Justas Masiulis
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""Generates include/linux_sys.hpp, the typed catalog of x86-64 linux syscalls.
+
+The syscalls and their numbers come from the syscall table of a kernel tree and their
+prototypes from the sys_* declarations of its headers:
+
+  linux_catalog.py --kernel ~/linux
+
+reads arch/x86/entry/syscalls/syscall_64.tbl, include/linux/syscalls.h and
+arch/x86/include/asm/syscalls.h (and syscalls_64.h, where older kernels have some), or
+--table and --prototypes can name the files directly. x32 entries are skipped, as are
+entries without an entry point or a prototype, which are listed at the end of the header.
+
+Many prototypes of syscalls.h leave their parameters unnamed. With --kernel they are
+named after the SYSCALL_DEFINEn definitions of the tree, anything that is still unnamed
+gets a0, a1, ... The header records the kernel version from the Makefile of the tree, or
+the one given with --version.
+
+Kernel types are translated to the userspace types of the same x86-64 ABI, so that the
+catalog takes what the glibc headers declare. See TYPES and STRUCTS.
+"""
+
+import argparse
+import os
+import re
+import sys
+
+OUTPUT = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "include",
+                      "linux_sys.hpp")
+
+PROTOTYPE_FILES = ["include/linux/syscalls.h",
+                   "arch/x86/include/asm/syscalls.h",
+                   "arch/x86/include/asm/syscalls_64.h"]
+
+# kernel typedefs and their userspace equivalents
+TYPES = {
+    "size_t": "std::size_t",
+    "loff_t": "long long",
+    "umode_t": "mode_t",
+    "qid_t": "unsigned int",
+    "key_serial_t": "std::int32_t",
+    "aio_context_t": "unsigned long",
+    "rwf_t": "int",
+    "mqd_t": "int",
+    "timer_t": "int",
+    "__kernel_old_time_t": "time_t",
+    "u32": "std::uint32_t",
+    "__u32": "std::uint32_t",
+    "uint32_t": "std::uint32_t",
+    "u64": "std::uint64_t",
+    "__u64": "std::uint64_t",
+    "__s32": "std::int32_t",
+    "unsigned": "unsigned int",
+    "cap_user_header_t": "struct __user_cap_header_struct*",
+    "cap_user_data_t": "struct __user_cap_data_struct*",
+}
+
+# kernel structs whose userspace counterpart has another name. The kernel struct
+# sigaction doesn't match the one of glibc, so it gets a name nothing else declares.
+STRUCTS = {
+    "__kernel_timespec": "struct timespec",
+    "__kernel_old_timeval": "struct timeval",
+    "__kernel_itimerspec": "struct itimerspec",
+    "__kernel_old_itimerval": "struct itimerval",
+    "__kernel_timex": "struct timex",
+    "user_msghdr": "struct msghdr",
+    "new_utsname": "struct utsname",
+    "sigaltstack": "stack_t",
+    "siginfo": "siginfo_t",
+    "sigaction": "struct kernel_sigaction",
+}
+
+CPP_KEYWORDS = {"new", "delete", "class", "private", "public", "protected", "template",
+                "this", "namespace", "operator", "typename", "using", "virtual"}
+
+LINE_WIDTH = 92
+
+INTEGERS = ("int", "long", "short", "char")
+
+# the arch headers of some kernels declare them without asmlinkage
+PROTOTYPE = re.compile(r"(?:asmlinkage\s+)?\blong\s+sys_(\w+)\s*\(([^;]*?)\)\s*;", re.S)
+
+# SYSCALL_DEFINE3(read, unsigned int, fd, char __user *, buf, size_t, count)
+DEFINITION = re.compile(r"^SYSCALL_DEFINE(\d)\(\s*(\w+)([^)]*)\)", re.M)
+
+# configurations that select other prototypes than the ones of x86-64, like the argument
+# orders of clone. The #ifdef branches of the sources that test them are dropped.
+OTHER_ARCH_CONFIGS = {"CONFIG_CLONE_BACKWARDS", "CONFIG_CLONE_BACKWARDS2",
+                      "CONFIG_CLONE_BACKWARDS3"}
+
+# the directories of a kernel tree whose sources define no x86-64 syscalls
+SKIPPED_DIRS = {"Documentation", "drivers", "sound", "samples", "scripts", "tools", "usr"}
+
+
+HEADER = """/*
+ * Copyright 2018-2020 Justas Masiulis
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Generated by tools/linux_catalog.py from the x86-64 syscall table and the sys_*
+// prototypes of linux %(version)s. Do not edit, rerun it against a newer kernel instead.
+
+#ifndef JM_INLINE_SYSCALL_LINUX_SYS_HPP
+#define JM_INLINE_SYSCALL_LINUX_SYS_HPP
+
+#include "inline_syscall.hpp"
+#include <csignal>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <sys/select.h>
+#include <sys/types.h>
+
+#if !defined(__linux__) || !defined(__x86_64__)
+#error "linux_sys.hpp is only available on x86-64 linux"
+#endif
+
+#if defined(JM_INLINE_SYSCALL_INSTRUMENTED)
+#define JM_INLINE_SYSCALL_SYS_ARGS(name) \\
+    ::jm::sys::nr::name, ::jm::detail::syscall_site_of<::jm::hash(#name)>()
+#else
+#define JM_INLINE_SYSCALL_SYS_ARGS(name) ::jm::sys::nr::name
+#endif
+
+// defines jm::sys::name, which makes the syscall with its number as an immediate. The
+// call is routed like INLINE_SYSCALL, so it goes through the vDSO where there is one and
+// otherwise through the memory effects, statistics and tracing.
+#define JM_INLINE_SYSCALL_SYS(name, params, args)                 \\
+    JM_INLINE_SYSCALL_FORCEINLINE long name params noexcept       \\
+    {                                                             \\
+        using function = ::jm::syscall_function<long params>;     \\
+        return ::jm::detail::route_syscall<::jm::hash(#name)>(    \\
+            function{ JM_INLINE_SYSCALL_SYS_ARGS(name) }) args;   \\
+    }
+
+// the structs that the kernel reads and writes. Some of them have no userspace header
+// and have to be defined by the caller, like struct linux_dirent64 and the kernel's
+// struct sigaction, here named struct kernel_sigaction.
+%(forward)s
+
+namespace jm {
+
+    /// \\brief The %(count)d syscalls of x86-64 linux with the argument types of the
+    ///        kernel. jm::sys::read(fd, buffer, size) compiles to an inlined syscall with
+    ///        the number as an immediate and returns the raw result or -errno.
+    namespace sys {
+
+        // the number of every syscall
+        namespace nr {
+%(numbers)s
+        } // namespace nr
+
+%(functions)s
+
+    } // namespace sys
+
+} // namespace jm
+
+#undef JM_INLINE_SYSCALL_SYS
+#undef JM_INLINE_SYSCALL_SYS_ARGS
+
+// entries of the syscall table without an entry point or a prototype:
+%(skipped)s
+
+#endif // JM_INLINE_SYSCALL_LINUX_SYS_HPP
+"""
+
+
+def read_table(path):
+    """Returns (number, name, entry point) of every 64-bit syscall of syscall_64.tbl."""
+    syscalls = []
+    with open(path) as table:
+        for line in table:
+            fields = line.split("#", 1)[0].split()
+            if len(fields) < 3 or fields[1] not in ("common", "64"):
+                continue
+            entry = fields[3] if len(fields) > 3 else None
+            if entry:
+                entry = re.sub(r"^__x64_", "", entry)
+            syscalls.append((int(fields[0]), fields[2], entry))
+    return syscalls
+
+
+def x86_64_source(text):
+    """Drops the conditional branches that only other architectures compile. All other
+    conditionals are kept whole."""
+    lines = []
+    # [dropped, taken] of every conditional that tests OTHER_ARCH_CONFIGS, else None
+    stack = []
+    for line in text.splitlines():
+        directive = re.match(r"\s*#\s*(ifdef|ifndef|if|elif|else|endif)\b(.*)", line)
+        if not directive:
+            if not any(state and state[0] for state in stack):
+                lines.append(line)
+            continue
+
+        kind, condition = directive.groups()
+        other = re.sub(r"^defined\s*\(?\s*(\w+)\s*\)?$", r"\1", condition.strip()) in \
+            OTHER_ARCH_CONFIGS
+        if kind in ("ifdef", "if"):
+            stack.append([True, False] if other else None)
+        elif kind == "ifndef":
+            stack.append([False, True] if other else None)
+        elif not stack:
+            continue
+        elif kind == "endif":
+            stack.pop()
+        elif stack[-1] is None:
+            continue
+        elif kind == "elif":
+            stack[-1][0] = stack[-1][1] or other
+            stack[-1][1] = stack[-1][1] or not other
+        else:
+            stack[-1] = [stack[-1][1], True]
+    return "\n".join(lines)
+
+
+def read_prototypes(paths):
+    """Returns the parameter lists of sys_* declarations keyed by the entry point."""
+    prototypes = {}
+    for path in paths:
+        with open(path) as header:
+            source = x86_64_source(re.sub(r"/\*.*?\*/", "", header.read(), flags=re.S))
+        for name, params in PROTOTYPE.findall(source):
+            prototypes.setdefault("sys_" + name, " ".join(params.split()))
+    return prototypes
+
+
+def read_definitions(kernel):
+    """Returns the parameter names of the SYSCALL_DEFINEn definitions keyed by the entry
+    point. Only the x86 definitions are read out of arch/."""
+    definitions = {}
+    for root, dirs, files in os.walk(kernel):
+        relative = os.path.relpath(root, kernel)
+        if relative == ".":
+            dirs[:] = [d for d in dirs if d not in SKIPPED_DIRS and not d.startswith(".")]
+        elif relative == "arch":
+            dirs[:] = [d for d in dirs if d == "x86"]
+
+        for file in files:
+            if not file.endswith(".c"):
+                continue
+            with open(os.path.join(root, file), errors="replace") as source:
+                text = source.read()
+            if "SYSCALL_DEFINE" not in text:
+                continue
+
+            for count, name, params in DEFINITION.findall(x86_64_source(text)):
+                fields = [field.strip() for field in params.split(",")[1:]]
+                if len(fields) != 2 * int(count):
+                    continue
+                definitions.setdefault("sys_" + name, fields[1::2])
+    return definitions
+
+
+def kernel_version(kernel):
+    """Returns the version of the kernel tree, like 6.1.0 or 6.2.0-rc3."""
+    makefile = os.path.join(kernel, "Makefile")
+    if not os.path.exists(makefile):
+        return None
+
+    with open(makefile) as f:
+        fields = dict(re.findall(r"^(VERSION|PATCHLEVEL|SUBLEVEL|EXTRAVERSION) =[ \t]*(\S*)",
+                                 f.read(), re.M))
+    return "%s.%s.%s%s" % (fields.get("VERSION", "?"), fields.get("PATCHLEVEL", "?"),
+                           fields.get("SUBLEVEL", "0") or "0", fields.get("EXTRAVERSION", ""))
+
+
+def translate_type(kernel_type):
+    """Translates a kernel parameter type to its userspace spelling."""
+    words = kernel_type.replace("*", " * ").split()
+    words = [word for word in words if word != "__user"]
+
+    translated = []
+    i = 0
+    while i < len(words):
+        word = words[i]
+        if word in ("struct", "union") and i + 1 < len(words):
+            tag = words[i + 1]
+            translated.append(STRUCTS.get(tag, word + " " + tag))
+            i += 2
+            continue
+        if word == "enum" and i + 1 < len(words):
+            translated.append("int")
+            i += 2
+            continue
+        # a bare unsigned is unsigned int, unsigned long is left alone
+        if word == "unsigned" and i + 1 < len(words) and words[i + 1] in INTEGERS:
+            translated.append(word)
+        else:
+            translated.append(TYPES.get(word, word))
+        i += 1
+
+    return re.sub(r"\s+\*", "*", " ".join(translated))
+
+
+def split_params(params, syscall, defined_names):
+    """Returns (type, name) of every parameter of a kernel prototype. Unnamed parameters
+    take the names of the definition, if it has as many parameters."""
+    if params.strip() in ("", "void"):
+        return []
+
+    params = params.split(",")
+    if defined_names and len(defined_names) != len(params):
+        defined_names = None
+
+    result = []
+    for index, param in enumerate(params):
+        param = param.strip()
+        match = re.match(r"^(.*?[\s*])(\w+)$", param)
+        # unnamed parameters are types only, which end in a type name or a star
+        words = param.replace("*", " ").split()
+        unnamed = (not match or param.endswith("*") or len(words) == 1 or
+                   words[-1] in TYPES or words[-2] in ("struct", "union", "enum") or
+                   words[-1] in INTEGERS or words[-1] == "unsigned")
+        if unnamed:
+            kernel_type = param
+            name = defined_names[index] if defined_names else "a%d" % index
+        else:
+            kernel_type, name = match.group(1), match.group(2)
+        if name in CPP_KEYWORDS or name == syscall:
+            name += "_"
+        result.append((translate_type(kernel_type), name))
+    return result
+
+
+def tags_of(params):
+    """Returns the struct and union tags used by the parameters."""
+    tags = set()
+    for param_type, _ in params:
+        for key, tag in re.findall(r"\b(struct|union)\s+(\w+)", param_type):
+            tags.add((key, tag))
+    return tags
+
+
+def wrap(text, indent, suffix):
+    """Breaks a parenthesized list after commas so that its lines fit LINE_WIDTH."""
+    lines = [indent]
+    for item in text.split(", "):
+        candidate = lines[-1] + ("" if lines[-1] == indent else " ") + item + ","
+        if lines[-1] != indent and len(candidate) + len(suffix) > LINE_WIDTH + 1:
+            lines.append(indent + " " + item + ",")
+        else:
+            lines[-1] = candidate
+    return "\n".join(lines)[:-1]
+
+
+def generate(syscalls, prototypes, definitions, version):
+    catalog, skipped, tags = [], [], set()
+    for number, name, entry in syscalls:
+        params = prototypes.get(entry) if entry else None
+        if params is None:
+            skipped.append((number, name))
+            continue
+        params = split_params(params, name, definitions.get(entry))
+        tags |= tags_of(params)
+        catalog.append((number, name, params))
+
+    width = max(len(name) for _, name, _ in catalog)
+    numbers = ["            inline constexpr std::uint32_t %s = %d;"
+               % (name.ljust(width), number) for number, name, _ in catalog]
+
+    functions = []
+    for _, name, params in catalog:
+        declaration = "(%s)" % ", ".join("%s %s" % param for param in params)
+        arguments = "(%s)" % ", ".join(param_name for _, param_name in params)
+        line = "        JM_INLINE_SYSCALL_SYS(%s, %s, %s)" % (name, declaration, arguments)
+        if len(line) > LINE_WIDTH:
+            indent = " " * len("        JM_INLINE_SYSCALL_SYS(")
+            line = "        JM_INLINE_SYSCALL_SYS(%s,\n%s,\n%s%s)" % (
+                name, wrap(declaration, indent, ","), indent, arguments)
+        functions.append(line)
+
+    return HEADER % {
+        "version": version,
+        "count": len(catalog),
+        "forward": "\n".join("%s %s;" % tag for tag in sorted(tags)),
+        "numbers": "\n".join(numbers),
+        "functions": "\n".join(functions),
+        "skipped": "\n".join("// %3d %s" % entry for entry in skipped),
+    }
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--kernel", metavar="DIR", help="kernel source tree")
+    parser.add_argument("--table", metavar="FILE", help="syscall_64.tbl")
+    parser.add_argument("--prototypes", metavar="FILE", action="append",
+                        help="header with sys_* prototypes, can be repeated")
+    parser.add_argument("--version", default="", help="kernel version noted in the header")
+    parser.add_argument("--output", default=OUTPUT,
+                        help="defaults to include/linux_sys.hpp")
+    args = parser.parse_args()
+
+    table = args.table
+    prototype_files = args.prototypes or []
+    version = args.version
+    definitions = {}
+    if args.kernel:
+        table = table or os.path.join(args.kernel, "arch/x86/entry/syscalls/syscall_64.tbl")
+        if not prototype_files:
+            prototype_files = [os.path.join(args.kernel, path) for path in PROTOTYPE_FILES]
+            prototype_files = [path for path in prototype_files if os.path.exists(path)]
+        version = version or kernel_version(args.kernel)
+        definitions = read_definitions(args.kernel)
+
+    if not table or not prototype_files:
+        parser.error("either --kernel or both --table and --prototypes are needed")
+
+    syscalls = read_table(table)
+    prototypes = read_prototypes(prototype_files)
+    header = generate(syscalls, prototypes, definitions, version or "unknown")
+    with open(args.output, "w") as output:
+        output.write(header)
+
+    count = header.count("inline constexpr")
+    print("%s: %d syscalls" % (os.path.normpath(args.output), count))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,586 @@
+/*
+ * Copyright 2018-2020 Justas Masiulis
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* Extracts the syscall ids of every x64 ntdll.dll build in a directory tree into a
+ * single table, using the same export parsing as init_syscalls_list.
+ *
+ * Build:
+ *   g++ -std=c++17 -O2 -pthread -I../include ntdll_extract.cpp -o ntdll_extract
+ *
+ * Usage:
+ *   ntdll_extract --out TABLE [--header FILE] [--jobs N] DIRECTORY...
+ *
+ * Every regular file under the directories is mapped and parsed. Files that are not
+ * x64 PE images with Zw* syscall stubs are remembered as such and skipped. Builds are
+ * identified like snapshots are, by the TimeDateStamp, CheckSum and SizeOfImage of the
+ * image, and builds with identical ids share a single row of the table.
+ *
+ * TABLE also records the size and modification time of every file it was built from.
+ * If it already exists, files that didn't change since are taken from it instead of
+ * being parsed again, so updating the table after adding builds only parses the new ones.
+ *
+ * --header additionally writes the table as a C++ header that can be compiled in.
+ */
+
+#include "file_init.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <map>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace {
+
+    namespace fs = std::filesystem;
+
+    /* table file layout:
+     *
+     * table_header
+     * std::uint32_t names[header.names]          - offsets of sorted Nt* names in strings
+     * std::uint16_t ids[header.sets][header.names] - unknown_id if the build doesn't have it
+     * table_image   images[header.images]        - sorted by identity
+     * table_file    files[header.files]
+     * char          strings[header.strings]
+     */
+    struct table_header {
+        std::uint32_t magic;
+        std::uint32_t version;
+        std::uint32_t names;
+        std::uint32_t sets;
+        std::uint32_t images;
+        std::uint32_t files;
+        std::uint32_t strings;
+    };
+
+    struct table_image {
+        std::uint32_t time_date_stamp;
+        std::uint32_t check_sum;
+        std::uint32_t size_of_image;
+        std::uint32_t set;
+    };
+
+    struct table_file {
+        std::uint64_t size;
+        std::int64_t  modified;
+        std::uint32_t path;
+
+        // index into images or no_image if the file is not an ntdll build
+        std::uint32_t image;
+    };
+
+    constexpr std::uint32_t table_magic   = 0x544E594A; // "JYNT"
+    constexpr std::uint32_t table_version = 1;
+    constexpr std::uint16_t unknown_id    = 0xFFFF;
+    constexpr std::uint32_t no_image      = 0xFFFFFFFF;
+
+    struct image_syscalls {
+        std::uint32_t time_date_stamp = 0;
+        std::uint32_t check_sum       = 0;
+        std::uint32_t size_of_image   = 0;
+
+        // Nt* names and ids sorted by name
+        std::vector<std::pair<std::string, std::uint16_t>> syscalls;
+
+        bool identity_less(const image_syscalls& other) const noexcept
+        {
+            return std::tie(time_date_stamp, check_sum, size_of_image) <
+                   std::tie(other.time_date_stamp, other.check_sum, other.size_of_image);
+        }
+    };
+
+    struct file_result {
+        std::string   path;
+        std::uint64_t size     = 0;
+        std::int64_t  modified = 0;
+
+        // empty if the file is not an ntdll build
+        std::vector<image_syscalls> image;
+    };
+
+    // reads the ids of the Zw* stubs, which all start with mov r10, rcx; mov eax, id
+    bool extract(const char* path, image_syscalls& result)
+    {
+        const jm::detail::mapped_file file(path);
+        if(!file.data())
+            return false;
+
+        const jm::detail::exports_directory exports(
+            file.data(), file.size(), jm::image_layout::file);
+        const auto nt = exports.headers();
+        if(exports.size() == 0 || nt->FileHeader.Machine != 0x8664 /* AMD64 */)
+            return false;
+
+        result.time_date_stamp = nt->FileHeader.TimeDateStamp;
+        result.check_sum       = nt->OptionalHeader.CheckSum;
+        result.size_of_image   = nt->OptionalHeader.SizeOfImage;
+
+        const auto last = jm::detail::lower_bound(exports, "Zx");
+        for(auto i = jm::detail::lower_bound(exports, "Zw"); i < last; ++i) {
+            const auto name    = exports.name(i);
+            const auto address = exports.address(i);
+            if(!name || !address || !exports.contains(address, 8))
+                continue;
+
+            const auto code = reinterpret_cast<const unsigned char*>(address);
+            if(code[0] != 0x4C || code[1] != 0x8B || code[2] != 0xD1 || code[3] != 0xB8)
+                continue;
+
+            std::uint32_t id;
+            std::memcpy(&id, code + 4, sizeof(id));
+            if(id >= unknown_id)
+                continue;
+
+            result.syscalls.emplace_back(std::string("Nt") + (name + 2),
+                                         static_cast<std::uint16_t>(id));
+        }
+
+        // Zw* exports are sorted and so are their Nt* names
+        return !result.syscalls.empty();
+    }
+
+    // the previous table, used to skip files that didn't change
+    class previous_table {
+        std::vector<char> _data;
+        table_header      _header{};
+
+        template<class T>
+        const T* at(std::size_t offset) const noexcept
+        {
+            return reinterpret_cast<const T*>(_data.data() + offset);
+        }
+
+        std::size_t ids_offset() const noexcept
+        {
+            return sizeof(table_header) + _header.names * sizeof(std::uint32_t);
+        }
+
+        std::size_t images_offset() const noexcept
+        {
+            return ids_offset() +
+                   std::size_t{ _header.sets } * _header.names * sizeof(std::uint16_t);
+        }
+
+        std::size_t files_offset() const noexcept
+        {
+            return images_offset() + _header.images * sizeof(table_image);
+        }
+
+        std::size_t strings_offset() const noexcept
+        {
+            return files_offset() + _header.files * sizeof(table_file);
+        }
+
+        const char* string(std::uint32_t offset) const noexcept
+        {
+            return offset < _header.strings ? at<char>(strings_offset() + offset) : "";
+        }
+
+    public:
+        explicit previous_table(const char* path)
+        {
+            const jm::detail::mapped_file file(path);
+            if(!file.data() || file.size() < sizeof(table_header))
+                return;
+
+            std::memcpy(&_header, file.data(), sizeof(_header));
+            if(_header.magic != table_magic || _header.version != table_version)
+                return;
+
+            _data.assign(file.data(), file.data() + file.size());
+            if(strings_offset() + _header.strings != _data.size() ||
+               (_header.strings != 0 && _data.back() != '\0'))
+                _data.clear();
+        }
+
+        /// \brief Fills in the result of the file from the table if it didn't change.
+        bool lookup(file_result& result) const
+        {
+            if(_data.empty())
+                return false;
+
+            // files are sorted by path
+            const auto files = at<table_file>(files_offset());
+            const auto file  = std::lower_bound(
+                files,
+                files + _header.files,
+                result.path,
+                [&](const table_file& entry, const std::string& path) {
+                    return std::strcmp(string(entry.path), path.c_str()) < 0;
+                });
+            if(file == files + _header.files || result.path != string(file->path) ||
+               file->size != result.size || file->modified != result.modified)
+                return false;
+
+            if(file->image == no_image)
+                return true;
+            if(file->image >= _header.images)
+                return false;
+
+            const auto& image = at<table_image>(images_offset())[file->image];
+            if(image.set >= _header.sets)
+                return false;
+
+            image_syscalls syscalls;
+            syscalls.time_date_stamp = image.time_date_stamp;
+            syscalls.check_sum       = image.check_sum;
+            syscalls.size_of_image   = image.size_of_image;
+
+            const auto names = at<std::uint32_t>(sizeof(table_header));
+            const auto ids =
+                at<std::uint16_t>(ids_offset()) + std::size_t{ image.set } * _header.names;
+            for(std::uint32_t i = 0; i < _header.names; ++i)
+                if(ids[i] != unknown_id)
+                    syscalls.syscalls.emplace_back(string(names[i]), ids[i]);
+
+            result.image.push_back(std::move(syscalls));
+            return true;
+        }
+    };
+
+    struct table {
+        std::vector<std::string>                names;
+        std::vector<std::vector<std::uint16_t>> sets;
+        std::vector<table_image>                images;
+        std::vector<table_file>                 files;
+        std::string                             strings;
+
+        std::uint32_t add_string(const std::string& str)
+        {
+            const auto offset = static_cast<std::uint32_t>(strings.size());
+            strings.append(str.c_str(), str.size() + 1);
+            return offset;
+        }
+    };
+
+    // deduplicates the builds and the rows of ids. results have to be sorted by path.
+    table build_table(const std::vector<file_result>& results)
+    {
+        table result;
+
+        std::vector<const image_syscalls*> images;
+        for(const auto& file : results)
+            if(!file.image.empty())
+                images.push_back(&file.image.front());
+
+        std::stable_sort(images.begin(), images.end(), [](auto lhs, auto rhs) {
+            return lhs->identity_less(*rhs);
+        });
+
+        // copies of a build share its image. A build that differs from another with the
+        // same identity can only be a damaged file, so the first one wins.
+        std::vector<const image_syscalls*> unique;
+        for(auto image : images)
+            if(unique.empty() || unique.back()->identity_less(*image))
+                unique.push_back(image);
+
+        for(auto image : unique)
+            for(const auto& syscall : image->syscalls)
+                result.names.push_back(syscall.first);
+        std::sort(result.names.begin(), result.names.end());
+        result.names.erase(std::unique(result.names.begin(), result.names.end()),
+                           result.names.end());
+
+        std::map<std::vector<std::uint16_t>, std::uint32_t> set_indices;
+        for(auto image : unique) {
+            std::vector<std::uint16_t> ids(result.names.size(), unknown_id);
+            auto                       name = result.names.begin();
+            for(const auto& syscall : image->syscalls) {
+                name = std::lower_bound(name, result.names.end(), syscall.first);
+                ids[static_cast<std::size_t>(name - result.names.begin())] = syscall.second;
+            }
+
+            const auto set = set_indices.emplace(
+                std::move(ids), static_cast<std::uint32_t>(set_indices.size()));
+            if(set.second)
+                result.sets.push_back(set.first->first);
+
+            result.images.push_back({ image->time_date_stamp,
+                                      image->check_sum,
+                                      image->size_of_image,
+                                      set.first->second });
+        }
+
+        for(const auto& file : results) {
+            std::uint32_t image = no_image;
+            if(!file.image.empty()) {
+                const auto found = std::lower_bound(
+                    unique.begin(), unique.end(), &file.image.front(), [](auto lhs, auto rhs) {
+                        return lhs->identity_less(*rhs);
+                    });
+                image = static_cast<std::uint32_t>(found - unique.begin());
+            }
+            result.files.push_back({ file.size, file.modified, 0, image });
+        }
+
+        // names come first in the strings so that their offsets are known up front
+        for(std::size_t i = 0; i < result.names.size(); ++i)
+            result.add_string(result.names[i]);
+        for(std::size_t i = 0; i < results.size(); ++i)
+            result.files[i].path = result.add_string(results[i].path);
+
+        return result;
+    }
+
+    bool write_table(const char* path, const table& t)
+    {
+        const std::string temp_path = std::string(path) + ".tmp";
+        const auto        file      = std::fopen(temp_path.c_str(), "wb");
+        if(!file)
+            return false;
+
+        const table_header header{ table_magic,
+                                   table_version,
+                                   static_cast<std::uint32_t>(t.names.size()),
+                                   static_cast<std::uint32_t>(t.sets.size()),
+                                   static_cast<std::uint32_t>(t.images.size()),
+                                   static_cast<std::uint32_t>(t.files.size()),
+                                   static_cast<std::uint32_t>(t.strings.size()) };
+        bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1;
+
+        std::uint32_t offset = 0;
+        for(const auto& name : t.names) {
+            ok     = ok && std::fwrite(&offset, sizeof(offset), 1, file) == 1;
+            offset = static_cast<std::uint32_t>(offset + name.size() + 1);
+        }
+        for(const auto& set : t.sets)
+            ok = ok && std::fwrite(set.data(), sizeof(set[0]), set.size(), file) == set.size();
+        ok = ok && std::fwrite(t.images.data(), sizeof(table_image), t.images.size(), file) ==
+                       t.images.size();
+        ok = ok && std::fwrite(t.files.data(), sizeof(table_file), t.files.size(), file) ==
+                       t.files.size();
+        ok = ok && std::fwrite(t.strings.data(), 1, t.strings.size(), file) == t.strings.size();
+
+        if(std::fclose(file) != 0 || !ok || std::rename(temp_path.c_str(), path) != 0) {
+            std::remove(temp_path.c_str());
+            return false;
+        }
+        return true;
+    }
+
+    bool write_header(const char* path, const table& t)
+    {
+        const auto file = std::fopen(path, "w");
+        if(!file)
+            return false;
+
+        std::fprintf(file,
+                     "// Generated by tools/ntdll_extract from %zu ntdll builds. Do not edit.\n\n"
+                     "#ifndef JM_INLINE_SYSCALL_NTDLL_TABLE_HPP\n"
+                     "#define JM_INLINE_SYSCALL_NTDLL_TABLE_HPP\n\n"
+                     "#include <cstdint>\n\n"
+                     "namespace jm {\n\n"
+                     "    namespace ntdll_table {\n\n"
+                     "        inline constexpr std::uint32_t version = %u;\n\n"
+                     "        // ids of syscalls that a build doesn't have\n"
+                     "        inline constexpr std::uint16_t unknown = 0x%X;\n\n"
+                     "        inline constexpr std::size_t name_count = %zu;\n\n",
+                     t.images.size(),
+                     table_version,
+                     unknown_id,
+                     t.names.size());
+
+        std::fprintf(file, "        // sorted Nt* names\n");
+        std::fprintf(file, "        inline constexpr const char* names[name_count] = {\n");
+        for(const auto& name : t.names)
+            std::fprintf(file, "            \"%s\",\n", name.c_str());
+        std::fprintf(file, "        };\n\n");
+
+        std::fprintf(file, "        // jm::hash of the names\n");
+        std::fprintf(file, "        inline constexpr std::uint32_t hashes[name_count] = {\n");
+        for(const auto& name : t.names)
+            std::fprintf(file, "            0x%08X,\n", jm::hash(name.c_str()));
+        std::fprintf(file, "        };\n\n");
+
+        std::fprintf(file, "        // ids[set][i] is the id of names[i] in the builds with the set\n");
+        std::fprintf(file, "        inline constexpr std::uint16_t ids[][name_count] = {\n");
+        for(const auto& set : t.sets) {
+            std::fprintf(file, "            {");
+            for(std::size_t i = 0; i < set.size(); ++i)
+                std::fprintf(file, "%s0x%X,", i % 12 == 0 ? "\n                " : " ", set[i]);
+            std::fprintf(file, "\n            },\n");
+        }
+        std::fprintf(file, "        };\n\n");
+
+        std::fprintf(file,
+                     "        struct image {\n"
+                     "            std::uint32_t time_date_stamp;\n"
+                     "            std::uint32_t check_sum;\n"
+                     "            std::uint32_t size_of_image;\n"
+                     "            std::uint32_t set;\n"
+                     "        };\n\n"
+                     "        // sorted by time_date_stamp, check_sum and size_of_image\n"
+                     "        inline constexpr image images[] = {\n");
+        for(const auto& image : t.images)
+            std::fprintf(file,
+                         "            { 0x%08X, 0x%08X, 0x%08X, %u },\n",
+                         image.time_date_stamp,
+                         image.check_sum,
+                         image.size_of_image,
+                         image.set);
+        std::fprintf(file, "        };\n\n");
+
+        std::fprintf(
+            file,
+            "        /// \\brief Returns the build with the given identity or nullptr.\n"
+            "        inline constexpr const image* find_image(std::uint32_t time_date_stamp,\n"
+            "                                                 std::uint32_t check_sum,\n"
+            "                                                 std::uint32_t size_of_image) noexcept\n"
+            "        {\n"
+            "            for(const auto& entry : images)\n"
+            "                if(entry.time_date_stamp == time_date_stamp &&\n"
+            "                   entry.check_sum == check_sum && entry.size_of_image == size_of_image)\n"
+            "                    return &entry;\n\n"
+            "            return nullptr;\n"
+            "        }\n\n"
+            "        /// \\brief Returns the id of syscall with the given name hash in the build or\n"
+            "        ///        unknown if it doesn't have it.\n"
+            "        inline constexpr std::uint16_t find_id(const image& build,\n"
+            "                                               std::uint32_t hash) noexcept\n"
+            "        {\n"
+            "            for(std::size_t i = 0; i < name_count; ++i)\n"
+            "                if(hashes[i] == hash)\n"
+            "                    return ids[build.set][i];\n\n"
+            "            return unknown;\n"
+            "        }\n\n"
+            "    } // namespace ntdll_table\n\n"
+            "} // namespace jm\n\n"
+            "#endif // JM_INLINE_SYSCALL_NTDLL_TABLE_HPP\n");
+
+        return std::fclose(file) == 0;
+    }
+
+    std::vector<file_result> find_files(const std::vector<const char*>& directories)
+    {
+        std::vector<file_result> files;
+        for(const auto directory : directories) {
+            std::error_code error;
+            for(fs::recursive_directory_iterator it(
+                    directory, fs::directory_options::skip_permission_denied, error),
+                end;
+                !error && it != end;
+                it.increment(error)) {
+                std::error_code file_error;
+                if(!it->is_regular_file(file_error))
+                    continue;
+
+                file_result file;
+                file.path = fs::absolute(it->path(), file_error).lexically_normal().string();
+                file.size     = it->file_size(file_error);
+                file.modified = it->last_write_time(file_error).time_since_epoch().count();
+                if(!file_error)
+                    files.push_back(std::move(file));
+            }
+            if(error)
+                std::fprintf(stderr, "%s: %s\n", directory, error.message().c_str());
+        }
+
+        std::sort(files.begin(), files.end(), [](const auto& lhs, const auto& rhs) {
+            return lhs.path < rhs.path;
+        });
+        const auto same_path = [](const auto& lhs, const auto& rhs) {
+            return lhs.path == rhs.path;
+        };
+        files.erase(std::unique(files.begin(), files.end(), same_path), files.end());
+        return files;
+    }
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const char*              out    = nullptr;
+    const char*              header = nullptr;
+    std::size_t              jobs   = std::thread::hardware_concurrency();
+    std::vector<const char*> directories;
+
+    for(int i = 1; i < argc; ++i) {
+        if(!std::strcmp(argv[i], "--out") && i + 1 < argc)
+            out = argv[++i];
+        else if(!std::strcmp(argv[i], "--header") && i + 1 < argc)
+            header = argv[++i];
+        else if(!std::strcmp(argv[i], "--jobs") && i + 1 < argc)
+            jobs = std::strtoull(argv[++i], nullptr, 10);
+        else if(argv[i][0] != '-')
+            directories.push_back(argv[i]);
+        else {
+            directories.clear();
+            break;
+        }
+    }
+
+    if(!out || directories.empty()) {
+        std::fprintf(stderr,
+                     "usage: %s --out TABLE [--header FILE] [--jobs N] DIRECTORY...\n",
+                     argv[0]);
+        return 1;
+    }
+
+    if(jobs == 0)
+        jobs = 1;
+
+    auto files = find_files(directories);
+
+    const previous_table previous(out);
+    std::vector<std::size_t> pending;
+    for(std::size_t i = 0; i < files.size(); ++i)
+        if(!previous.lookup(files[i]))
+            pending.push_back(i);
+
+    std::atomic<std::size_t> next{ 0 };
+    std::vector<std::thread> workers;
+    for(std::size_t t = 0; t < std::min(jobs, pending.size()); ++t)
+        workers.emplace_back([&] {
+            for(auto i = next.fetch_add(1); i < pending.size(); i = next.fetch_add(1)) {
+                auto&          file = files[pending[i]];
+                image_syscalls image;
+                if(extract(file.path.c_str(), image))
+                    file.image.push_back(std::move(image));
+            }
+        });
+    for(auto& worker : workers)
+        worker.join();
+
+    const auto t = build_table(files);
+    if(!write_table(out, t)) {
+        std::fprintf(stderr, "failed to write %s\n", out);
+        return 1;
+    }
+
+    if(header && t.images.empty()) {
+        std::fprintf(stderr, "no ntdll builds found, %s was not written\n", header);
+        return 1;
+    }
+
+    if(header && !write_header(header, t)) {
+        std::fprintf(stderr, "failed to write %s\n", header);
+        return 1;
+    }
+
+    std::printf("%zu files, %zu parsed, %zu builds, %zu distinct id sets, %zu syscalls\n",
+                files.size(),
+                pending.size(),
+                t.images.size(),
+                t.sets.size(),
+                t.names.size());
+}
@@ -0,0 +1,130 @@
+#!/usr/bin/env python3
+#
+# Copyright 2018-2020 Justas Masiulis
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""Prints the syscalls recorded by jm::syscall_trace_writer as a timeline.
+
+  trace_timeline.py TRACE                  every syscall of every thread ordered by start
+  trace_timeline.py TRACE --thread 3       only the syscalls of the given thread
+  trace_timeline.py TRACE --names FILE     also resolve the names listed in FILE
+
+Times are in timestamp counter cycles relative to the first recorded syscall.
+Records only store the hash of the syscall name. Every linux syscall known to the
+library is resolved by default, other names (like windows Nt* functions) can be given
+one per line with --names.
+"""
+
+import argparse
+import os
+import re
+import struct
+import sys
+
+INCLUDE_DIR = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "include")
+
+FILE_HEADER = struct.Struct("<IIII")
+BLOCK_HEADER = struct.Struct("<IIQ")
+FILE_MAGIC = 0x5254594A
+FILE_VERSION = 1
+
+
+def name_hash(name):
+    """Same as jm::hash."""
+    if name[:2] in ("Nt", "Zw"):
+        name = name[2:]
+
+    value = 2166136261
+    for c in name.encode():
+        value = ((value ^ c) * 16777619) & 0xFFFFFFFF
+    return value
+
+
+def known_names(names_file):
+    names = []
+    with open(os.path.join(INCLUDE_DIR, "linux_syscalls.inl")) as f:
+        names += re.findall(r"JM_INLINE_SYSCALL_LINUX_SYSCALL\((\w+)\)", f.read())
+
+    if names_file:
+        with open(names_file) as f:
+            names += [line.strip() for line in f if line.strip()]
+
+    return {name_hash(name): name for name in names}
+
+
+def read_trace(path):
+    """Returns ([(thread, record)], {thread: lost records})."""
+    with open(path, "rb") as f:
+        data = f.read()
+
+    magic, version, record_size, args = FILE_HEADER.unpack_from(data, 0)
+    if magic != FILE_MAGIC or version != FILE_VERSION:
+        raise ValueError("%s is not a syscall trace" % path)
+
+    # hash, id, args[args], status, start, end
+    record = struct.Struct("<II%dQqQQ" % args)
+    if record.size != record_size:
+        raise ValueError("unexpected record size %d" % record_size)
+
+    records = []
+    lost = {}
+    offset = FILE_HEADER.size
+    while offset + BLOCK_HEADER.size <= len(data):
+        thread, count, block_lost = BLOCK_HEADER.unpack_from(data, offset)
+        offset += BLOCK_HEADER.size
+        lost[thread] = lost.get(thread, 0) + block_lost
+        for _ in range(count):
+            if offset + record_size > len(data):
+                break
+            fields = record.unpack_from(data, offset)
+            offset += record_size
+            records.append((thread, fields))
+
+    return records, lost
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("trace", help="file written by jm::syscall_trace_writer")
+    parser.add_argument("--names", metavar="FILE", help="additional syscall names")
+    parser.add_argument("--thread", type=int, action="append", help="threads to show")
+    args = parser.parse_args()
+
+    names = known_names(args.names)
+    records, lost = read_trace(args.trace)
+    if args.thread:
+        records = [r for r in records if r[0] in args.thread]
+
+    records.sort(key=lambda r: r[1][-2])
+    origin = records[0][1][-2] if records else 0
+
+    print("%14s %10s %6s  %-24s %6s %20s  %s" % ("start", "cycles", "thread", "syscall", "id",
+                                                "status", "arguments"))
+    for thread, fields in records:
+        hash_, id_ = fields[0], fields[1]
+        call_args, (status, start, end) = fields[2:-3], fields[-3:]
+        name = names.get(hash_, "%08x" % hash_)
+        print("%14d %10d %6d  %-24s %6d %20d  %s" % (
+            start - origin, end - start, thread, name, id_, status,
+            " ".join("%x" % arg for arg in call_args)))
+
+    for thread in sorted(lost):
+        if lost[thread] and (not args.thread or thread in args.thread):
+            print("thread %d lost %d records" % (thread, lost[thread]), file=sys.stderr)
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())